@@ -35,10 +35,13 @@ hio_return_t hio_dataset_alloc (hio_context_t context, hio_dataset_t *set_out, c
 
 
 hio_return_t hio_dataset_free (hio_dataset_t *dataset) {
-  if (NULL == dataset) {
+  if (NULL == dataset || HIO_OBJECT_NULL == *dataset) {
     return HIO_ERR_BAD_PARAM;
   }
 
+  /* the dataset may still be in use by a background close */
+  hioi_context_wait_pending (hioi_object_context (&(*dataset)->ds_object));
+
   hioi_object_release (&(*dataset)->ds_object);
   *dataset = HIO_OBJECT_NULL;
 
@@ -11,16 +11,19 @@
 
 #include "hio_internal.h"
 
-int hio_dataset_close (hio_dataset_t dataset) {
+#include <stdlib.h>
+
+typedef struct hioi_dataset_close_nb_t {
+  hio_dataset_t dataset;
+  hio_request_t request;
+} hioi_dataset_close_nb_t;
+
+static int hioi_dataset_close (hio_dataset_t dataset) {
   uint64_t tmp[6];
   hio_context_t context;
   uint64_t rctime;
   int rc;
 
-  if (HIO_OBJECT_NULL == dataset) {
-    return HIO_ERR_BAD_PARAM;
-  }
-
   if (dataset->ds_flags & HIO_FLAG_WRITE) {
     rc = hio_dataset_flush (dataset, HIO_FLUSH_MODE_COMPLETE);
     if (HIO_SUCCESS != rc) {
@@ -59,6 +62,14 @@ int hio_dataset_close (hio_dataset_t dataset) {
       ds_data->dd_average_write_time = (uint64_t) ((float) ds_data->dd_average_write_time * 0.8);
       ds_data->dd_average_write_time += (uint64_t) ((float) dataset->ds_stat.s_wtime * 0.2);
     }
+
+    /* cost of a checkpoint as seen by the application */
+    if (0 == ds_data->dd_average_checkpoint_time) {
+      ds_data->dd_average_checkpoint_time = rctime - dataset->ds_rotime;
+    } else {
+      ds_data->dd_average_checkpoint_time = (uint64_t) ((float) ds_data->dd_average_checkpoint_time * 0.8);
+      ds_data->dd_average_checkpoint_time += (uint64_t) ((float) (rctime - dataset->ds_rotime) * 0.2);
+    }
   }
 #if HIO_MPI_HAVE(1)
   if (1 != context->c_size) {
@@ -78,3 +89,83 @@ int hio_dataset_close (hio_dataset_t dataset) {
 
   return rc;
 }
+
+int hio_dataset_close (hio_dataset_t dataset) {
+  if (HIO_OBJECT_NULL == dataset) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  hioi_context_wait_pending (hioi_object_context (&dataset->ds_object));
+
+  return hioi_dataset_close (dataset);
+}
+
+static void *hioi_dataset_close_thread (void *arg) {
+  hioi_dataset_close_nb_t *close_nb = (hioi_dataset_close_nb_t *) arg;
+  hio_context_t context = hioi_object_context (&close_nb->dataset->ds_object);
+  int rc;
+
+  rc = hioi_dataset_close (close_nb->dataset);
+  if (HIO_OBJECT_NULL != close_nb->request) {
+    hioi_request_complete (close_nb->request, 0, rc);
+  }
+
+  free (close_nb);
+
+  /* the dataset may be freed by the application from this point on */
+  hioi_context_background_done (context);
+
+  return NULL;
+}
+
+int hio_dataset_close_nb (hio_dataset_t dataset, hio_request_t *request) {
+  hioi_dataset_close_nb_t *close_nb;
+  hio_request_t new_request = HIO_OBJECT_NULL;
+  hio_context_t context;
+  int rc;
+
+  if (HIO_OBJECT_NULL == dataset) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  context = hioi_object_context (&dataset->ds_object);
+
+  if (request) {
+    new_request = hioi_request_alloc (context);
+    if (HIO_OBJECT_NULL == new_request) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    *request = new_request;
+  }
+
+  close_nb = malloc (sizeof (*close_nb));
+  if (NULL == close_nb) {
+    hioi_request_release (new_request);
+    if (request) {
+      *request = HIO_OBJECT_NULL;
+    }
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  close_nb->dataset = dataset;
+  close_nb->request = new_request;
+
+  rc = hioi_context_start_background (context, hioi_dataset_close_thread, close_nb);
+  if (HIO_SUCCESS == rc) {
+    return HIO_SUCCESS;
+  }
+
+  /* the close can not progress in the background. close synchronously */
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Closing dataset %s::%" PRIu64 " synchronously",
+            hioi_object_identifier (dataset), dataset->ds_id);
+  free (close_nb);
+
+  hioi_context_wait_pending (context);
+  rc = hioi_dataset_close (dataset);
+  if (HIO_OBJECT_NULL != new_request) {
+    hioi_request_complete (new_request, 0, rc);
+  }
+
+  return rc;
+}
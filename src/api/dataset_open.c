@@ -206,25 +206,110 @@ static int hio_dataset_open_specific (hio_context_t context, hio_dataset_t datas
   return rc;
 }
 
+static int hioi_dataset_open (hio_dataset_t dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) dataset);
+  int rc;
+
+  if (dataset->ds_flags & HIO_FLAG_TRUNC) {
+    /* ensure we take the create path later */
+    dataset->ds_flags |= HIO_FLAG_CREAT;
+  }
+
+  if (HIO_DATASET_ID_HIGHEST == dataset->ds_id) {
+    rc = hio_dataset_open_last (dataset, hioi_dataset_header_highest_setid);
+  } else if (HIO_DATASET_ID_NEWEST == dataset->ds_id) {
+    rc = hio_dataset_open_last (dataset, hioi_dataset_header_newest);
+  } else {
+    rc = hio_dataset_open_specific (context, dataset);
+  }
+
+  if (HIO_SUCCESS == rc) {
+    hioi_dataset_prefetch (dataset);
+  }
+
+  return rc;
+}
+
 int hio_dataset_open (hio_dataset_t dataset) {
+  if (HIO_OBJECT_NULL == dataset) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  /* a dataset closed in the background must be complete before it can be found */
+  hioi_context_wait_pending (hioi_object_context ((hio_object_t) dataset));
+
+  return hioi_dataset_open (dataset);
+}
+
+typedef struct hioi_dataset_open_nb_t {
+  hio_dataset_t dataset;
+  hio_request_t request;
+} hioi_dataset_open_nb_t;
+
+static void *hioi_dataset_open_thread (void *arg) {
+  hioi_dataset_open_nb_t *open_nb = (hioi_dataset_open_nb_t *) arg;
+  hio_context_t context = hioi_object_context (&open_nb->dataset->ds_object);
+  int rc;
+
+  rc = hioi_dataset_open (open_nb->dataset);
+  if (HIO_OBJECT_NULL != open_nb->request) {
+    hioi_request_complete (open_nb->request, 0, rc);
+  }
+
+  free (open_nb);
+
+  hioi_context_background_done (context);
+
+  return NULL;
+}
+
+int hio_dataset_open_nb (hio_dataset_t dataset, hio_request_t *request) {
+  hio_request_t new_request = HIO_OBJECT_NULL;
+  hioi_dataset_open_nb_t *open_nb;
   hio_context_t context;
+  int rc;
 
   if (HIO_OBJECT_NULL == dataset) {
     return HIO_ERR_BAD_PARAM;
   }
 
-  if (dataset->ds_flags & HIO_FLAG_TRUNC) {
-    /* ensure we take the create path later */
-    dataset->ds_flags |= HIO_FLAG_CREAT;
+  context = hioi_object_context (&dataset->ds_object);
+
+  if (request) {
+    new_request = hioi_request_alloc (context);
+    if (HIO_OBJECT_NULL == new_request) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    *request = new_request;
   }
 
-  context = hioi_object_context ((hio_object_t) dataset);
+  open_nb = malloc (sizeof (*open_nb));
+  if (NULL == open_nb) {
+    hioi_request_release (new_request);
+    if (request) {
+      *request = HIO_OBJECT_NULL;
+    }
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
 
-  if (HIO_DATASET_ID_HIGHEST == dataset->ds_id) {
-    return hio_dataset_open_last (dataset, hioi_dataset_header_highest_setid);
-  } else if (HIO_DATASET_ID_NEWEST == dataset->ds_id) {
-    return hio_dataset_open_last (dataset, hioi_dataset_header_newest);
+  open_nb->dataset = dataset;
+  open_nb->request = new_request;
+
+  rc = hioi_context_start_background (context, hioi_dataset_open_thread, open_nb);
+  if (HIO_SUCCESS == rc) {
+    return HIO_SUCCESS;
   }
 
-  return hio_dataset_open_specific (context, dataset);
+  /* the open can not progress in the background. open synchronously */
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Opening dataset %s synchronously", hioi_object_identifier (dataset));
+  free (open_nb);
+
+  hioi_context_wait_pending (context);
+  rc = hioi_dataset_open (dataset);
+  if (HIO_OBJECT_NULL != new_request) {
+    hioi_request_complete (new_request, 0, rc);
+  }
+
+  return rc;
 }
@@ -0,0 +1,120 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2014-2016 Los Alamos National Security, LLC.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "hio_internal.h"
+
+#include <math.h>
+#include <time.h>
+
+/**
+ * Mean time between failures of the job in seconds
+ */
+static double hioi_checkpoint_mtbf (hio_context_t context) {
+  int node_count = 1;
+
+  if (context->c_checkpoint_mtbf) {
+    return (double) context->c_checkpoint_mtbf;
+  }
+
+#if HIO_MPI_HAVE(3)
+  if (context->c_node_count > 1) {
+    node_count = context->c_node_count;
+  }
+#endif
+
+  /* node failures are assumed to be independent */
+  return (double) context->c_node_mtbf / (double) node_count;
+}
+
+/**
+ * Optimal checkpoint interval in seconds
+ *
+ * @param[in] cost  time needed to write a checkpoint in seconds
+ * @param[in] mtbf  mean time between failures in seconds
+ *
+ * Uses Daly's higher order estimate of the optimum compute time between checkpoints
+ * which approaches Young's sqrt(2 * cost * mtbf) when the cost is small compared to
+ * the mtbf. The interval is the compute time from the end of one checkpoint to the
+ * start of the next.
+ */
+static double hioi_checkpoint_interval (double cost, double mtbf) {
+  double ratio;
+
+  if (cost >= 2.0 * mtbf) {
+    return mtbf;
+  }
+
+  ratio = cost / (2.0 * mtbf);
+
+  return sqrt (2.0 * cost * mtbf) * (1.0 + sqrt (ratio) / 3.0 + ratio / 9.0) - cost;
+}
+
+static hio_recommendation_t hioi_dataset_should_checkpoint (hio_context_t context, const char *name) {
+  hio_dataset_data_t *ds_data;
+  double cost, mtbf, interval, elapsed;
+  int rc;
+
+  rc = hioi_dataset_data_lookup (context, name, &ds_data);
+  if (HIO_SUCCESS != rc) {
+    return HIO_SCP_MUST_CHECKPOINT;
+  }
+
+  if (0 == ds_data->dd_last_write_completion || 0 == ds_data->dd_average_checkpoint_time) {
+    /* no instance has been written by this context. the cost of a checkpoint is unknown */
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "No checkpoint history for dataset %s. Recommending a checkpoint",
+              name);
+    return HIO_SCP_MUST_CHECKPOINT;
+  }
+
+  cost = (double) ds_data->dd_average_checkpoint_time / 1000000.0;
+  mtbf = hioi_checkpoint_mtbf (context);
+  interval = hioi_checkpoint_interval (cost, mtbf);
+  elapsed = difftime (time (NULL), ds_data->dd_last_write_completion);
+
+  context->c_checkpoint_interval = (uint64_t) interval;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Checkpoint model for dataset %s: cost %.3f s, mtbf %.0f s, "
+            "interval %.0f s, elapsed %.0f s", name, cost, mtbf, interval, elapsed);
+
+  return (elapsed >= interval) ? HIO_SCP_MUST_CHECKPOINT : HIO_SCP_NOT_NOW;
+}
+
+hio_recommendation_t hio_dataset_should_checkpoint (hio_context_t context, const char *name) {
+  int recommendation = HIO_SCP_MUST_CHECKPOINT;
+
+  if (HIO_OBJECT_NULL == context || NULL == name) {
+    return HIO_SCP_NOT_NOW;
+  }
+
+  /* the history is only updated once a background close finishes */
+  hioi_context_wait_pending (context);
+
+#if HIO_MPI_HAVE(3)
+  /* the job mtbf depends on the node count which is only known once the (collective) leader
+   * list has been generated */
+  if (hioi_context_using_mpi (context) && MPI_COMM_NULL != context->c_shared_comm) {
+    (void) hioi_context_generate_leader_list (context);
+  }
+#endif
+
+  if (0 == context->c_rank) {
+    recommendation = hioi_dataset_should_checkpoint (context, name);
+  }
+
+#if HIO_MPI_HAVE(1)
+  /* every rank must get the same answer or the following collective open would hang */
+  if (hioi_context_using_mpi (context)) {
+    MPI_Bcast (&recommendation, 1, MPI_INT, 0, context->c_comm);
+  }
+#endif
+
+  return (hio_recommendation_t) recommendation;
+}
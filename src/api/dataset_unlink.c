@@ -19,6 +19,8 @@ int hio_dataset_unlink (hio_context_t ctx, const char *name, int64_t set_id, hio
     return HIO_ERR_BAD_PARAM;
   }
 
+  hioi_context_wait_pending (ctx);
+
   if (0 == ctx->c_mcount) {
     /* create hio modules for each item in the specified data roots */
     rc = hioi_context_create_modules (ctx);
@@ -144,9 +144,7 @@ int hio_element_write_strided_nb (hio_element_t element, hio_request_t *request,
       }
 
       *request = new_request;
-      new_request->req_transferred = size * count;
-      new_request->req_complete = true;
-      new_request->req_status = HIO_SUCCESS;
+      hioi_request_complete (new_request, size * count, HIO_SUCCESS);
     }
 
     return HIO_SUCCESS;
@@ -186,6 +184,13 @@ int hio_dataset_flush (hio_dataset_t dataset, hio_flush_mode_t mode) {
     return rc;
   }
 
+  if (NULL != dataset->ds_flush) {
+    rc = dataset->ds_flush (dataset, mode);
+    if (HIO_SUCCESS != rc) {
+      return rc;
+    }
+  }
+
   hioi_list_foreach(element, dataset->ds_elist, struct hio_element, e_list) {
     rc = element->e_flush (element, mode);
     if (HIO_SUCCESS != rc) {
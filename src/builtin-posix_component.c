@@ -15,7 +15,6 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <stdarg.h>
-#include <ftw.h>
 #include <assert.h>
 
 #include <string.h>
@@ -25,6 +24,7 @@
 #endif
 
 #include <errno.h>
+#include <limits.h>
 
 #include <dirent.h>
 #include <unistd.h>
@@ -38,21 +38,43 @@ static hio_var_enum_value_t hioi_dataset_file_mode_values[] = {
   {.string_value = "basic", .value = HIO_FILE_MODE_BASIC},
   {.string_value = "file_per_node", .value = HIO_FILE_MODE_OPTIMIZED},
   {.string_value = "strided", .value = HIO_FILE_MODE_STRIDED},
+  {.string_value = "packed", .value = HIO_FILE_MODE_PACKED},
 };
 
 static hio_var_enum_t hioi_dataset_file_modes = {
-  .count  = 3,
+  .count  = 4,
   .values = hioi_dataset_file_mode_values,
 };
 
+static hio_var_enum_value_t hioi_dataset_root_spread_values[] = {
+  {.string_value = "none", .value = HIO_POSIX_ROOT_SPREAD_NONE},
+  {.string_value = "node", .value = HIO_POSIX_ROOT_SPREAD_NODE},
+  {.string_value = "block", .value = HIO_POSIX_ROOT_SPREAD_BLOCK},
+};
+
+static hio_var_enum_t hioi_dataset_root_spreads = {
+  .count  = 3,
+  .values = hioi_dataset_root_spread_values,
+};
+
 /** static functions */
 static int builtin_posix_module_dataset_unlink (struct hio_module_t *module, const char *name, int64_t set_id);
 static int builtin_posix_module_dataset_close (hio_dataset_t dataset);
 static int builtin_posix_module_element_open (hio_dataset_t dataset, hio_element_t element);
 static int builtin_posix_module_element_close (hio_element_t element);
 static int builtin_posix_module_element_flush (hio_element_t element, hio_flush_mode_t mode);
+static int builtin_posix_module_dataset_flush (hio_dataset_t dataset, hio_flush_mode_t mode);
 static int builtin_posix_module_element_complete (hio_element_t element);
+#if defined(HAVE_POSIX_FADVISE)
+static int builtin_posix_module_element_prefetch (hio_element_t element);
+#endif
 static int builtin_posix_module_process_reqs (hio_dataset_t dataset, hio_internal_request_t **reqs, int req_count);
+static int builtin_posix_module_dataset_open (struct hio_module_t *module, hio_dataset_t dataset);
+static void builtin_posix_apply_retention (builtin_posix_module_dataset_t *posix_dataset);
+static int builtin_posix_data_dir (builtin_posix_module_dataset_t *posix_dataset, int root, const char *name);
+static void builtin_posix_write_behind (builtin_posix_module_dataset_t *posix_dataset, hio_file_t *file,
+                                        uint64_t offset, size_t count);
+static int builtin_posix_sync_file (builtin_posix_module_dataset_t *posix_dataset, hio_file_t *file);
 
 
 static void builtin_posix_trace (builtin_posix_module_dataset_t *posix_dataset, const char *event,
@@ -84,6 +106,149 @@ static int builtin_posix_dataset_path (struct hio_module_t *module, char **path,
   return (0 > rc) ? hioi_err_errno (errno) : HIO_SUCCESS;
 }
 
+/**
+ * Get the dataset directory in one of the data roots holding its data files
+ *
+ * @param[in]  posix_dataset  posix dataset
+ * @param[in]  root           index of the data root in the dataset data root list
+ * @param[out] path           dataset directory (must be freed by the caller)
+ */
+static int builtin_posix_root_path (builtin_posix_module_dataset_t *posix_dataset, int root, char **path) {
+  hio_context_t context = hioi_object_context (&posix_dataset->base.ds_object);
+  const char *data_root = posix_dataset->base.ds_data_roots;
+  size_t length;
+  int rc;
+
+  if (0 == root || NULL == data_root) {
+    *path = strdup (posix_dataset->base_path);
+    return *path ? HIO_SUCCESS : HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  for (int i = 0 ; i < root && NULL != data_root ; ++i) {
+    data_root = strchr (data_root, ',');
+    if (NULL != data_root) {
+      ++data_root;
+    }
+  }
+
+  if (NULL == data_root) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  length = strcspn (data_root, ",");
+  rc = asprintf (path, "%.*s/%s.hio/%s/%lu", (int) length, data_root, hioi_object_identifier(context),
+                 hioi_object_identifier (posix_dataset), (unsigned long) posix_dataset->base.ds_id);
+
+  return (0 > rc) ? HIO_ERR_OUT_OF_RESOURCE : HIO_SUCCESS;
+}
+
+static bool builtin_posix_is_posix_module (hio_module_t *module) {
+  return builtin_posix_module_dataset_open == module->dataset_open;
+}
+
+/**
+ * Choose the data roots to spread the data files of a new dataset over
+ *
+ * All posix data roots of the context are used. The data root the dataset is being
+ * opened from is always first since it holds the manifests.
+ */
+static int builtin_posix_setup_data_roots (hio_module_t *module, builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context (&posix_dataset->base.ds_object);
+  char *data_roots, *tmp;
+  int count = 1, rc;
+
+  data_roots = strdup (module->data_root);
+  if (NULL == data_roots) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  for (int i = 0 ; i < context->c_mcount ; ++i) {
+    hio_module_t *other = context->c_modules[i];
+
+    if (other == module || !builtin_posix_is_posix_module (other)) {
+      continue;
+    }
+
+    rc = asprintf (&tmp, "%s,%s", data_roots, other->data_root);
+    free (data_roots);
+    if (0 > rc) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    data_roots = tmp;
+    ++count;
+  }
+
+  if (1 == count) {
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: only one posix data root available. "
+              "not spreading data files over data roots (%s)", module->data_root);
+    free (data_roots);
+    return HIO_SUCCESS;
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: spreading data files over %d data roots: %s",
+            count, data_roots);
+  posix_dataset->base.ds_data_roots = data_roots;
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_posix_root_count (const char *data_roots) {
+  int count = 1;
+
+  if (NULL == data_roots) {
+    return 1;
+  }
+
+  for (const char *tmp = strchr (data_roots, ',') ; NULL != tmp ; tmp = strchr (tmp + 1, ',')) {
+    ++count;
+  }
+
+  return (count > HIO_MAX_DATA_ROOTS) ? HIO_MAX_DATA_ROOTS : count;
+}
+
+/**
+ * Create the subdirectories of the data directory
+ *
+ * Writers never create directories so the subdirectories are all created up front by rank 0.
+ * Their number is bounded by the communicator size (basic mode) or the file count (strided mode).
+ */
+static int builtin_posix_create_shard_dirs (builtin_posix_module_t *posix_module, builtin_posix_module_dataset_t *posix_dataset,
+                                            const char *path) {
+  hio_context_t context = posix_module->base.context;
+  unsigned long shard_size = posix_dataset->base.ds_dir_shard_size, count;
+  char name[32];
+  int dirfd, rc = HIO_SUCCESS;
+
+  if (0 == shard_size) {
+    return HIO_SUCCESS;
+  }
+
+  count = (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) ? (unsigned long) posix_dataset->ds_fcount :
+    (unsigned long) context->c_size;
+  count = (count + shard_size - 1) / shard_size;
+
+  dirfd = open (path, O_RDONLY | O_DIRECTORY);
+  if (0 > dirfd) {
+    return hioi_err_errno (errno);
+  }
+
+  for (unsigned long i = 0 ; i < count ; ++i) {
+    snprintf (name, sizeof (name), "%lu", i);
+    if (mkdirat (dirfd, name, posix_module->access_mode) && EEXIST != errno) {
+      rc = hioi_err_errno (errno);
+      hioi_err_push (rc, &context->c_object, "posix: error creating data subdirectory %s/%s", path, name);
+      break;
+    }
+  }
+
+  close (dirfd);
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: created %lu data subdirectories in %s", count, path);
+
+  return rc;
+}
+
 static int builtin_posix_create_dataset_dirs (builtin_posix_module_t *posix_module, builtin_posix_module_dataset_t *posix_dataset) {
   mode_t access_mode = posix_module->access_mode;
   hio_context_t context = posix_module->base.context;
@@ -121,7 +286,41 @@ static int builtin_posix_create_dataset_dirs (builtin_posix_module_t *posix_modu
     }
   }
 
+  rc = builtin_posix_create_shard_dirs (posix_module, posix_dataset, path);
   free (path);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  /* create the data directory in the other data roots holding data files */
+  for (int i = 1 ; i < posix_dataset->ds_root_count ; ++i) {
+    char *root_path;
+
+    rc = builtin_posix_root_path (posix_dataset, i, &root_path);
+    if (HIO_SUCCESS != rc) {
+      return rc;
+    }
+
+    rc = asprintf (&path, "%s/data", root_path);
+    free (root_path);
+    if (0 > rc) {
+      return hioi_err_errno (errno);
+    }
+
+    rc = hio_mkpath (context, path, access_mode);
+    if (0 > rc && EEXIST != errno) {
+      rc = hioi_err_errno (errno);
+      hioi_err_push (rc, &context->c_object, "posix: error creating data directory: %s", path);
+      free (path);
+      return rc;
+    }
+
+    if (posix_dataset->base.ds_fsattr.fs_flags & HIO_FS_SUPPORTS_STRIPING) {
+      (void) hioi_fs_set_stripe (path, &posix_dataset->base.ds_fsattr);
+    }
+
+    free (path);
+  }
 
   /* create trace directory if requested */
   if (context->c_enable_tracing) {
@@ -361,496 +560,2026 @@ static int builtin_posix_module_dataset_init (struct hio_module_t *module,
                  (unsigned long) posix_dataset->base.ds_id);
   assert (0 < rc);
 
-  /* initialize posix dataset specific data */
-  for (int i = 0 ; i < HIO_POSIX_MAX_OPEN_FILES ; ++i) {
-    posix_dataset->files[i].f_bid = -1;
-    posix_dataset->files[i].f_hndl = NULL;
-    posix_dataset->files[i].f_fd = -1;
+  /* initialize posix dataset specific data. the file cache is allocated on first use */
+  posix_dataset->ds_files = NULL;
+  for (int i = 0 ; i < HIO_MAX_DATA_ROOTS ; ++i) {
+    posix_dataset->ds_data_dirfd[i] = -1;
+  }
+
+  posix_dataset->ds_max_open_files = HIO_POSIX_MAX_OPEN_FILES;
+  hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_max_open_files,
+                   "dataset_max_open_files", HIO_CONFIG_TYPE_UINT64, NULL,
+                   "Maximum number of data files each rank keeps open in strided and optimized "
+                   "file modes (default: 32)", 0);
+  if (0 == posix_dataset->ds_max_open_files) {
+    posix_dataset->ds_max_open_files = 1;
   }
 
+  hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_file_opens,
+                 "file_opens", HIO_CONFIG_TYPE_UINT64, NULL, "Number of data files opened by this "
+                 "rank in strided and optimized file modes", 0);
+
+  hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_flush_time,
+                 "flush_time", HIO_CONFIG_TYPE_UINT64, NULL, "Time spent by this rank syncing data files "
+                 "to the backing store in usec", 0);
+
+  hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_syncfs_count,
+                 "flush_syncfs_count", HIO_CONFIG_TYPE_UINT64, NULL, "Number of syncfs calls made by this "
+                 "rank on behalf of the ranks on its node", 0);
+
   /* default to strided output mode */
   posix_dataset->ds_fmode = HIO_FILE_MODE_STRIDED;
   hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_fmode,
                    "dataset_file_mode", HIO_CONFIG_TYPE_INT32, &hioi_dataset_file_modes,
-                   "Modes for writing dataset files. Valid values: (0: basic, 1: file_per_node, 2: strided)", 0);
+                   "Modes for writing dataset files. Valid values: (0: basic, 1: file_per_node, 2: strided, "
+                   "3: packed)", 0);
 
   if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode && HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
     /* strided mode only applies to shared datasets */
     posix_dataset->ds_fmode = HIO_FILE_MODE_BASIC;
   }
 
-  if (HIO_FILE_MODE_BASIC != posix_dataset->ds_fmode) {
+  if (HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode && HIO_SET_ELEMENT_SHARED == posix_dataset->base.ds_mode) {
+    /* packed mode only applies to unique datasets */
+    posix_dataset->ds_fmode = HIO_FILE_MODE_BASIC;
+  }
+
+  if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode || HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
     posix_dataset->ds_bs = 1ul << 23;
     hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_bs,
                      "dataset_block_size", HIO_CONFIG_TYPE_INT64, NULL,
                      "Block size to use when writing in optimized mode (default: 8M)", 0);
   }
 
+  if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+    posix_dataset->ds_sub_block_size = 1ul << 20;
+    hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_sub_block_size,
+                     "dataset_sub_block_size", HIO_CONFIG_TYPE_UINT64, NULL,
+                     "Granularity used to pack small writers into blocks shared by the ranks on a node "
+                     "in optimized mode. Ranks that write less than a block reserve space in units of "
+                     "this size (0: disable, default: 1M)", 0);
+
+    posix_dataset->ds_preallocate = true;
+    hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_preallocate,
+                     "dataset_preallocate", HIO_CONFIG_TYPE_BOOL, NULL,
+                     "Preallocate blocks in the data file that will be completely filled by a single "
+                     "write (default: true)", 0);
+  }
+
+  posix_dataset->ds_autotune = false;
+  hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_autotune,
+                   "dataset_autotune", HIO_CONFIG_TYPE_BOOL, NULL,
+                   "Choose stripe size, stripe count, block size, and buffer size for new instances "
+                   "using the write bandwidth of earlier instances of this dataset (default: false)", 0);
+
+  if (posix_dataset->ds_autotune) {
+    posix_dataset->ds_autotune_persist = false;
+    hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_autotune_persist,
+                     "dataset_autotune_persist", HIO_CONFIG_TYPE_BOOL, NULL,
+                     "Keep the autotuning history in the data root so it survives between jobs "
+                     "(default: false)", 0);
+
+    posix_dataset->ds_autotune_explore = 8;
+    hioi_config_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_autotune_explore,
+                     "dataset_autotune_explore", HIO_CONFIG_TYPE_UINT64, NULL,
+                     "Number of neighbors of the best known configuration (one parameter doubled or "
+                     "halved) that may be tried before settling on the best one (default: 8)", 0);
+
+    hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_tune.tp_ssize,
+                   "autotune_stripe_size", HIO_CONFIG_TYPE_UINT64, NULL, "Stripe size chosen for "
+                   "this dataset instance", 0);
+    hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_tune.tp_scount,
+                   "autotune_stripe_count", HIO_CONFIG_TYPE_UINT64, NULL, "Stripe count chosen for "
+                   "this dataset instance", 0);
+    hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_tune.tp_bs,
+                   "autotune_block_size", HIO_CONFIG_TYPE_UINT64, NULL, "Block size chosen for "
+                   "this dataset instance", 0);
+    hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_tune.tp_buffer_size,
+                   "autotune_buffer_size", HIO_CONFIG_TYPE_UINT64, NULL, "Buffer size chosen for "
+                   "this dataset instance", 0);
+    hioi_perf_add (context, &posix_dataset->base.ds_object, &posix_dataset->ds_tune_predicted,
+                   "autotune_predicted_bandwidth", HIO_CONFIG_TYPE_UINT64, NULL, "Write bandwidth "
+                   "predicted for this dataset instance in bytes/sec (0: unknown)", 0);
+  }
+
   return HIO_SUCCESS;
 }
 
-static int builtin_posix_module_setup_striping (hio_context_t context, struct hio_module_t *module, hio_dataset_t dataset) {
-  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
-  hio_fs_attr_t *fs_attr = &dataset->ds_fsattr;
-  int rc;
+/* stripe/block autotuner. each dataset name keeps the configurations used by earlier
+ * instances along with the write bandwidth they achieved. an open either reuses the best
+ * known configuration or, while the exploration budget lasts, doubles or halves one
+ * parameter of the best configuration. all ranks hold identical histories so every rank
+ * makes the same choice without communication. */
 
-  /* query the filesystem for current striping parameters */
-  rc = hioi_fs_query (context, module->data_root, fs_attr);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (rc, &context->c_object, "posix: error querying the filesystem");
-    return rc;
+static char *builtin_posix_autotune_path (builtin_posix_module_dataset_t *posix_dataset) {
+  const char *id_dir = strrchr (posix_dataset->base_path, '/');
+  char *path;
+
+  /* the history is shared by all instances so it lives next to the dataset id directories.
+   * dataset listing skips dot files */
+  if (NULL == id_dir || 0 > asprintf (&path, "%.*s/.autotune", (int) (id_dir - posix_dataset->base_path),
+                                      posix_dataset->base_path)) {
+    return NULL;
   }
 
-  /* for now do not use stripe exclusivity in any path */
-  posix_dataset->my_stripe = 0;
+  return path;
+}
 
-  /* set default stripe count */
-  fs_attr->fs_scount = 1;
+static void builtin_posix_autotune_load (builtin_posix_module_dataset_t *posix_dataset,
+                                         builtin_posix_dataset_backend_data_t *pd_data) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
 
-  posix_dataset->ds_fcount = 1;
+  if (0 == context->c_rank) {
+    char *path = builtin_posix_autotune_path (posix_dataset);
+    FILE *fh = path ? fopen (path, "r") : NULL;
+
+    if (NULL != fh) {
+      builtin_posix_tune_point_t *point = pd_data->pd_points;
+      unsigned long long explored = 0;
+
+      if (1 == fscanf (fh, "hio_autotune 1 %llu\n", &explored)) {
+        pd_data->pd_explored = explored;
+
+        while (pd_data->pd_count < HIO_POSIX_TUNE_HISTORY &&
+               6 == fscanf (fh, "%" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64 "\n",
+                            &point->tp_ssize, &point->tp_scount, &point->tp_bs, &point->tp_buffer_size,
+                            &point->tp_bandwidth, &point->tp_samples)) {
+          ++pd_data->pd_count;
+          ++point;
+        }
+      }
 
-  if (fs_attr->fs_flags & HIO_FS_SUPPORTS_STRIPING) {
-    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
-      /* pick a reasonable default stripe size */
-      fs_attr->fs_ssize = 1 << 24;
+      fclose (fh);
+    }
 
-      /* use group locking if available as we guarantee stripe exclusivity in optimized mode */
-      fs_attr->fs_use_group_locking = true;
+    free (path);
+  }
 
-#if HIO_MPI_HAVE(3)
-      /* if group locking is not available then each rank should attempt to write to
-       * a different stripe to maximize the available IO bandwidth */
-      fs_attr->fs_scount = min(context->c_shared_size, fs_attr->fs_smax_count);
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    MPI_Bcast (&pd_data->pd_count, 1, MPI_INT, 0, context->c_comm);
+    MPI_Bcast (&pd_data->pd_explored, 1, MPI_UINT64_T, 0, context->c_comm);
+    MPI_Bcast (pd_data->pd_points, sizeof (pd_data->pd_points[0]) * pd_data->pd_count, MPI_BYTE, 0,
+               context->c_comm);
+  }
 #endif
-    } else if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) {
-      /* pick a reasonable default stripe size */
-      fs_attr->fs_ssize = posix_dataset->ds_bs;
+}
 
-      posix_dataset->ds_fcount = fs_attr->fs_smax_count * 32;
-      fs_attr->fs_scount = 16;
-      if (context->c_size < posix_dataset->ds_fcount) {
-        posix_dataset->ds_fcount = context->c_size;
-      }
-    } else if (HIO_SET_ELEMENT_UNIQUE != dataset->ds_mode) {
-      /* set defaults striping count */
-      fs_attr->fs_ssize = 1 << 20;
-      fs_attr->fs_scount = max (1, (unsigned) ((float) fs_attr->fs_smax_count * 0.9));
+static void builtin_posix_autotune_save (builtin_posix_module_dataset_t *posix_dataset,
+                                         builtin_posix_dataset_backend_data_t *pd_data) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  char *path, *tmp_path;
+  FILE *fh;
+
+  if (0 != context->c_rank || NULL == (path = builtin_posix_autotune_path (posix_dataset))) {
+    return;
+  }
+
+  /* write a new copy and rename it into place so readers never see a partial history */
+  if (0 > asprintf (&tmp_path, "%s.%d", path, (int) getpid ())) {
+    free (path);
+    return;
+  }
+
+  fh = fopen (tmp_path, "w");
+  if (NULL != fh) {
+    fprintf (fh, "hio_autotune 1 %llu\n", (unsigned long long) pd_data->pd_explored);
+    for (int i = 0 ; i < pd_data->pd_count ; ++i) {
+      builtin_posix_tune_point_t *point = pd_data->pd_points + i;
+      fprintf (fh, "%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+               point->tp_ssize, point->tp_scount, point->tp_bs, point->tp_buffer_size,
+               point->tp_bandwidth, point->tp_samples);
+    }
+
+    if (0 == fclose (fh) && 0 == rename (tmp_path, path)) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:autotune: saved %d configurations to %s",
+                pd_data->pd_count, path);
     } else {
-      fs_attr->fs_ssize = 1 << 20;
+      unlink (tmp_path);
     }
+  }
 
-    hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_scount,
-                     "stripe_count", HIO_CONFIG_TYPE_UINT32, NULL, "Stripe count for all dataset "
-                     "data files", 0);
+  free (tmp_path);
+  free (path);
+}
 
-    hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_ssize,
-                     "stripe_size", HIO_CONFIG_TYPE_UINT64, NULL, "Stripe size for all dataset "
-                     "data files", 0);
+static builtin_posix_dataset_backend_data_t *builtin_posix_autotune_data (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  builtin_posix_dataset_backend_data_t *pd_data;
 
-    if (fs_attr->fs_flags & HIO_FS_SUPPORTS_RAID) {
-      hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_raid_level,
-                       "raid_level", HIO_CONFIG_TYPE_UINT64, NULL, "RAID level for dataset "
-                       "data files. Keep in mind that some filesystems only support 1/2 RAID "
-                       "levels", 0);
+  pd_data = (builtin_posix_dataset_backend_data_t *) hioi_dbd_lookup_backend_data (dataset->ds_data, "posix");
+  if (NULL == pd_data) {
+    pd_data = (builtin_posix_dataset_backend_data_t *) hioi_dbd_alloc (dataset->ds_data, "posix", sizeof (*pd_data));
+    if (NULL != pd_data && posix_dataset->ds_autotune_persist) {
+      builtin_posix_autotune_load (posix_dataset, pd_data);
     }
+  }
 
-    /* ensure stripe count is sane */
-    if (fs_attr->fs_scount > fs_attr->fs_smax_count) {
-      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: requested stripe count %u exceeds the available resources. "
-                "adjusting to maximum %u", fs_attr->fs_scount, fs_attr->fs_smax_count);
-      fs_attr->fs_scount = fs_attr->fs_smax_count;
+  return pd_data;
+}
+
+static bool builtin_posix_tune_point_equal (const builtin_posix_tune_point_t *a, const builtin_posix_tune_point_t *b) {
+  return a->tp_ssize == b->tp_ssize && a->tp_scount == b->tp_scount && a->tp_bs == b->tp_bs &&
+    a->tp_buffer_size == b->tp_buffer_size;
+}
+
+static builtin_posix_tune_point_t *builtin_posix_autotune_find (builtin_posix_dataset_backend_data_t *pd_data,
+                                                                const builtin_posix_tune_point_t *point) {
+  for (int i = 0 ; i < pd_data->pd_count ; ++i) {
+    if (builtin_posix_tune_point_equal (pd_data->pd_points + i, point)) {
+      return pd_data->pd_points + i;
     }
+  }
 
-    /* ensure the stripe size is a multiple of the stripe unit */
-    fs_attr->fs_ssize = fs_attr->fs_sunit * ((fs_attr->fs_ssize + fs_attr->fs_sunit - 1) / fs_attr->fs_sunit);
-    if (fs_attr->fs_ssize > fs_attr->fs_smax_size) {
-      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: requested stripe size %" PRIu64 " exceeds the maximum %"
-                PRIu64 ". ", fs_attr->fs_ssize, fs_attr->fs_smax_size);
-      fs_attr->fs_ssize = fs_attr->fs_smax_size;
+  return NULL;
+}
+
+/**
+ * Double or halve one parameter of a configuration
+ *
+ * @returns false if the result would leave the bounds of the filesystem or does not
+ *          apply to the dataset file mode
+ */
+static bool builtin_posix_autotune_neighbor (builtin_posix_module_dataset_t *posix_dataset, builtin_posix_tune_point_t *point,
+                                             int param, bool grow) {
+  hio_fs_attr_t *fs_attr = &posix_dataset->base.ds_fsattr;
+  bool striping = !!(fs_attr->fs_flags & HIO_FS_SUPPORTS_STRIPING);
+  uint64_t *value, lower, upper;
+
+  switch (param) {
+  case 0:
+    value = &point->tp_ssize;
+    lower = fs_attr->fs_sunit ? fs_attr->fs_sunit : 1;
+    upper = fs_attr->fs_smax_size;
+    if (!striping) {
+      return false;
+    }
+    break;
+  case 1:
+    value = &point->tp_scount;
+    lower = 1;
+    upper = fs_attr->fs_smax_count;
+    if (!striping) {
+      return false;
+    }
+    break;
+  case 2:
+    /* only optimized mode records where each block landed. explicit values are not tuned */
+    if (HIO_FILE_MODE_OPTIMIZED != posix_dataset->ds_fmode ||
+        hioi_config_is_set (&posix_dataset->base.ds_object, "dataset_block_size")) {
+      return false;
+    }
+    value = &point->tp_bs;
+    lower = max (1ul << 20, point->tp_ssize);
+    upper = 1ul << 30;
+    break;
+  default:
+    if (hioi_config_is_set (&posix_dataset->base.ds_object, "dataset_buffer_size")) {
+      return false;
     }
+    value = &point->tp_buffer_size;
+    lower = 1ul << 16;
+    upper = 1ul << 30;
+  }
 
-    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode && posix_dataset->ds_bs < fs_attr->fs_ssize) {
-      posix_dataset->ds_bs = fs_attr->fs_ssize;
+  if (grow) {
+    if (*value > upper / 2) {
+      return false;
+    }
+    *value *= 2;
+  } else {
+    if (*value / 2 < lower) {
+      return false;
     }
+    *value /= 2;
   }
 
-  return HIO_SUCCESS;
+  return true;
 }
 
-#if HIO_MPI_HAVE(3)
-static int bultin_posix_scatter_data (builtin_posix_module_dataset_t *posix_dataset) {
+/**
+ * Replace the heuristic defaults with values learned from earlier instances
+ *
+ * Called after the defaults are set up and before the stripe values are registered as
+ * configuration variables so explicitly configured stripe values still win. The block
+ * and buffer sizes are already registered and are left alone if they were set explicitly.
+ */
+static void builtin_posix_autotune_select (builtin_posix_module_dataset_t *posix_dataset) {
   hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
-  size_t manifest_size = 0, manifest_id_count = 0;
-  unsigned char *manifest = NULL;
-  int rc = HIO_SUCCESS;
-  int *manifest_ids;
-  char *path;
+  hio_dataset_t dataset = &posix_dataset->base;
+  hio_fs_attr_t *fs_attr = &dataset->ds_fsattr;
+  builtin_posix_dataset_backend_data_t *pd_data;
+  builtin_posix_tune_point_t *best = NULL, *known, choice;
 
-  if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
-    /* only read the manifest this rank wrote */
-    manifest_id_count = 1;
-    manifest_ids = malloc (sizeof (*manifest_ids));
-    manifest_ids[0] = context->c_rank;
-  } else {
-    rc = builtin_posix_module_dataset_manifest_list (posix_dataset, &manifest_ids, &manifest_id_count);
-    if (HIO_SUCCESS != rc) {
-      return rc;
-    }
+  choice = (builtin_posix_tune_point_t) {.tp_ssize = fs_attr->fs_ssize, .tp_scount = fs_attr->fs_scount,
+                                         .tp_bs = posix_dataset->ds_bs, .tp_buffer_size = dataset->ds_buffer_size};
+
+  if (!posix_dataset->ds_autotune || !(dataset->ds_flags & HIO_FLAG_CREAT)) {
+    return;
   }
 
-  for (size_t i = 0 ; i < manifest_id_count ; ++i) {
-    if (-1 == manifest_ids[i]) {
-      /* nothing more to do */
-      break;
+  pd_data = builtin_posix_autotune_data (posix_dataset);
+  if (NULL == pd_data) {
+    return;
+  }
+
+  for (int i = 0 ; i < pd_data->pd_count ; ++i) {
+    if (NULL == best || pd_data->pd_points[i].tp_bandwidth > best->tp_bandwidth) {
+      best = pd_data->pd_points + i;
     }
+  }
 
-    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: reading manifest data from id %x\n",
-              manifest_ids[i]);
+  if (NULL != best) {
+    choice = *best;
 
-    /* when writing the manifest in optimized mode each IO manager writes its own manifest. try
-     * to open the manifest. if a manifest does not exist then it is likely this rank did not
-     * write a manifest. IO managers will distribute the manifest data to the appropriate ranks
-     * in hioi_dataset_scatter(). */
-    rc = asprintf (&path, "%s/manifest.%x.json.bz2", posix_dataset->base_path, manifest_ids[i]);
-    assert (0 < rc);
+    /* bounded exploration around the best known configuration */
+    for (int i = 0 ; i < 8 && pd_data->pd_explored < posix_dataset->ds_autotune_explore ; ++i) {
+      uint64_t step = pd_data->pd_explored + i;
+      builtin_posix_tune_point_t candidate = *best;
 
-    if (access (path, F_OK)) {
-      free (path);
-      /* Check for a non-bzip'd manifest file. */
-      rc = asprintf (&path, "%s/manifest.%x.json", posix_dataset->base_path, manifest_ids[i]);
-      assert (0 < rc);
-      if (access (path, F_OK)) {
-        /* no manifest found. this might be a non-optimized file format or this rank may not be an
-         * IO master rank. */
-        free (path);
-        path = NULL;
+      if (!builtin_posix_autotune_neighbor (posix_dataset, &candidate, step % 4, !((step / 4) & 1)) ||
+          NULL != builtin_posix_autotune_find (pd_data, &candidate)) {
+        continue;
       }
+
+      pd_data->pd_explored = step + 1;
+      choice = candidate;
+      break;
     }
+  }
 
-    if (path) {
-      unsigned char *tmp = NULL;
-      size_t tmp_size = 0;
-      /* read the manifest if it exists */
-      rc = hioi_manifest_read (path, &tmp, &tmp_size);
-      if (HIO_SUCCESS == rc) {
-        rc = hioi_manifest_merge_data2 (&manifest, &manifest_size, tmp, tmp_size);
-        free (tmp);
-      }
+  known = builtin_posix_autotune_find (pd_data, &choice);
+  posix_dataset->ds_tune_predicted = known ? known->tp_bandwidth : (best ? best->tp_bandwidth : 0);
 
-      free (path);
+  fs_attr->fs_ssize = choice.tp_ssize;
+  fs_attr->fs_scount = choice.tp_scount;
 
-      if (HIO_SUCCESS != rc) {
-        break;
-      }
-    }
+  if (hioi_config_is_set (&dataset->ds_object, "dataset_block_size")) {
+    choice.tp_bs = posix_dataset->ds_bs;
+  } else {
+    posix_dataset->ds_bs = choice.tp_bs;
   }
 
-  /* share dataset information with all processes on this node */
-  if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
-    rc = hioi_dataset_scatter_unique (&posix_dataset->base, manifest, manifest_size, rc);
+  if (hioi_config_is_set (&dataset->ds_object, "dataset_buffer_size")) {
+    choice.tp_buffer_size = dataset->ds_buffer_size;
   } else {
-    rc = hioi_dataset_scatter_comm (&posix_dataset->base, context->c_shared_comm, manifest, manifest_size, rc);
+    dataset->ds_buffer_size = choice.tp_buffer_size;
   }
 
-  free (manifest_ids);
-  free (manifest);
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:autotune: dataset %s using stripe size %" PRIu64 ", stripe count %"
+            PRIu64 ", block size %" PRIu64 ", buffer size %" PRIu64 ". predicted bandwidth %" PRIu64 " B/s",
+            hioi_object_identifier (dataset), choice.tp_ssize, choice.tp_scount, choice.tp_bs,
+            choice.tp_buffer_size, posix_dataset->ds_tune_predicted);
+}
 
-  return rc;
-}
+/**
+ * Record the bandwidth achieved by the configuration used for this instance
+ */
+static void builtin_posix_autotune_record (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  hio_dataset_t dataset = &posix_dataset->base;
+  builtin_posix_dataset_backend_data_t *pd_data;
+  builtin_posix_tune_point_t *point;
+  uint64_t bytes = dataset->ds_stat.s_bwritten, wtime = dataset->ds_stat.s_wtime, bandwidth;
+
+  if (!posix_dataset->ds_autotune || !(dataset->ds_flags & HIO_FLAG_CREAT)) {
+    return;
+  }
+
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    /* every rank must record the same measurement */
+    MPI_Allreduce (MPI_IN_PLACE, &bytes, 1, MPI_UINT64_T, MPI_SUM, context->c_comm);
+    MPI_Allreduce (MPI_IN_PLACE, &wtime, 1, MPI_UINT64_T, MPI_MAX, context->c_comm);
+  }
 #endif
 
-static int builtin_posix_module_dataset_open (struct hio_module_t *module, hio_dataset_t dataset) {
-  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
-  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) module;
-  hio_context_t context = hioi_object_context ((hio_object_t) dataset);
-  unsigned char *manifest = NULL;
-  size_t manifest_size = 0;
-  uint64_t start, stop;
-  int rc = HIO_SUCCESS;
-  char *path = NULL;
+  pd_data = builtin_posix_autotune_data (posix_dataset);
+  if (NULL == pd_data || 0 == bytes || 0 == wtime) {
+    return;
+  }
 
-  start = hioi_gettime ();
+  /* write time is in microseconds */
+  bandwidth = (uint64_t) ((double) bytes * 1000000.0 / (double) wtime);
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "posix:dataset_open: opening dataset %s:%lu mpi: %d flags: 0x%x mode: 0x%x",
-	    hioi_object_identifier (dataset), (unsigned long) dataset->ds_id, hioi_context_using_mpi (context),
-            dataset->ds_flags, dataset->ds_mode);
+  point = builtin_posix_autotune_find (pd_data, &posix_dataset->ds_tune);
+  if (NULL == point) {
+    if (pd_data->pd_count < HIO_POSIX_TUNE_HISTORY) {
+      point = pd_data->pd_points + pd_data->pd_count++;
+    } else {
+      /* forget the slowest configuration */
+      point = pd_data->pd_points;
+      for (int i = 1 ; i < pd_data->pd_count ; ++i) {
+        if (pd_data->pd_points[i].tp_bandwidth < point->tp_bandwidth) {
+          point = pd_data->pd_points + i;
+        }
+      }
+    }
 
-  rc = builtin_posix_module_dataset_init (module, posix_dataset);
-  if (HIO_SUCCESS != rc) {
-    return rc;
+    *point = posix_dataset->ds_tune;
+    point->tp_bandwidth = bandwidth;
+    point->tp_samples = 1;
+  } else {
+    /* same weighting as the dataset average write time */
+    point->tp_bandwidth = (uint64_t) ((double) point->tp_bandwidth * 0.8 + (double) bandwidth * 0.2);
+    ++point->tp_samples;
   }
 
-  rc = builtin_posix_module_setup_striping (context, module, dataset);
-  if (HIO_SUCCESS != rc) {
-    return rc;
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:autotune: dataset %s achieved %" PRIu64 " B/s (predicted %"
+            PRIu64 " B/s)", hioi_object_identifier (dataset), bandwidth, posix_dataset->ds_tune_predicted);
+
+  if (posix_dataset->ds_autotune_persist) {
+    builtin_posix_autotune_save (posix_dataset, pd_data);
   }
+}
 
-  if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) {
-    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_fcount,
-                     "dataset_file_count", HIO_CONFIG_TYPE_UINT64, NULL, "Number of files to use "
-                     "in strided file mode", 0);
-  } else if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
-    posix_dataset->ds_use_bzip = true;
-    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_use_bzip,
-                     "dataset_use_bzip", HIO_CONFIG_TYPE_BOOL, NULL,
-                     "Use bzip2 compression for dataset manifests", 0);
+/**
+ * Rank of this process among the processes sharing a node data file
+ */
+static int builtin_posix_node_rank (hio_context_t context) {
+#if HIO_MPI_HAVE(3)
+  if (MPI_COMM_NULL != context->c_shared_comm) {
+    return context->c_shared_rank;
   }
+#endif
 
-  if (dataset->ds_flags & HIO_FLAG_TRUNC) {
-    /* blow away the existing dataset */
-    if (0 == context->c_rank) {
-      (void) builtin_posix_module_dataset_unlink (module, hioi_object_identifier(dataset),
-                                                  dataset->ds_id);
-    }
+  /* without a shared communicator optimized mode is only used on a single node */
+  return context->c_rank;
+}
+
+/**
+ * Index of the node whose data file is coordinated by rank master
+ *
+ * This function is collective over the context when a shared communicator is in use.
+ */
+static int builtin_posix_node_index (hio_context_t context, int master) {
+#if HIO_MPI_HAVE(3)
+  if (MPI_COMM_NULL == context->c_shared_comm || HIO_SUCCESS != hioi_context_generate_leader_list (context)) {
+    return 0;
   }
 
-  if (!(dataset->ds_flags & HIO_FLAG_CREAT)) {
-    if (0 == context->c_rank) {
-      /* load manifest. the manifest data will be shared with other processes in hioi_dataset_scatter */
-      rc = asprintf (&path, "%s/manifest.json", posix_dataset->base_path);
-      assert (0 < rc);
-      if (access (path, F_OK)) {
-        /* this should never happen on a valid dataset */
-        free (path);
-        hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: could not find top-level manifest %s", path);
-        rc = HIO_ERR_NOT_FOUND;
-      } else {
-        rc = HIO_SUCCESS;
-      }
+  for (int i = 0 ; i < context->c_node_count ; ++i) {
+    if (master == context->c_node_leaders[i]) {
+      return i;
     }
+  }
+#endif
 
-    /* read the manifest if it exists */
-    if (HIO_SUCCESS == rc) {
-      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: loading manifest header from %s...", path);
-      rc = hioi_manifest_read (path, &manifest, &manifest_size);
-      free (path);
-      path = NULL;
+  return 0;
+}
+
+/**
+ * Assign each rank on a node its own stripe of the node data file
+ *
+ * Blocks are made exactly one stripe wide so block i of the file lands on stripe
+ * i % stripe count. A rank only reserves blocks on its own stripe. When there are more
+ * ranks than stripes the ranks sharing a stripe take turns through the per-stripe index
+ * in the shared control block.
+ */
+static int builtin_posix_setup_stripe_exclusivity (hio_context_t context, builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  hio_fs_attr_t *fs_attr = &dataset->ds_fsattr;
+  uint64_t ssize;
+
+  posix_dataset->ds_stripe_exclusive = true;
+  hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_stripe_exclusive, "dataset_stripe_exclusive",
+                   HIO_CONFIG_TYPE_BOOL, NULL, "Give each rank on a node its own stripe of the node data file "
+                   "in optimized mode (default: true)", 0);
+  if (!posix_dataset->ds_stripe_exclusive) {
+    return HIO_SUCCESS;
+  }
+
+  if (hioi_config_is_set (&dataset->ds_object, "stripe_size")) {
+    /* an explicit stripe size (already rounded to the stripe unit) wins. a block must cover
+     * exactly one stripe */
+    ssize = fs_attr->fs_ssize;
+    if (posix_dataset->ds_bs != ssize && hioi_config_is_set (&dataset->ds_object, "dataset_block_size")) {
+      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: block size %" PRIu64 " conflicts with stripe size %"
+                PRIu64 ". using a block size of %" PRIu64 " to keep stripes exclusive", (uint64_t) posix_dataset->ds_bs,
+                ssize, ssize);
     }
-  } else if (0 == context->c_rank) {
-    rc = builtin_posix_create_dataset_dirs (posix_module, posix_dataset);
-    if (HIO_SUCCESS == rc) {
-      /* serialize the manifest to send to remote ranks */
-      rc = hioi_manifest_serialize (dataset, &manifest, &manifest_size, false, false);
+  } else {
+    /* a block must cover exactly one stripe. keep the block size if possible */
+    ssize = fs_attr->fs_sunit * ((posix_dataset->ds_bs + fs_attr->fs_sunit - 1) / fs_attr->fs_sunit);
+    if (ssize > fs_attr->fs_smax_size) {
+      ssize = fs_attr->fs_smax_size;
     }
   }
 
-#if HIO_MPI_HAVE(1)
-  /* share dataset header will all processes in the communication domain */
-  rc = hioi_dataset_scatter_comm (dataset, context->c_comm, manifest, manifest_size, rc);
-#endif
-  free (manifest);
+  fs_attr->fs_ssize = posix_dataset->ds_bs = ssize;
+  posix_dataset->ds_stripe_count = fs_attr->fs_scount;
+  posix_dataset->my_stripe = builtin_posix_node_rank (context) % posix_dataset->ds_stripe_count;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "posix:dataset_open: using stripe %d of %d. stripe size: %" PRIu64,
+            posix_dataset->my_stripe, posix_dataset->ds_stripe_count, ssize);
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_posix_module_setup_striping (hio_context_t context, struct hio_module_t *module, hio_dataset_t dataset) {
+  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
+  hio_fs_attr_t *fs_attr = &dataset->ds_fsattr;
+  int rc;
+
+  /* query the filesystem for current striping parameters */
+  rc = hioi_fs_query (context, module->data_root, fs_attr);
   if (HIO_SUCCESS != rc) {
-    free (posix_dataset->base_path);
+    hioi_err_push (rc, &context->c_object, "posix: error querying the filesystem");
     return rc;
   }
 
-  if (context->c_enable_tracing) {
-    char *path;
+  posix_dataset->my_stripe = 0;
+  posix_dataset->ds_stripe_count = 1;
+
+  posix_dataset->ds_simulate_stripes = 0;
+  hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_simulate_stripes,
+                   "dataset_simulate_stripes", HIO_CONFIG_TYPE_UINT32, NULL, "Number of stripes to "
+                   "simulate on filesystems without striping support. Block placement is verified "
+                   "when the dataset is closed. Intended for testing (default: 0)", 0);
+
+  if (posix_dataset->ds_simulate_stripes && !(fs_attr->fs_flags & HIO_FS_SUPPORTS_STRIPING)) {
+    fs_attr->fs_flags |= HIO_FS_SUPPORTS_STRIPING;
+    fs_attr->fs_smax_count = posix_dataset->ds_simulate_stripes;
+    fs_attr->fs_sunit = fs_attr->fs_bsize ? fs_attr->fs_bsize : 4096;
+    fs_attr->fs_smax_size = 1ul << 32;
+  } else {
+    posix_dataset->ds_simulate_stripes = 0;
+  }
 
-    rc = asprintf (&path, "%s/trace/trace.%d", posix_dataset->base_path, context->c_rank);
-    if (rc > 0) {
-      posix_dataset->ds_trace_fh = fopen (path, "a");
-      free (path);
-    }
+  /* set default stripe count */
+  fs_attr->fs_scount = 1;
 
-    builtin_posix_trace (posix_dataset, "trace_begin", 0, 0, 0, 0);
-  }
+  posix_dataset->ds_fcount = 1;
+
+  if (fs_attr->fs_flags & HIO_FS_SUPPORTS_STRIPING) {
+    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+      /* pick a reasonable default stripe size */
+      fs_attr->fs_ssize = 1 << 24;
+
+      /* use group locking if available as we guarantee stripe exclusivity in optimized mode */
+      fs_attr->fs_use_group_locking = true;
 
 #if HIO_MPI_HAVE(3)
-  if (!(dataset->ds_flags & HIO_FLAG_CREAT) && HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
-    rc = bultin_posix_scatter_data (posix_dataset);
-    if (HIO_SUCCESS != rc) {
-      free (posix_dataset->base_path);
-      return rc;
+      /* if group locking is not available then each rank should attempt to write to
+       * a different stripe to maximize the available IO bandwidth */
+      fs_attr->fs_scount = min(context->c_shared_size, fs_attr->fs_smax_count);
+#endif
+    } else if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) {
+      /* pick a reasonable default stripe size */
+      fs_attr->fs_ssize = posix_dataset->ds_bs;
+
+      posix_dataset->ds_fcount = fs_attr->fs_smax_count * 32;
+      fs_attr->fs_scount = 16;
+      if (context->c_size < posix_dataset->ds_fcount) {
+        posix_dataset->ds_fcount = context->c_size;
+      }
+    } else if (HIO_SET_ELEMENT_UNIQUE != dataset->ds_mode) {
+      /* set defaults striping count */
+      fs_attr->fs_ssize = 1 << 20;
+      fs_attr->fs_scount = max (1, (unsigned) ((float) fs_attr->fs_smax_count * 0.9));
+    } else {
+      fs_attr->fs_ssize = 1 << 20;
     }
   }
 
-  /* if possible set up a shared memory window for this dataset */
-  POSIX_TRACE_CALL(posix_dataset, hioi_dataset_shared_init (dataset, 1), "shared_init", 0, 0);
+  /* replace the heuristic defaults with values learned from earlier instances of this dataset */
+  builtin_posix_autotune_select (posix_dataset);
 
-  if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
-    if (2 > context->c_size || NULL == dataset->ds_shared_control) {
-      /* no point in using optimized mode in this case */
-      posix_dataset->ds_fmode = HIO_FILE_MODE_BASIC;
-      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: optimized file mode requested but not supported in this "
-                "dataset mode. falling back to basic file mode, path: %s", posix_dataset->base_path);
-    } else if (HIO_SET_ELEMENT_SHARED == dataset->ds_mode) {
-      POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_generate_map (dataset), "generate_map", 0, 0);
+  if (fs_attr->fs_flags & HIO_FS_SUPPORTS_STRIPING) {
+    hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_scount,
+                     "stripe_count", HIO_CONFIG_TYPE_UINT32, NULL, "Stripe count for all dataset "
+                     "data files", 0);
+
+    hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_ssize,
+                     "stripe_size", HIO_CONFIG_TYPE_UINT64, NULL, "Stripe size for all dataset "
+                     "data files", 0);
+
+    if (fs_attr->fs_flags & HIO_FS_SUPPORTS_RAID) {
+      hioi_config_add (context, &dataset->ds_object, &fs_attr->fs_raid_level,
+                       "raid_level", HIO_CONFIG_TYPE_UINT64, NULL, "RAID level for dataset "
+                       "data files. Keep in mind that some filesystems only support 1/2 RAID "
+                       "levels", 0);
+    }
+
+    /* ensure stripe count is sane */
+    if (fs_attr->fs_scount > fs_attr->fs_smax_count) {
+      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: requested stripe count %u exceeds the available resources. "
+                "adjusting to maximum %u", fs_attr->fs_scount, fs_attr->fs_smax_count);
+      fs_attr->fs_scount = fs_attr->fs_smax_count;
+    }
+
+    /* ensure the stripe size is a multiple of the stripe unit */
+    fs_attr->fs_ssize = fs_attr->fs_sunit * ((fs_attr->fs_ssize + fs_attr->fs_sunit - 1) / fs_attr->fs_sunit);
+    if (fs_attr->fs_ssize > fs_attr->fs_smax_size) {
+      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: requested stripe size %" PRIu64 " exceeds the maximum %"
+                PRIu64 ". ", fs_attr->fs_ssize, fs_attr->fs_smax_size);
+      fs_attr->fs_ssize = fs_attr->fs_smax_size;
+    }
+
+    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode && posix_dataset->ds_bs < fs_attr->fs_ssize) {
+      posix_dataset->ds_bs = fs_attr->fs_ssize;
+    }
+
+    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode && 1 < fs_attr->fs_scount) {
+      rc = builtin_posix_setup_stripe_exclusivity (context, posix_dataset);
       if (HIO_SUCCESS != rc) {
-        free (posix_dataset->base_path);
         return rc;
       }
     }
   }
 
-  /* NTH: if requested more code is needed to load an optimized dataset with an older MPI */
-#endif /* HIO_MPI_HAVE(3) */
+  /* remember the values actually in use after configuration and sanity checks */
+  posix_dataset->ds_tune = (builtin_posix_tune_point_t) {.tp_ssize = fs_attr->fs_ssize, .tp_scount = fs_attr->fs_scount,
+                                                         .tp_bs = posix_dataset->ds_bs,
+                                                         .tp_buffer_size = dataset->ds_buffer_size};
 
-  dataset->ds_module = module;
-  dataset->ds_close = builtin_posix_module_dataset_close;
-  dataset->ds_element_open = builtin_posix_module_element_open;
-  dataset->ds_process_reqs = builtin_posix_module_process_reqs;
+  return HIO_SUCCESS;
+}
 
-  /* record the open time */
-  gettimeofday (&dataset->ds_otime, NULL);
+static int builtin_posix_module_dataset_read_data_manifest (builtin_posix_module_dataset_t *posix_dataset, int manifest_id,
+                                                            unsigned char **manifest, size_t *manifest_size) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  char *path;
+  int rc;
 
-  stop = hioi_gettime ();
+  *manifest = NULL;
+  *manifest_size = 0;
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: successfully %s posix dataset "
-            "%s:%" PRIu64 " on data root %s. open time %" PRIu64 " usec",
-            (dataset->ds_flags & HIO_FLAG_CREAT) ? "created" : "opened", hioi_object_identifier(dataset),
-            dataset->ds_id, module->data_root, stop - start);
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: reading manifest data from id %x\n",
+            manifest_id);
 
-  builtin_posix_trace (posix_dataset, "open", 0, 0, start, stop);
+  /* when writing the manifest in optimized mode each IO manager writes its own manifest. try
+   * to open the manifest. if a manifest does not exist then it is likely this rank did not
+   * write a manifest. */
+  rc = asprintf (&path, "%s/manifest.%x.json.bz2", posix_dataset->base_path, manifest_id);
+  assert (0 < rc);
 
-  return HIO_SUCCESS;
+  if (access (path, F_OK)) {
+    free (path);
+    /* Check for a non-bzip'd manifest file. */
+    rc = asprintf (&path, "%s/manifest.%x.json", posix_dataset->base_path, manifest_id);
+    assert (0 < rc);
+    if (access (path, F_OK)) {
+      /* no manifest found. this might be a non-optimized file format or this rank may not be an
+       * IO master rank. */
+      free (path);
+      return HIO_SUCCESS;
+    }
+  }
+
+  rc = hioi_manifest_read (path, manifest, manifest_size);
+  free (path);
+
+  return rc;
 }
 
-static int builtin_posix_module_dataset_close (hio_dataset_t dataset) {
-  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
-  hio_context_t context = hioi_object_context ((hio_object_t) dataset);
-  hio_module_t *module = dataset->ds_module;
-  unsigned char *manifest = NULL;
-  uint64_t start, stop;
-  int rc = HIO_SUCCESS;
+/**
+ * Read all data manifests in the dataset directly
+ *
+ * Used when there is no MPI-3 shared memory communicator (serial tools or single-node jobs
+ * with an older MPI). Every process parses every data manifest so the full segment list of
+ * each element is available locally and no distributed map is needed. In unique mode
+ * manifest parsing only keeps the elements that belong to this rank.
+ */
+static int builtin_posix_module_dataset_read_local (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  hio_dataset_t dataset = &posix_dataset->base;
+  int *manifest_ids = NULL, manifest_id_count = 0, status, rc = HIO_SUCCESS;
+  unsigned int manifest_id;
   size_t manifest_size;
+  unsigned char *manifest;
+  struct dirent *dp;
+  DIR *dir;
+
+  dir = opendir (posix_dataset->base_path);
+  if (NULL == dir) {
+    return hioi_err_errno (errno);
+  }
+
+  while (NULL != (dp = readdir (dir))) {
+    if ('.' == dp->d_name[0] || 1 != sscanf (dp->d_name, "manifest.%x.json", &manifest_id)) {
+      continue;
+    }
+
+    if (0 == (manifest_id_count & 31)) {
+      int *tmp = realloc (manifest_ids, (manifest_id_count + 32) * sizeof (*manifest_ids));
+      if (NULL == tmp) {
+        rc = HIO_ERR_OUT_OF_RESOURCE;
+        break;
+      }
+
+      manifest_ids = tmp;
+    }
+
+    manifest_ids[manifest_id_count++] = (int) manifest_id;
+  }
+
+  closedir (dir);
+
+  /* the data manifests carry the status at the time they were written. the status in
+   * the top-level manifest is authoritative */
+  status = dataset->ds_status;
+
+  if (HIO_SUCCESS == rc && manifest_id_count) {
+    qsort (manifest_ids, manifest_id_count, sizeof (int), manifest_index_compare);
+  }
+
+  for (int i = 0 ; HIO_SUCCESS == rc && i < manifest_id_count ; ++i) {
+    if (i && manifest_ids[i] == manifest_ids[i - 1]) {
+      /* already read (compressed and uncompressed manifest with the same id) */
+      continue;
+    }
+
+    rc = builtin_posix_module_dataset_read_data_manifest (posix_dataset, manifest_ids[i], &manifest, &manifest_size);
+    if (HIO_SUCCESS == rc && NULL != manifest) {
+      rc = hioi_manifest_deserialize (dataset, manifest, manifest_size);
+      free (manifest);
+    }
+
+    if (HIO_SUCCESS != rc) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: failed to read manifest data from id %x. rc: %d",
+                manifest_ids[i], rc);
+    }
+  }
+
+  dataset->ds_status = status;
+  free (manifest_ids);
+
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    (void) MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_comm);
+  }
+#endif
+
+  return rc;
+}
+
+#if HIO_MPI_HAVE(3)
+
+/**
+ * Read the data manifests assigned to this node
+ *
+ * The node leader receives the list of manifest ids assigned to this node and shares it
+ * with all ranks on the node. Each rank then reads, decompresses, and parses a disjoint
+ * subset of the manifests directly into its dataset. The parsed element data is merged
+ * once with hioi_dataset_gather_elements(). When the dataset is read-only the merged
+ * segment arrays are kept in a single shared memory table on each node.
+ */
+static int builtin_posix_module_dataset_read_shared (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  hio_dataset_t dataset = &posix_dataset->base;
+  size_t manifest_id_count = 0, manifest_size;
+  int *manifest_ids = NULL, rc, mpirc, status;
+  unsigned char *manifest;
+  long ar_data[5];
+
+  rc = builtin_posix_module_dataset_manifest_list (posix_dataset, &manifest_ids, &manifest_id_count);
+
+  /* distribute the manifest list and the dataset configuration determined by the node leader */
+  ar_data[0] = rc;
+  ar_data[1] = (long) manifest_id_count;
+  ar_data[2] = dataset->ds_flags;
+  ar_data[3] = dataset->ds_fsattr.fs_scount;
+  ar_data[4] = dataset->ds_fsattr.fs_ssize;
+
+  mpirc = MPI_Bcast (ar_data, 5, MPI_LONG, 0, context->c_shared_comm);
+  if (MPI_SUCCESS != mpirc) {
+    free (manifest_ids);
+    return hioi_err_mpi (mpirc);
+  }
+
+  if (HIO_SUCCESS != ar_data[0]) {
+    free (manifest_ids);
+    return (int) ar_data[0];
+  }
+
+  dataset->ds_flags = ar_data[2];
+  dataset->ds_fsattr.fs_scount = ar_data[3];
+  dataset->ds_fsattr.fs_ssize = ar_data[4];
+
+  manifest_id_count = (size_t) ar_data[1];
+  if (0 == manifest_id_count) {
+    return HIO_SUCCESS;
+  }
+
+  if (0 != context->c_shared_rank) {
+    manifest_ids = malloc (manifest_id_count * sizeof (*manifest_ids));
+    assert (NULL != manifest_ids);
+  }
+
+  mpirc = MPI_Bcast (manifest_ids, manifest_id_count, MPI_INT, 0, context->c_shared_comm);
+  if (MPI_SUCCESS != mpirc) {
+    free (manifest_ids);
+    return hioi_err_mpi (mpirc);
+  }
+
+  /* the data manifests carry the status at the time they were written. the status in
+   * the top-level manifest is authoritative */
+  status = dataset->ds_status;
+
+  for (size_t i = context->c_shared_rank ; i < manifest_id_count ; i += context->c_shared_size) {
+    if (-1 == manifest_ids[i]) {
+      /* nothing more to do */
+      break;
+    }
+
+    rc = builtin_posix_module_dataset_read_data_manifest (posix_dataset, manifest_ids[i], &manifest, &manifest_size);
+    if (HIO_SUCCESS == rc && NULL != manifest) {
+      rc = hioi_manifest_deserialize (dataset, manifest, manifest_size);
+      free (manifest);
+    }
+
+    if (HIO_SUCCESS != rc) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: failed to read manifest data from id %x. rc: %d",
+                manifest_ids[i], rc);
+      break;
+    }
+  }
+
+  dataset->ds_status = status;
+  free (manifest_ids);
+
+  mpirc = MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_shared_comm);
+  if (MPI_SUCCESS != mpirc) {
+    return hioi_err_mpi (mpirc);
+  }
+
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  if (!(dataset->ds_flags & HIO_FLAG_WRITE)) {
+    /* merge on the node leader and share the result read-only */
+    rc = hioi_dataset_gather_elements (dataset, context->c_shared_comm, 0);
+    if (HIO_SUCCESS == rc) {
+      rc = hioi_dataset_shared_segments_init (dataset);
+    }
+
+    if (HIO_ERR_NOT_AVAILABLE != rc) {
+      return rc;
+    }
+
+    /* the leader contributes the merged data. duplicates are removed by compaction */
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: shared segment table not available. "
+              "falling back on per-rank segment arrays, path: %s", posix_dataset->base_path);
+  }
+
+  return hioi_dataset_gather_elements (dataset, context->c_shared_comm, -1);
+}
+
+static int bultin_posix_scatter_data (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  size_t manifest_size = 0;
+  unsigned char *manifest = NULL;
+  int rc;
+
+  if (HIO_SET_ELEMENT_UNIQUE != posix_dataset->base.ds_mode) {
+    return builtin_posix_module_dataset_read_shared (posix_dataset);
+  }
+
+  /* only read the manifest this rank wrote */
+  rc = builtin_posix_module_dataset_read_data_manifest (posix_dataset, context->c_rank, &manifest, &manifest_size);
+
+  /* share dataset information with all processes on this node */
+  rc = hioi_dataset_scatter_unique (&posix_dataset->base, manifest, manifest_size, rc);
+
+  free (manifest);
+
+  return rc;
+}
+#endif
+
+/**
+ * Load the data manifests of an optimized dataset
+ */
+static int builtin_posix_module_dataset_load_data (builtin_posix_module_dataset_t *posix_dataset) {
+#if HIO_MPI_HAVE(3)
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+
+  if (MPI_COMM_NULL != context->c_shared_comm) {
+    return bultin_posix_scatter_data (posix_dataset);
+  }
+#endif
+
+  return builtin_posix_module_dataset_read_local (posix_dataset);
+}
+
+/**
+ * Load the segment table of this rank's container file
+ *
+ * In packed mode each rank wrote a data manifest describing only its own elements so no
+ * coordination with other ranks is needed.
+ */
+static int builtin_posix_module_dataset_load_packed (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  hio_dataset_t dataset = &posix_dataset->base;
+  unsigned char *manifest = NULL;
+  size_t manifest_size;
+  int rc, status;
+
+  rc = builtin_posix_module_dataset_read_data_manifest (posix_dataset, context->c_rank, &manifest, &manifest_size);
+  if (HIO_SUCCESS != rc || NULL == manifest) {
+    /* this rank did not write any data */
+    return rc;
+  }
+
+  /* the status in the top-level manifest is authoritative */
+  status = dataset->ds_status;
+  rc = hioi_manifest_deserialize (dataset, manifest, manifest_size);
+  dataset->ds_status = status;
+  free (manifest);
+
+  return rc;
+}
+
+/**
+ * Serialize the data manifest describing how data landed in the optimized or packed mode data files
+ *
+ * In optimized mode with MPI-3 the data of all ranks on a node is gathered on the node leader.
+ * Otherwise each process describes its own data.
+ */
+static int builtin_posix_module_dataset_data_manifest (builtin_posix_module_dataset_t *posix_dataset,
+                                                       unsigned char **manifest, size_t *manifest_size) {
+  hio_dataset_t dataset = &posix_dataset->base;
+#if HIO_MPI_HAVE(3)
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+
+  if (MPI_COMM_NULL != context->c_shared_comm && HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+    return hioi_dataset_gather_manifest_comm (dataset, context->c_shared_comm, manifest, manifest_size,
+                                              posix_dataset->ds_use_bzip, false);
+  }
+#endif
+
+  hioi_dataset_compact_segments (dataset);
+
+  return hioi_manifest_serialize (dataset, manifest, manifest_size, posix_dataset->ds_use_bzip, false);
+}
+
+#if HIO_MPI_HAVE(1)
+static int builtin_posix_module_dataset_shard_comm (builtin_posix_module_dataset_t *posix_dataset, MPI_Comm *shard_comm,
+                                                    int *shard_index) {
+  hio_context_t context = hioi_object_context ((hio_object_t) posix_dataset);
+  int rc;
+
+  *shard_index = context->c_rank / posix_dataset->base.ds_mshard_size;
+
+  rc = MPI_Comm_split (context->c_comm, *shard_index, context->c_rank, shard_comm);
+  if (MPI_SUCCESS != rc) {
+    return hioi_err_mpi (rc);
+  }
+
+  return HIO_SUCCESS;
+}
+
+/**
+ * Save the dataset manifest as a set of shards
+ *
+ * Every group of ds_mshard_size ranks reduces its manifest to the lowest rank in the group
+ * which writes it to manifest.shard.<index>.json. Rank 0 writes a header-only manifest.json
+ * that acts as the index of the shards.
+ */
+static int builtin_posix_module_dataset_save_shards (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  /* optimized and packed modes store the segment data in the data manifests */
+  bool simple = HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode || HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode;
+  unsigned char *manifest = NULL;
+  int rc, shard_index, shard_rank;
+  size_t manifest_size = 0;
+  MPI_Comm shard_comm;
+  char *path;
+
+  rc = builtin_posix_module_dataset_shard_comm (posix_dataset, &shard_comm, &shard_index);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  MPI_Comm_rank (shard_comm, &shard_rank);
+
+  rc = hioi_dataset_gather_manifest_comm (dataset, shard_comm, &manifest, &manifest_size,
+                                          posix_dataset->ds_use_bzip, simple);
+  MPI_Comm_free (&shard_comm);
+  if (HIO_SUCCESS != rc) {
+    dataset->ds_status = rc;
+  }
+
+  if (0 == shard_rank && NULL != manifest) {
+    rc = asprintf (&path, "%s/manifest.shard.%x.json%s", posix_dataset->base_path, shard_index,
+                   posix_dataset->ds_use_bzip ? ".bz2" : "");
+    if (0 > rc) {
+      free (manifest);
+      return hioi_err_errno (errno);
+    }
+
+    rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
+    free (path);
+    if (HIO_SUCCESS != rc) {
+      hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest shard");
+    }
+  }
+
+  free (manifest);
+  manifest = NULL;
+
+  /* the index carries the status of the entire dataset */
+  if (0 == context->c_rank) {
+    MPI_Reduce (MPI_IN_PLACE, &dataset->ds_status, 1, MPI_INT, MPI_MIN, 0, context->c_comm);
+  } else {
+    MPI_Reduce (&dataset->ds_status, NULL, 1, MPI_INT, MPI_MIN, 0, context->c_comm);
+    return rc;
+  }
+
+  rc = hioi_manifest_serialize (dataset, &manifest, &manifest_size, false, true);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  rc = asprintf (&path, "%s/manifest.json", posix_dataset->base_path);
+  if (0 > rc) {
+    free (manifest);
+    return hioi_err_errno (errno);
+  }
+
+  rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
+  free (manifest);
+  free (path);
+  if (HIO_SUCCESS != rc) {
+    hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest");
+  }
+
+  return rc;
+}
+
+/**
+ * Load the manifest shard covering this rank
+ *
+ * The lowest rank in each shard group reads the shard and distributes it to the other
+ * ranks in the group. Must be called after the index (manifest.json) has been scattered.
+ */
+static int builtin_posix_module_dataset_load_shards (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  int rc = HIO_SUCCESS, shard_index, shard_rank, status;
+  unsigned char *manifest = NULL;
+  size_t manifest_size = 0;
+  MPI_Comm shard_comm;
+  char *path;
+
+  rc = builtin_posix_module_dataset_shard_comm (posix_dataset, &shard_comm, &shard_index);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  MPI_Comm_rank (shard_comm, &shard_rank);
+
+  if (0 == shard_rank) {
+    rc = asprintf (&path, "%s/manifest.shard.%x.json.bz2", posix_dataset->base_path, shard_index);
+    assert (0 < rc);
+
+    if (access (path, F_OK)) {
+      free (path);
+      rc = asprintf (&path, "%s/manifest.shard.%x.json", posix_dataset->base_path, shard_index);
+      assert (0 < rc);
+    }
+
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: loading manifest shard from %s...", path);
+
+    rc = hioi_manifest_read (path, &manifest, &manifest_size);
+    free (path);
+  }
+
+  /* the status stored in the index takes precedence over the status stored in the shard */
+  status = dataset->ds_status;
+
+  rc = hioi_dataset_scatter_comm (dataset, shard_comm, manifest, manifest_size, rc);
+  MPI_Comm_free (&shard_comm);
+  free (manifest);
+
+  dataset->ds_status = status;
+
+  /* a shard that could not be read fails the open on every rank */
+  MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_comm);
+
+  return rc;
+}
+#endif /* HIO_MPI_HAVE(1) */
+
+static int builtin_posix_module_dataset_open (struct hio_module_t *module, hio_dataset_t dataset) {
+  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
+  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) module;
+  hio_context_t context = hioi_object_context ((hio_object_t) dataset);
+  unsigned char *manifest = NULL;
+  size_t manifest_size = 0;
+  uint64_t start, stop;
+  int rc = HIO_SUCCESS;
+  char *path = NULL;
+
+  start = hioi_gettime ();
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "posix:dataset_open: opening dataset %s:%lu mpi: %d flags: 0x%x mode: 0x%x",
+	    hioi_object_identifier (dataset), (unsigned long) dataset->ds_id, hioi_context_using_mpi (context),
+            dataset->ds_flags, dataset->ds_mode);
+
+  rc = builtin_posix_module_dataset_init (module, posix_dataset);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  rc = builtin_posix_module_setup_striping (context, module, dataset);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) {
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_fcount,
+                     "dataset_file_count", HIO_CONFIG_TYPE_UINT64, NULL, "Number of files to use "
+                     "in strided file mode", 0);
+  } else if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode || HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode) {
+    posix_dataset->ds_use_bzip = true;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_use_bzip,
+                     "dataset_use_bzip", HIO_CONFIG_TYPE_BOOL, NULL,
+                     "Use bzip2 compression for dataset manifests", 0);
+  }
+
+  /* when reading the data roots come from the manifest */
+  free (dataset->ds_data_roots);
+  dataset->ds_data_roots = NULL;
+
+  /* when reading the data directory layout comes from the manifest */
+  dataset->ds_dir_shard_size = 0;
+  if ((dataset->ds_flags & HIO_FLAG_CREAT) && (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode ||
+                                               HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode ||
+                                               (HIO_FILE_MODE_BASIC == posix_dataset->ds_fmode &&
+                                                HIO_SET_ELEMENT_UNIQUE == dataset->ds_mode))) {
+    hioi_config_add (context, &dataset->ds_object, &dataset->ds_dir_shard_size,
+                     "dataset_dir_shard_size", HIO_CONFIG_TYPE_UINT32, NULL, "Split the data directory "
+                     "into subdirectories each holding the files of this many ranks (basic and packed "
+                     "modes) or file indices (strided mode). The layout is recorded in the manifest (default: 0 - "
+                     "single data directory)", 0);
+  }
+
+  if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+    posix_dataset->ds_root_spread = HIO_POSIX_ROOT_SPREAD_NONE;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_root_spread,
+                     "dataset_data_root_spread", HIO_CONFIG_TYPE_INT32, &hioi_dataset_root_spreads,
+                     "Spread the data files of new datasets over all posix data roots of the context "
+                     "in optimized mode. Valid values: (0: none, 1: node - one data root per node, "
+                     "2: block - rotate blocks over all data roots) (default: none)", 0);
+
+    if (!builtin_posix_is_posix_module (module)) {
+      /* modules wrapping posix (datawarp, stage) move the dataset directory as a whole */
+      posix_dataset->ds_root_spread = HIO_POSIX_ROOT_SPREAD_NONE;
+    }
+
+    if ((dataset->ds_flags & HIO_FLAG_CREAT) && HIO_POSIX_ROOT_SPREAD_NONE != posix_dataset->ds_root_spread) {
+      rc = builtin_posix_setup_data_roots (module, posix_dataset);
+      if (HIO_SUCCESS != rc) {
+        free (posix_dataset->base_path);
+        return rc;
+      }
+    }
+  }
+
+  posix_dataset->ds_root_count = builtin_posix_root_count (dataset->ds_data_roots);
+
+  dataset->ds_mshard_size = 0;
+  hioi_config_add (context, &dataset->ds_object, &dataset->ds_mshard_size,
+                   "dataset_manifest_shard_size", HIO_CONFIG_TYPE_INT32, NULL,
+                   "Number of ranks covered by each top-level manifest shard. If non-zero the manifest "
+                   "is written in shards and rank 0 only writes a shard index (default: 0)", 0);
+
+  if (HIO_SET_ELEMENT_SHARED == dataset->ds_mode && dataset->ds_mshard_size > 0) {
+    /* shared elements are merged over all ranks. a shard would only hold the sizes and segments
+     * written by its group */
+    hioi_log (context, HIO_VERBOSE_WARN, "posix: manifest sharding is not supported with shared elements. "
+              "writing a single manifest for dataset %s", hioi_object_identifier (dataset));
+    dataset->ds_mshard_size = 0;
+  }
+
+  posix_dataset->ds_keep_last = 0;
+  if (dataset->ds_flags & HIO_FLAG_WRITE) {
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_keep_last,
+                     "dataset_keep_last", HIO_CONFIG_TYPE_UINT32, NULL, "Number of instances of this "
+                     "dataset to keep in the data root. Instances with lower identifiers are unlinked "
+                     "after a successful close (default: 0 - keep all)", 0);
+
+    posix_dataset->ds_create_concurrency = 0;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_create_concurrency,
+                     "dataset_create_concurrency", HIO_CONFIG_TYPE_UINT32, NULL, "Maximum number of "
+                     "ranks per node creating element files at the same time in basic file mode with "
+                     "unique address spaces (default: 0 - no limit)", 0);
+
+    posix_dataset->ds_flush_threads = 4;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_flush_threads,
+                     "dataset_flush_threads", HIO_CONFIG_TYPE_UINT32, NULL, "Number of threads used to "
+                     "sync data files when the dataset is flushed to the backing store (default: 4)", 0);
+
+    posix_dataset->ds_syncfs_threshold = 16;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_syncfs_threshold,
+                     "dataset_syncfs_threshold", HIO_CONFIG_TYPE_UINT32, NULL, "Sync the data roots with a "
+                     "single syncfs per node instead of syncing each file when at least this many files "
+                     "are dirty on a posix-like file system (default: 16, 0: never use syncfs)", 0);
+
+    posix_dataset->ds_write_behind = 0;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_write_behind,
+                     "dataset_write_behind_size", HIO_CONFIG_TYPE_UINT64, NULL, "Start writing back the "
+                     "data of a file once this many bytes have been written to it. This reduces the work "
+                     "left to a complete flush (default: 0 - disabled)", 0);
+
+    posix_dataset->ds_drop_cache = false;
+    hioi_config_add (context, &dataset->ds_object, &posix_dataset->ds_drop_cache,
+                     "dataset_drop_cache", HIO_CONFIG_TYPE_BOOL, NULL, "Drop data files from the page "
+                     "cache after they have been synced (default: false)", 0);
+  }
+
+  if (dataset->ds_flags & HIO_FLAG_TRUNC) {
+    /* blow away the existing dataset */
+    if (0 == context->c_rank) {
+      (void) builtin_posix_module_dataset_unlink (module, hioi_object_identifier(dataset),
+                                                  dataset->ds_id);
+    }
+  }
+
+  if (!(dataset->ds_flags & HIO_FLAG_CREAT)) {
+    if (0 == context->c_rank) {
+      /* load manifest. the manifest data will be shared with other processes in hioi_dataset_scatter */
+      rc = asprintf (&path, "%s/manifest.json", posix_dataset->base_path);
+      assert (0 < rc);
+      if (access (path, F_OK)) {
+        /* this should never happen on a valid dataset */
+        free (path);
+        hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: could not find top-level manifest %s", path);
+        rc = HIO_ERR_NOT_FOUND;
+      } else {
+        rc = HIO_SUCCESS;
+      }
+    }
+
+    /* read the manifest if it exists */
+    if (HIO_SUCCESS == rc) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: loading manifest header from %s...", path);
+      rc = hioi_manifest_read (path, &manifest, &manifest_size);
+      free (path);
+      path = NULL;
+    }
+  } else if (0 == context->c_rank) {
+    rc = builtin_posix_create_dataset_dirs (posix_module, posix_dataset);
+    if (HIO_SUCCESS == rc) {
+      /* serialize the manifest to send to remote ranks */
+      rc = hioi_manifest_serialize (dataset, &manifest, &manifest_size, false, false);
+    }
+  }
+
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    /* share dataset header will all processes in the communication domain */
+    rc = hioi_dataset_scatter_comm (dataset, context->c_comm, manifest, manifest_size, rc);
+  } else
+#endif
+  if (HIO_SUCCESS == rc && !(dataset->ds_flags & HIO_FLAG_CREAT)) {
+    /* this process is the only reader of the manifest */
+    rc = hioi_manifest_deserialize (dataset, manifest, manifest_size);
+  }
+  free (manifest);
+  if (HIO_SUCCESS != rc) {
+    free (posix_dataset->base_path);
+    return rc;
+  }
+
+  posix_dataset->ds_root_count = builtin_posix_root_count (dataset->ds_data_roots);
+
+#if HIO_MPI_HAVE(1)
+  if (!(dataset->ds_flags & HIO_FLAG_CREAT) && dataset->ds_mshard_size > 0 && hioi_context_using_mpi (context)) {
+    /* the top-level manifest is an index. read the remainder of the manifest from the shards */
+    rc = builtin_posix_module_dataset_load_shards (posix_dataset);
+    if (HIO_SUCCESS != rc) {
+      free (posix_dataset->base_path);
+      return rc;
+    }
+  }
+#endif
+
+  if (context->c_enable_tracing) {
+    char *path;
+
+    rc = asprintf (&path, "%s/trace/trace.%d", posix_dataset->base_path, context->c_rank);
+    if (rc > 0) {
+      posix_dataset->ds_trace_fh = fopen (path, "a");
+      free (path);
+    }
+
+    builtin_posix_trace (posix_dataset, "trace_begin", 0, 0, 0, 0);
+  }
+
+  if (!(dataset->ds_flags & HIO_FLAG_CREAT) && HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+    rc = builtin_posix_module_dataset_load_data (posix_dataset);
+    if (HIO_SUCCESS != rc) {
+      free (posix_dataset->base_path);
+      return rc;
+    }
+  } else if (!(dataset->ds_flags & HIO_FLAG_CREAT) && HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode) {
+    rc = builtin_posix_module_dataset_load_packed (posix_dataset);
+    if (HIO_SUCCESS != rc) {
+      free (posix_dataset->base_path);
+      return rc;
+    }
+  }
+
+  /* if possible set up shared memory coordination for this dataset */
+  POSIX_TRACE_CALL(posix_dataset, hioi_dataset_shared_init (dataset, posix_dataset->ds_stripe_count *
+                                                            posix_dataset->ds_root_count), "shared_init", 0, 0);
+
+  if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
+    if (NULL == dataset->ds_shared_control) {
+      /* no point in using optimized mode in this case */
+      posix_dataset->ds_fmode = HIO_FILE_MODE_BASIC;
+      hioi_log (context, HIO_VERBOSE_WARN, "posix:dataset_open: optimized file mode requested but not supported in this "
+                "dataset mode. falling back to basic file mode, path: %s", posix_dataset->base_path);
+    } else if (1 < posix_dataset->ds_root_count) {
+      /* nodes (node spread) or the ranks on a node (block spread) start on different data roots */
+      if (HIO_POSIX_ROOT_SPREAD_NODE == posix_dataset->ds_root_spread) {
+        posix_dataset->ds_next_root = builtin_posix_node_index (context, dataset->ds_shared_control->s_master);
+      } else {
+        posix_dataset->ds_next_root = builtin_posix_node_rank (context);
+      }
+      posix_dataset->ds_next_root %= posix_dataset->ds_root_count;
+    }
+  }
+
+#if HIO_MPI_HAVE(3)
+  /* processes without a shared communicator hold the full segment list locally */
+  if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode && HIO_SET_ELEMENT_SHARED == dataset->ds_mode &&
+      MPI_COMM_NULL != context->c_shared_comm) {
+    POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_generate_map (dataset), "generate_map", 0, 0);
+    if (HIO_SUCCESS != rc) {
+      free (posix_dataset->base_path);
+      return rc;
+    }
+  }
+#endif
+
+  dataset->ds_module = module;
+  dataset->ds_close = builtin_posix_module_dataset_close;
+  dataset->ds_element_open = builtin_posix_module_element_open;
+  dataset->ds_process_reqs = builtin_posix_module_process_reqs;
+  dataset->ds_flush = builtin_posix_module_dataset_flush;
+  /* basic mode manifests do not list elements. each element is its own data file */
+  dataset->ds_elements_by_name = HIO_FILE_MODE_BASIC == posix_dataset->ds_fmode;
+
+  /* record the open time */
+  gettimeofday (&dataset->ds_otime, NULL);
+
+  stop = hioi_gettime ();
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: successfully %s posix dataset "
+            "%s:%" PRIu64 " on data root %s. open time %" PRIu64 " usec",
+            (dataset->ds_flags & HIO_FLAG_CREAT) ? "created" : "opened", hioi_object_identifier(dataset),
+            dataset->ds_id, module->data_root, stop - start);
+
+  builtin_posix_trace (posix_dataset, "open", 0, 0, start, stop);
+
+  return HIO_SUCCESS;
+}
+
+/**
+ * Verify that every block written by this rank landed on its own stripe
+ *
+ * Only used with simulated stripes. Before the manifest is gathered each rank's
+ * elements only hold the segments written by that rank.
+ */
+static int builtin_posix_check_placement (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  uint64_t block_size = posix_dataset->ds_bs;
+  hio_element_t element;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    for (size_t i = 0 ; i < element->e_scount ; ++i) {
+      hio_manifest_segment_t *segment = element->e_sarray + i;
+      uint64_t first = segment->seg_foffset / block_size;
+      uint64_t last = (segment->seg_foffset + segment->seg_length - 1) / block_size;
+
+      for (uint64_t block = first ; block <= last ; ++block) {
+        if ((int) (block % posix_dataset->ds_stripe_count) != posix_dataset->my_stripe) {
+          hioi_err_push (HIO_ERROR, &dataset->ds_object, "posix: block %" PRIu64 " of element %s is on stripe %d. "
+                         "expected stripe %d", block, hioi_object_identifier (element),
+                         (int) (block % posix_dataset->ds_stripe_count), posix_dataset->my_stripe);
+          return HIO_ERROR;
+        }
+      }
+    }
+  }
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_posix_module_dataset_close (hio_dataset_t dataset) {
+  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
+  hio_context_t context = hioi_object_context ((hio_object_t) dataset);
+  hio_module_t *module = dataset->ds_module;
+  unsigned char *manifest = NULL;
+  uint64_t start, stop;
+  int rc = HIO_SUCCESS, placement_rc = HIO_SUCCESS;
+  size_t manifest_size;
+
+  start = hioi_gettime ();
+
+  if (posix_dataset->ds_files) {
+    for (size_t i = 0 ; i < posix_dataset->ds_max_open_files ; ++i) {
+      hio_file_t *file = &posix_dataset->ds_files[i].pf_file;
+      if (file->f_bid >= 0) {
+        POSIX_TRACE_CALL(posix_dataset, hioi_file_close (file), "file_close", file->f_bid, 0);
+      }
+    }
+
+    free (posix_dataset->ds_files);
+    posix_dataset->ds_files = NULL;
+  }
+
+  for (int i = 0 ; i < HIO_MAX_DATA_ROOTS ; ++i) {
+    if (0 <= posix_dataset->ds_data_dirfd[i]) {
+      close (posix_dataset->ds_data_dirfd[i]);
+      posix_dataset->ds_data_dirfd[i] = -1;
+    }
+  }
+
+  /* release the shared state if it was allocated */
+  (void) hioi_dataset_shared_fini (dataset);
+
+#if HIO_MPI_HAVE(3)
+  /* release the dataset map if one was allocated */
+  (void) hioi_dataset_map_release (dataset);
+#endif
+
+
+  if ((dataset->ds_flags & HIO_FLAG_WRITE) && posix_dataset->ds_simulate_stripes &&
+      HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode && 1 < posix_dataset->ds_stripe_count) {
+    placement_rc = builtin_posix_check_placement (posix_dataset);
+    if (HIO_SUCCESS != placement_rc) {
+      dataset->ds_status = placement_rc;
+    }
+  }
+
+  if (dataset->ds_flags & HIO_FLAG_WRITE) {
+    char *path;
+
+    if (dataset->ds_mshard_size > 0 && hioi_context_using_mpi (context)) {
+#if HIO_MPI_HAVE(1)
+      POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_module_dataset_save_shards (posix_dataset),
+                       "save_shards", 0, 0);
+#endif
+    } else {
+      /* write manifest header */
+      POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_gather_manifest (dataset, &manifest, &manifest_size, false, true),
+                       "gather_manifest", 0, 0);
+      if (HIO_SUCCESS != rc) {
+        dataset->ds_status = rc;
+      }
+    }
+
+    if (0 == context->c_rank && NULL != manifest) {
+      rc = asprintf (&path, "%s/manifest.json", posix_dataset->base_path);
+      if (0 > rc) {
+        /* out of memory. not much we can do now */
+        return hioi_err_errno (errno);
+      }
+
+      rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
+      free (manifest);
+      free (path);
+      if (HIO_SUCCESS != rc) {
+        hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest");
+      }
+    }
+
+    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode || HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode) {
+      /* optimized and packed modes require a data manifest to describe how the data landed on the filesystem */
+      POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_module_dataset_data_manifest (posix_dataset, &manifest, &manifest_size),
+                       "gather_manifest", 0, 0);
+      if (HIO_SUCCESS != rc) {
+        dataset->ds_status = rc;
+      }
+
+      if (NULL != manifest) {
+        rc = asprintf (&path, "%s/manifest.%x.json%s", posix_dataset->base_path, context->c_rank,
+                       posix_dataset->ds_use_bzip ? ".bz2" : "");
+        if (0 > rc) {
+          return hioi_err_errno (errno);
+        }
+
+        rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
+        free (manifest);
+        free (path);
+        if (HIO_SUCCESS != rc) {
+          hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest");
+        }
+      }
+    }
+  }
+
+  if (HIO_SUCCESS != placement_rc) {
+    rc = placement_rc;
+  }
+
+#if HIO_MPI_HAVE(1)
+  /* ensure all ranks have closed the dataset before continuing */
+  if (hioi_context_using_mpi (context)) {
+    MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_comm);
+  }
+#endif
+
+  if (HIO_SUCCESS == rc) {
+    builtin_posix_autotune_record (posix_dataset);
+
+    /* listing the instances is collective. only rank 0 removes them */
+    if ((dataset->ds_flags & HIO_FLAG_WRITE) && posix_dataset->ds_keep_last) {
+      builtin_posix_apply_retention (posix_dataset);
+    }
+  }
+
+  free (posix_dataset->base_path);
+
+  stop = hioi_gettime ();
+
+  builtin_posix_trace (posix_dataset, "close", 0, 0, start, stop);
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: successfully closed posix dataset "
+            "%s:%" PRIu64 " on data root %s. close time %" PRIu64 " usec", hioi_object_identifier(dataset),
+            dataset->ds_id, module->data_root, stop - start);
+
+  builtin_posix_trace (posix_dataset, "trace_end", 0, 0, 0, 0);
+  if (posix_dataset->ds_trace_fh) {
+    fclose (posix_dataset->ds_trace_fh);
+  }
+
+  return rc;
+}
+
+/** directory in the context directory holding datasets waiting to be removed in the background */
+#define BUILTIN_POSIX_TRASH_DIR ".hio_trash"
+
+/** files and directories of a tree being removed */
+typedef struct builtin_posix_unlink_list_t {
+  /** regular files (and other non-directories) */
+  char  **ul_files;
+  size_t  ul_file_count, ul_file_size;
+  /** directories. parents are listed before their children */
+  char  **ul_dirs;
+  size_t  ul_dir_count, ul_dir_size;
+  /** next file to remove */
+  size_t  ul_next;
+  /** first error seen while removing files */
+  int     ul_errno;
+  pthread_mutex_t ul_lock;
+} builtin_posix_unlink_list_t;
+
+static int builtin_posix_unlink_list_append (char ***list, size_t *count, size_t *size, char *path) {
+  if (*count == *size) {
+    size_t new_size = *size ? *size * 2 : 256;
+    void *tmp = realloc (*list, new_size * sizeof (**list));
+    if (NULL == tmp) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    *list = (char **) tmp;
+    *size = new_size;
+  }
+
+  (*list)[(*count)++] = path;
+
+  return HIO_SUCCESS;
+}
+
+/**
+ * Build the list of files and directories under path
+ */
+static int builtin_posix_unlink_list_build (builtin_posix_unlink_list_t *list, const char *path) {
+  size_t first = list->ul_dir_count;
+  char *copy;
+  int rc;
+
+  copy = strdup (path);
+  if (NULL == copy) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  rc = builtin_posix_unlink_list_append (&list->ul_dirs, &list->ul_dir_count, &list->ul_dir_size, copy);
+  if (HIO_SUCCESS != rc) {
+    free (copy);
+    return rc;
+  }
+
+  /* breadth-first walk. list->ul_dirs doubles as the queue of directories to read */
+  for (size_t i = first ; i < list->ul_dir_count ; ++i) {
+    struct dirent *entry;
+    DIR *dir;
+
+    dir = opendir (list->ul_dirs[i]);
+    if (NULL == dir) {
+      continue;
+    }
+
+    while (HIO_SUCCESS == rc && NULL != (entry = readdir (dir))) {
+      struct stat statinfo;
+      char *child;
+
+      if (0 == strcmp (entry->d_name, ".") || 0 == strcmp (entry->d_name, "..")) {
+        continue;
+      }
+
+      if (0 > asprintf (&child, "%s/%s", list->ul_dirs[i], entry->d_name)) {
+        rc = HIO_ERR_OUT_OF_RESOURCE;
+        break;
+      }
+
+      statinfo.st_mode = 0;
+#if defined(_DIRENT_HAVE_D_TYPE)
+      /* avoid a stat per file when the file system reports the entry type */
+      if (DT_UNKNOWN != entry->d_type) {
+        statinfo.st_mode = (DT_DIR == entry->d_type) ? S_IFDIR : S_IFREG;
+      }
+#endif
+      if (0 == statinfo.st_mode && lstat (child, &statinfo)) {
+        free (child);
+        continue;
+      }
+
+      if (S_ISDIR(statinfo.st_mode)) {
+        rc = builtin_posix_unlink_list_append (&list->ul_dirs, &list->ul_dir_count, &list->ul_dir_size, child);
+      } else {
+        rc = builtin_posix_unlink_list_append (&list->ul_files, &list->ul_file_count, &list->ul_file_size, child);
+      }
+
+      if (HIO_SUCCESS != rc) {
+        free (child);
+      }
+    }
+
+    closedir (dir);
+  }
+
+  return rc;
+}
+
+static void *builtin_posix_unlink_thread (void *arg) {
+  builtin_posix_unlink_list_t *list = (builtin_posix_unlink_list_t *) arg;
+  const size_t batch = 64;
+
+  do {
+    size_t start, end;
+
+    /* files are handed out in batches to limit contention on the list lock */
+    pthread_mutex_lock (&list->ul_lock);
+    start = list->ul_next;
+    end = start + batch;
+    if (end > list->ul_file_count) {
+      end = list->ul_file_count;
+    }
+    list->ul_next = end;
+    pthread_mutex_unlock (&list->ul_lock);
+
+    if (start == end) {
+      break;
+    }
+
+    for (size_t i = start ; i < end ; ++i) {
+      if (unlink (list->ul_files[i]) && ENOENT != errno && 0 == list->ul_errno) {
+        list->ul_errno = errno;
+      }
+    }
+  } while (1);
+
+  return NULL;
+}
+
+/**
+ * Remove a directory tree
+ *
+ * @param[in] context      hio context
+ * @param[in] path         top of the tree to remove
+ * @param[in] thread_count number of threads to use to remove files
+ *
+ * The tree is listed by the calling thread. File removal, the expensive part on parallel
+ * file systems, is spread over thread_count threads. Files or directories removed by
+ * another process while this function runs are ignored.
+ */
+static int builtin_posix_remove_tree (hio_context_t context, const char *path, unsigned thread_count) {
+  builtin_posix_unlink_list_t list = {.ul_files = NULL};
+  pthread_t *threads = NULL;
+  unsigned started = 0;
+  uint64_t start;
+  int rc;
+
+  start = hioi_gettime ();
+
+  pthread_mutex_init (&list.ul_lock, NULL);
+
+  rc = builtin_posix_unlink_list_build (&list, path);
+
+  if (HIO_SUCCESS == rc) {
+    /* no need for threads on small trees */
+    if (thread_count > 1 && list.ul_file_count > 256) {
+      threads = calloc (thread_count - 1, sizeof (*threads));
+    }
+
+    for (unsigned i = 0 ; threads && i < thread_count - 1 ; ++i) {
+      if (pthread_create (threads + i, NULL, builtin_posix_unlink_thread, &list)) {
+        break;
+      }
+      ++started;
+    }
+
+    /* this thread participates as well */
+    (void) builtin_posix_unlink_thread (&list);
+
+    for (unsigned i = 0 ; i < started ; ++i) {
+      pthread_join (threads[i], NULL);
+    }
+
+    free (threads);
+
+    /* remove the directories deepest first */
+    for (size_t i = list.ul_dir_count ; i > 0 ; --i) {
+      if (rmdir (list.ul_dirs[i - 1]) && ENOENT != errno && 0 == list.ul_errno) {
+        list.ul_errno = errno;
+      }
+    }
+
+    if (list.ul_errno) {
+      rc = hioi_err_errno (list.ul_errno);
+    }
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: removed %lu files and %lu directories under %s using %u "
+            "thread(s) in %" PRIu64 " usec. rc: %d", (unsigned long) list.ul_file_count,
+            (unsigned long) list.ul_dir_count, path, started + 1, hioi_gettime () - start, rc);
+
+  for (size_t i = 0 ; i < list.ul_file_count ; ++i) {
+    free (list.ul_files[i]);
+  }
+
+  for (size_t i = 0 ; i < list.ul_dir_count ; ++i) {
+    free (list.ul_dirs[i]);
+  }
+
+  free (list.ul_files);
+  free (list.ul_dirs);
+  pthread_mutex_destroy (&list.ul_lock);
+
+  return rc;
+}
+
+/**
+ * Remove everything in the trash directory of the module context
+ */
+static void builtin_posix_empty_trash (builtin_posix_module_t *posix_module) {
+  hio_context_t context = posix_module->base.context;
+  struct dirent *entry;
+  char *path, *child;
+  DIR *dir;
+
+  if (0 > asprintf (&path, "%s/%s.hio/" BUILTIN_POSIX_TRASH_DIR, posix_module->base.data_root,
+                    hioi_object_identifier (context))) {
+    return;
+  }
+
+  dir = opendir (path);
+  while (NULL != dir && NULL != (entry = readdir (dir))) {
+    if ('.' == entry->d_name[0]) {
+      continue;
+    }
+
+    if (0 < asprintf (&child, "%s/%s", path, entry->d_name)) {
+      (void) builtin_posix_remove_tree (context, child, context->c_unlink_threads);
+      free (child);
+    }
+  }
+
+  if (NULL != dir) {
+    closedir (dir);
+  }
+
+  free (path);
+}
+
+static void *builtin_posix_background_unlink (void *arg) {
+  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) arg;
+
+  pthread_mutex_lock (&posix_module->pm_unlink_lock);
+  do {
+    while (!posix_module->pm_unlink_pending && !posix_module->pm_unlink_shutdown) {
+      pthread_cond_wait (&posix_module->pm_unlink_cond, &posix_module->pm_unlink_lock);
+    }
+
+    if (!posix_module->pm_unlink_pending) {
+      break;
+    }
+
+    posix_module->pm_unlink_pending = false;
+    pthread_mutex_unlock (&posix_module->pm_unlink_lock);
+
+    builtin_posix_empty_trash (posix_module);
+
+    pthread_mutex_lock (&posix_module->pm_unlink_lock);
+  } while (1);
+  pthread_mutex_unlock (&posix_module->pm_unlink_lock);
+
+  return NULL;
+}
+
+/**
+ * Move a dataset directory to the trash directory and wake up the background unlink thread
+ */
+static int builtin_posix_trash_dataset (builtin_posix_module_t *posix_module, const char *path,
+                                        const char *name, int64_t set_id) {
+  hio_context_t context = posix_module->base.context;
+  char *trash_path, *target;
+  int rc = HIO_SUCCESS;
+
+  rc = asprintf (&trash_path, "%s/%s.hio/" BUILTIN_POSIX_TRASH_DIR, posix_module->base.data_root,
+                 hioi_object_identifier (context));
+  if (0 > rc) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  if (mkdir (trash_path, posix_module->access_mode) && EEXIST != errno) {
+    rc = hioi_err_errno (errno);
+    free (trash_path);
+    return rc;
+  }
+
+  /* the trash name only needs to be unique within this context directory */
+  rc = asprintf (&target, "%s/%s.%" PRId64 ".%d.%" PRIu64, trash_path, name, set_id, (int) getpid (),
+                 hioi_gettime ());
+  free (trash_path);
+  if (0 > rc) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
 
-  start = hioi_gettime ();
+  if (rename (path, target)) {
+    rc = hioi_err_errno (errno);
+    free (target);
+    return rc;
+  }
+
+  free (target);
 
-  for (int i = 0 ; i < HIO_POSIX_MAX_OPEN_FILES ; ++i) {
-    if (posix_dataset->files[i].f_bid >= 0) {
-      POSIX_TRACE_CALL(posix_dataset, hioi_file_close (posix_dataset->files + i), "file_close",
-                       posix_dataset->files[i].f_bid, 0);
+  rc = HIO_SUCCESS;
+
+  pthread_mutex_lock (&posix_module->pm_unlink_lock);
+  if (!posix_module->pm_unlink_running) {
+    if (0 == pthread_create (&posix_module->pm_unlink_thread, NULL, builtin_posix_background_unlink, posix_module)) {
+      posix_module->pm_unlink_running = true;
     }
   }
 
-#if HIO_MPI_HAVE(3)
-  /* release the shared state if it was allocated */
-  (void) hioi_dataset_shared_fini (dataset);
+  posix_module->pm_unlink_pending = true;
+  pthread_cond_signal (&posix_module->pm_unlink_cond);
+  pthread_mutex_unlock (&posix_module->pm_unlink_lock);
 
-  /* release the dataset map if one was allocated */
-  (void) hioi_dataset_map_release (dataset);
-#endif
+  if (!posix_module->pm_unlink_running) {
+    /* could not start the thread. remove the files now */
+    builtin_posix_empty_trash (posix_module);
+  }
 
+  return rc;
+}
 
-  if (dataset->ds_flags & HIO_FLAG_WRITE) {
-    char *path;
+/**
+ * Remove a dataset instance from the data root of a posix module
+ *
+ * @param[in] module         posix module
+ * @param[in] name           dataset name
+ * @param[in] set_id         dataset identifier
+ * @param[in] data_only      only remove the instance if it has no top-level manifest. this is
+ *                           the case for data files spread from another data root
+ */
+static int builtin_posix_unlink_root (struct hio_module_t *module, const char *name, int64_t set_id,
+                                      bool data_only) {
+  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) module;
+  hio_context_t context = module->context;
+  struct stat statinfo;
+  char *path = NULL, *manifest;
+  int rc;
 
-    /* write manifest header */
-    POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_gather_manifest (dataset, &manifest, &manifest_size, false, true),
-                     "gather_manifest", 0, 0);
-    if (HIO_SUCCESS != rc) {
-      dataset->ds_status = rc;
-    }
+  rc = builtin_posix_dataset_path (module, &path, name, set_id);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
 
-    if (0 == context->c_rank) {
-      rc = asprintf (&path, "%s/manifest.json", posix_dataset->base_path);
-      if (0 > rc) {
-        /* out of memory. not much we can do now */
-        return hioi_err_errno (errno);
-      }
+  if (stat (path, &statinfo)) {
+    free (path);
+    return hioi_err_errno (errno);
+  }
 
-      rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
-      free (manifest);
+  if (data_only) {
+    if (0 > asprintf (&manifest, "%s/manifest.json", path)) {
       free (path);
-      if (HIO_SUCCESS != rc) {
-        hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest");
-      }
+      return HIO_ERR_OUT_OF_RESOURCE;
     }
 
-#if HIO_MPI_HAVE(3)
-    if (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) {
-      /* optimized mode requires a data manifest to describe how the data landed on the filesystem */
-      POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_gather_manifest_comm (dataset, context->c_shared_comm, &manifest, &manifest_size,
-                                                                              posix_dataset->ds_use_bzip, false),
-                       "gather_manifest", 0, 0);
-      if (HIO_SUCCESS != rc) {
-        dataset->ds_status = rc;
-      }
+    rc = access (manifest, F_OK);
+    free (manifest);
+    if (0 == rc) {
+      /* a complete instance of its own */
+      free (path);
+      return HIO_ERR_EXISTS;
+    }
+  }
 
-      if (NULL != manifest) {
-        rc = asprintf (&path, "%s/manifest.%x.json%s", posix_dataset->base_path, context->c_rank,
-                       posix_dataset->ds_use_bzip ? ".bz2" : "");
-        if (0 > rc) {
-          return hioi_err_errno (errno);
-        }
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: unlinking existing dataset %s::%" PRId64,
+            name, set_id);
 
-        rc = hioi_manifest_save (dataset, manifest, manifest_size, path);
-        free (manifest);
-        free (path);
-        if (HIO_SUCCESS != rc) {
-          hioi_err_push (rc, &dataset->ds_object, "posix: error writing dataset manifest");
-        }
-      }
+  if (context->c_unlink_background) {
+    rc = builtin_posix_trash_dataset (posix_module, path, name, set_id);
+    if (HIO_SUCCESS == rc) {
+      free (path);
+      return HIO_SUCCESS;
     }
-#endif
+
+    hioi_log (context, HIO_VERBOSE_WARN, "posix: could not move dataset %s::%" PRId64 " to the trash "
+              "directory. removing it now", name, set_id);
   }
 
-#if HIO_MPI_HAVE(1)
-  /* ensure all ranks have closed the dataset before continuing */
-  if (hioi_context_using_mpi (context)) {
-    MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_comm);
+  rc = builtin_posix_remove_tree (context, path, context->c_unlink_threads);
+  free (path);
+  if (HIO_SUCCESS != rc) {
+    hioi_err_push (rc, &context->c_object, "posix: could not unlink dataset %s::%" PRId64, name, set_id);
+    return rc;
   }
-#endif
 
-  free (posix_dataset->base_path);
+  return HIO_SUCCESS;
+}
 
-  stop = hioi_gettime ();
+/**
+ * Unlink a dataset instance
+ *
+ * Data files of the instance may have been spread over the other posix data roots of the
+ * context (see dataset_data_root_spread). These are removed along with the instance.
+ */
+static int builtin_posix_module_dataset_unlink (struct hio_module_t *module, const char *name, int64_t set_id) {
+  hio_context_t context = module->context;
+  int rc;
 
-  builtin_posix_trace (posix_dataset, "close", 0, 0, start, stop);
+  if (context->c_rank) {
+    return HIO_ERR_NOT_AVAILABLE;
+  }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix:dataset_open: successfully closed posix dataset "
-            "%s:%" PRIu64 " on data root %s. close time %" PRIu64 " usec", hioi_object_identifier(dataset),
-            dataset->ds_id, module->data_root, stop - start);
+  rc = builtin_posix_unlink_root (module, name, set_id, false);
 
-  builtin_posix_trace (posix_dataset, "trace_end", 0, 0, 0, 0);
-  if (posix_dataset->ds_trace_fh) {
-    fclose (posix_dataset->ds_trace_fh);
+  /* remove any data files left in the other data roots */
+  for (int i = 0 ; i < context->c_mcount ; ++i) {
+    hio_module_t *other = context->c_modules[i];
+    if (other != module && builtin_posix_is_posix_module (other)) {
+      (void) builtin_posix_unlink_root (other, name, set_id, true);
+    }
   }
 
   return rc;
 }
 
-static int builtin_posix_unlink_cb (const char *path, const struct stat *sb, int typeflag, struct FTW *ftwbuf) {
-  return remove (path);
+static int builtin_posix_compare_headers (const void *a, const void *b) {
+  const hio_dataset_header_t *header_a = (const hio_dataset_header_t *) a;
+  const hio_dataset_header_t *header_b = (const hio_dataset_header_t *) b;
+
+  /* highest identifier first */
+  return (header_a->ds_id < header_b->ds_id) - (header_a->ds_id > header_b->ds_id);
 }
 
-static int builtin_posix_module_dataset_unlink (struct hio_module_t *module, const char *name, int64_t set_id) {
-  struct stat statinfo;
-  char *path = NULL;
-  int rc;
+/**
+ * Remove old instances of a dataset keeping the newest (highest identifier) ds_keep_last
+ */
+static void builtin_posix_apply_retention (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  hio_module_t *module = dataset->ds_module;
+  hio_context_t context = module->context;
+  hio_dataset_header_t *headers = NULL;
+  int count = 0, kept = 1, rc;
 
-  if (module->context->c_rank) {
-    return HIO_ERR_NOT_AVAILABLE;
+  rc = builtin_posix_module_dataset_list (module, hioi_object_identifier (dataset), &headers, &count);
+  if (HIO_SUCCESS != rc || count <= (int) posix_dataset->ds_keep_last) {
+    free (headers);
+    return;
   }
 
-  rc = builtin_posix_dataset_path (module, &path, name, set_id);
-  if (HIO_SUCCESS != rc) {
-    return rc;
-  }
+  qsort (headers, count, sizeof (*headers), builtin_posix_compare_headers);
 
-  if (stat (path, &statinfo)) {
-    free (path);
-    return hioi_err_errno (errno);
-  }
+  for (int i = 0 ; i < count ; ++i) {
+    /* the instance just closed is always kept */
+    if (headers[i].ds_id == dataset->ds_id || kept++ < (int) posix_dataset->ds_keep_last) {
+      continue;
+    }
 
-  hioi_log (module->context, HIO_VERBOSE_DEBUG_LOW, "posix: unlinking existing dataset %s::%" PRId64,
-            name, set_id);
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: removing dataset %s::%" PRId64 " (keeping the last %u "
+              "instances)", hioi_object_identifier (dataset), headers[i].ds_id, posix_dataset->ds_keep_last);
 
-  /* use tree walk depth-first to remove all of the files for this dataset */
-  rc = nftw (path, builtin_posix_unlink_cb, 32, FTW_DEPTH | FTW_PHYS);
-  free (path);
-  if (0 > rc) {
-    hioi_err_push (hioi_err_errno (errno), &module->context->c_object, "posix: could not unlink dataset. errno: %d",
-                  errno);
-    return hioi_err_errno (errno);
+    (void) builtin_posix_module_dataset_unlink (module, hioi_object_identifier (dataset), headers[i].ds_id);
   }
 
-  return HIO_SUCCESS;
+  free (headers);
 }
 
 static int builtin_posix_open_file (builtin_posix_module_t *posix_module, builtin_posix_module_dataset_t *posix_dataset,
-                                    char *path, hio_file_t *file) {
+                                    int dirfd, const char *path, hio_file_t *file) {
   hio_object_t hio_object = &posix_dataset->base.ds_object;
   int open_flags, fd;
 #if BUILTIN_POSIX_USE_STDIO
@@ -867,7 +2596,7 @@ static int builtin_posix_open_file (builtin_posix_module_t *posix_module, builti
   /* it is not possible to get open with create without truncation using fopen so use a
    * combination of open and fdopen to get the desired effect */
   //hioi_log (context, HIO_VERBOSE_DEBUG_HIGH, "posix: calling open; path: %s open_flags: %i", path, open_flags);
-  fd = open (path, open_flags, posix_module->access_mode);
+  fd = openat (dirfd, path, open_flags, posix_module->access_mode);
   if (fd < 0) {
     hioi_err_push (fd, hio_object, "posix: error opening element path %s. "
                   "errno: %d", path, errno);
@@ -899,37 +2628,55 @@ static int builtin_posix_open_file (builtin_posix_module_t *posix_module, builti
 
 static int builtin_posix_module_element_open_basic (builtin_posix_module_t *posix_module, builtin_posix_module_dataset_t *posix_dataset,
                                                     hio_element_t element) {
+  hio_shared_control_t *control = posix_dataset->base.ds_shared_control;
   const char *element_name = hioi_object_identifier(element);
+  uint32_t concurrency = posix_dataset->ds_create_concurrency;
+  bool throttle = false;
+  int rc, dirfd;
   char *path;
-  int rc;
 
-  if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
-    rc = asprintf (&path, "%s/data/element_data.%s.%08d", posix_dataset->base_path, element_name,
-                   element->e_rank);
+  /* the data directory (or the dataset directory for old datasets) is resolved once per dataset */
+  dirfd = builtin_posix_data_dir (posix_dataset, 0, NULL);
+  if (0 > dirfd) {
+    return dirfd;
+  }
+
+  if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode && posix_dataset->base.ds_dir_shard_size) {
+    rc = asprintf (&path, "%lu/element_data.%s.%08d", (unsigned long) element->e_rank /
+                   posix_dataset->base.ds_dir_shard_size, element_name, element->e_rank);
+  } else if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
+    rc = asprintf (&path, "element_data.%s.%08d", element_name, element->e_rank);
   } else {
-    rc = asprintf (&path, "%s/data/element_data.%s", posix_dataset->base_path, element_name);
+    rc = asprintf (&path, "element_data.%s", element_name);
   }
 
   if (0 > rc) {
     return HIO_ERR_OUT_OF_RESOURCE;
   }
 
-  if (access (path, R_OK)) {
-    /* fall back on old naming scheme */
-    if (HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode) {
-      rc = asprintf (&path, "%s/element_data.%s.%08d", posix_dataset->base_path, element_name,
-                     element->e_rank);
-    } else {
-      rc = asprintf (&path, "%s/element_data.%s", posix_dataset->base_path, element_name);
+  if ((posix_dataset->base.ds_flags & HIO_FLAG_WRITE) && HIO_SET_ELEMENT_UNIQUE == posix_dataset->base.ds_mode &&
+      concurrency && NULL != control) {
+    /* limit the number of ranks on this node creating files at the same time to smooth out
+     * the load on the metadata server */
+    pthread_mutex_lock (&control->s_create_mutex);
+    while (control->s_creating >= concurrency) {
+      pthread_cond_wait (&control->s_create_cond, &control->s_create_mutex);
     }
+    ++control->s_creating;
+    pthread_mutex_unlock (&control->s_create_mutex);
 
-    if (0 > rc) {
-      return hioi_err_errno (errno);
-    }
+    throttle = true;
   }
 
-  POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_open_file (posix_module, posix_dataset, path, &element->e_file),
+  POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_open_file (posix_module, posix_dataset, dirfd, path, &element->e_file),
                    "file_open", 0, 0);
+  if (throttle) {
+    pthread_mutex_lock (&control->s_create_mutex);
+    --control->s_creating;
+    pthread_cond_signal (&control->s_create_cond);
+    pthread_mutex_unlock (&control->s_create_mutex);
+  }
+
   free (path);
   if (HIO_SUCCESS != rc) {
     return rc;
@@ -956,7 +2703,7 @@ static int builtin_posix_module_element_open (hio_dataset_t dataset, hio_element
   if (HIO_FILE_MODE_BASIC == posix_dataset->ds_fmode) {
     rc = builtin_posix_module_element_open_basic (posix_module, posix_dataset, element);
     if (HIO_SUCCESS != rc) {
-      hioi_object_release (&element->e_object);
+      /* the caller owns the element and releases it */
       return rc;
     }
   }
@@ -968,22 +2715,77 @@ static int builtin_posix_module_element_open (hio_dataset_t dataset, hio_element
   element->e_flush = builtin_posix_module_element_flush;
   element->e_complete = builtin_posix_module_element_complete;
   element->e_close = builtin_posix_module_element_close;
+#if defined(HAVE_POSIX_FADVISE)
+  element->e_prefetch = builtin_posix_module_element_prefetch;
+#endif
 
   return HIO_SUCCESS;
 }
 
 static int builtin_posix_module_element_close (hio_element_t element) {
+  builtin_posix_module_dataset_t *posix_dataset =
+    (builtin_posix_module_dataset_t *) hioi_element_dataset (element);
+
+  /* the file is closed without syncing it. remember it so a complete flush can account for it */
+  if (element->e_file.f_dirty) {
+    ++posix_dataset->ds_dirty_closed;
+  }
+
   return HIO_SUCCESS;
 }
 
+/**
+ * Reserve space for a small request in a block shared by the ranks on this node
+ *
+ * The ranks using a stripe share one partially filled block at a time. Requests are
+ * rounded up to the sub-block size and bump allocated from that block under the stripe
+ * lock. When the block can not hold the request a new block is taken from the stripe
+ * and the tail of the old block is left unused.
+ */
+static unsigned long builtin_posix_reserve_sub (builtin_posix_module_dataset_t *posix_dataset, size_t *requested,
+                                                int slot) {
+  hio_shared_control_t *control = posix_dataset->base.ds_shared_control;
+  uint32_t stripe_count = posix_dataset->ds_stripe_count;
+  uint64_t block_size = posix_dataset->ds_bs;
+  uint64_t sub_size = posix_dataset->ds_sub_block_size;
+  const int stripe = posix_dataset->my_stripe;
+  unsigned long new_offset, space;
+
+  space = sub_size * ((*requested + sub_size - 1) / sub_size);
+  if (space > block_size) {
+    space = block_size;
+  }
+
+  pthread_mutex_lock (&control->s_stripes[slot].s_mutex);
+  if (control->s_stripes[slot].s_sub_remaining < space) {
+    unsigned long s_index = atomic_fetch_add (&control->s_stripes[slot].s_index, 1);
+    control->s_stripes[slot].s_sub_offset = (s_index * stripe_count * block_size) + stripe * block_size;
+    control->s_stripes[slot].s_sub_remaining = block_size;
+  }
+
+  new_offset = control->s_stripes[slot].s_sub_offset;
+  control->s_stripes[slot].s_sub_offset += space;
+  control->s_stripes[slot].s_sub_remaining -= space;
+  pthread_mutex_unlock (&control->s_stripes[slot].s_mutex);
+
+  posix_dataset->ds_sub_reserved += space;
+  if (*requested > space) {
+    *requested = space;
+  }
+
+  posix_dataset->reserved_offset = new_offset + *requested;
+  posix_dataset->reserved_remaining = space - *requested;
+
+  return new_offset;
+}
+
 /* reserve space in the local shared file for this rank's data */
 static unsigned long builtin_posix_reserve (builtin_posix_module_dataset_t *posix_dataset, size_t *requested) {
-  /* NTH: this value should be changed to be non-0 if stripe exclusivity is re-enabled */
-  uint32_t stripe_count = 1;
+  uint32_t stripe_count = posix_dataset->ds_stripe_count;
   uint64_t block_size = posix_dataset->ds_bs;
   const int stripe = posix_dataset->my_stripe;
   unsigned long new_offset, to_use, space;
-  int nstripes;
+  int nstripes, slot;
 
   if (posix_dataset->reserved_remaining) {
     to_use = (*requested > posix_dataset->reserved_remaining) ? posix_dataset->reserved_remaining : *requested;
@@ -997,6 +2799,20 @@ static unsigned long builtin_posix_reserve (builtin_posix_module_dataset_t *posi
     return new_offset;
   }
 
+  /* each data root has its own data file and its own set of stripe indices */
+  posix_dataset->ds_reserved_root = posix_dataset->ds_next_root;
+  if (HIO_POSIX_ROOT_SPREAD_BLOCK == posix_dataset->ds_root_spread) {
+    posix_dataset->ds_next_root = (posix_dataset->ds_next_root + 1) % posix_dataset->ds_root_count;
+  }
+  slot = posix_dataset->ds_reserved_root * stripe_count + stripe;
+
+  /* ranks that have written less than a block so far pack their data into blocks shared
+   * with the other ranks on the node instead of leaving most of a block empty */
+  if (posix_dataset->ds_sub_block_size && posix_dataset->ds_sub_block_size < block_size &&
+      *requested < block_size && posix_dataset->ds_sub_reserved < block_size) {
+    return builtin_posix_reserve_sub (posix_dataset, requested, slot);
+  }
+
   space = *requested;
 
   if (space % posix_dataset->ds_bs) {
@@ -1010,23 +2826,231 @@ static unsigned long builtin_posix_reserve (builtin_posix_module_dataset_t *posi
     nstripes = space / posix_dataset->ds_bs;
   }
 
-  unsigned long s_index = atomic_fetch_add (&posix_dataset->base.ds_shared_control->s_stripes[stripe].s_index, nstripes);
+  unsigned long s_index = atomic_fetch_add (&posix_dataset->base.ds_shared_control->s_stripes[slot].s_index, nstripes);
   new_offset = (s_index * stripe_count * block_size) + stripe * block_size;
 
   posix_dataset->reserved_offset = new_offset + *requested;
   posix_dataset->reserved_remaining = space - *requested;
 
+  if (posix_dataset->ds_preallocate && *requested >= block_size) {
+    /* only blocks this request covers completely are known to be filled */
+    posix_dataset->ds_prealloc_offset = new_offset;
+    posix_dataset->ds_prealloc_size = *requested - (*requested % block_size);
+  }
+
   return new_offset;
 }
 
+/**
+ * Preallocate the region reserved by builtin_posix_reserve if it will be completely filled
+ *
+ * This is only a hint to the filesystem. Failures (including filesystems that do not support
+ * preallocation) are ignored.
+ */
+static void builtin_posix_preallocate (builtin_posix_module_dataset_t *posix_dataset, hio_file_t *file) {
+  uint64_t offset = posix_dataset->ds_prealloc_offset, size = posix_dataset->ds_prealloc_size;
+
+  if (0 == size) {
+    return;
+  }
+
+  posix_dataset->ds_prealloc_size = 0;
+
+#if defined(HAVE_FALLOCATE) && defined(FALLOC_FL_KEEP_SIZE)
+#if BUILTIN_POSIX_USE_STDIO
+  int fd = fileno (file->f_hndl);
+#else
+  int fd = file->f_fd;
+#endif
+
+  if (0 != fallocate (fd, FALLOC_FL_KEEP_SIZE, offset, size)) {
+    hioi_log (hioi_object_context (&posix_dataset->base.ds_object), HIO_VERBOSE_DEBUG_MED,
+              "posix: could not preallocate %" PRIu64 " bytes at offset %" PRIu64 ". errno: %d",
+              size, offset, errno);
+  }
+#endif
+}
+
+/**
+ * Format the name of a strided, optimized, or packed mode data file relative to the data
+ * directory. Strided and packed mode files are placed in a subdirectory if the data directory
+ * is sharded.
+ */
+static int builtin_posix_file_name (builtin_posix_module_dataset_t *posix_dataset, hio_element_t element,
+                                    int file_id, char *name, size_t size) {
+  int rc;
+
+  if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode && posix_dataset->base.ds_dir_shard_size) {
+    rc = snprintf (name, size, "%lu/%s_block.%08lu", (unsigned long) file_id / posix_dataset->base.ds_dir_shard_size,
+                   hioi_object_identifier(element), (unsigned long) file_id);
+  } else if (HIO_FILE_MODE_STRIDED == posix_dataset->ds_fmode) {
+    rc = snprintf (name, size, "%s_block.%08lu", hioi_object_identifier(element), (unsigned long) file_id);
+  } else if (HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode && posix_dataset->base.ds_dir_shard_size) {
+    rc = snprintf (name, size, "%lu/packed.%x", (unsigned long) file_id / posix_dataset->base.ds_dir_shard_size,
+                   file_id);
+  } else if (HIO_FILE_MODE_PACKED == posix_dataset->ds_fmode) {
+    rc = snprintf (name, size, "packed.%x", file_id);
+  } else {
+    rc = snprintf (name, size, "data.%x", file_id);
+  }
+
+  return (0 > rc || (size_t) rc >= size) ? HIO_ERR_BAD_PARAM : HIO_SUCCESS;
+}
+
+/**
+ * Open the directory containing the data files of this dataset in a data root
+ *
+ * Called on the first data file open in each data root. Datasets written by older versions
+ * kept their data files in the dataset directory. This is detected here once per dataset:
+ * basic mode datasets have no data directory and optimized mode datasets are checked using
+ * the first data file this rank reads.
+ *
+ * @param[in] posix_dataset  posix dataset
+ * @param[in] root           data root index
+ * @param[in] name           name of the data file about to be opened (optimized mode)
+ *
+ * @returns directory file descriptor on success
+ * @returns hio error code on failure
+ */
+static int builtin_posix_data_dir (builtin_posix_module_dataset_t *posix_dataset, int root, const char *name) {
+  hio_context_t context = hioi_object_context (&posix_dataset->base.ds_object);
+  char *path, *root_path;
+  int rc;
+
+  if (0 <= posix_dataset->ds_data_dirfd[root]) {
+    return posix_dataset->ds_data_dirfd[root];
+  }
+
+  rc = builtin_posix_root_path (posix_dataset, root, &root_path);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  rc = asprintf (&path, "%s/data", root_path);
+  if (0 > rc) {
+    free (root_path);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  posix_dataset->ds_data_dirfd[root] = open (path, O_RDONLY | O_DIRECTORY);
+  free (path);
+
+  if (!(HIO_FLAG_WRITE & posix_dataset->base.ds_flags) && 1 == posix_dataset->ds_root_count &&
+      (0 > posix_dataset->ds_data_dirfd[root] || (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode &&
+                                                  faccessat (posix_dataset->ds_data_dirfd[root], name, R_OK, 0)))) {
+    /* fall back on old naming scheme */
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: reading data files from dataset directory %s",
+              root_path);
+    if (0 <= posix_dataset->ds_data_dirfd[root]) {
+      close (posix_dataset->ds_data_dirfd[root]);
+    }
+    posix_dataset->ds_data_dirfd[root] = open (root_path, O_RDONLY | O_DIRECTORY);
+  }
+
+  if (0 > posix_dataset->ds_data_dirfd[root]) {
+    rc = hioi_err_errno (errno);
+    hioi_err_push (rc, &posix_dataset->base.ds_object, "posix: error opening data directory of %s. errno: %d",
+                   root_path, errno);
+    free (root_path);
+    return rc;
+  }
+
+  free (root_path);
+
+  return posix_dataset->ds_data_dirfd[root];
+}
+
+/**
+ * Get an open data file from the file cache
+ *
+ * Files are identified by (element, file id). Optimized mode data files are shared by all
+ * elements and use a NULL element. On a miss the least recently used file is closed and
+ * replaced. Paths are only formatted on a miss.
+ */
+static int builtin_posix_file_get (builtin_posix_module_t *posix_module, builtin_posix_module_dataset_t *posix_dataset,
+                                   hio_element_t element, int file_id, hio_file_t **file_out) {
+  builtin_posix_file_t *pfile, *lru = NULL;
+  char name[NAME_MAX + 1];
+  int rc, dirfd, root;
+
+  if (NULL == posix_dataset->ds_files) {
+    posix_dataset->ds_files = calloc (posix_dataset->ds_max_open_files, sizeof (posix_dataset->ds_files[0]));
+    if (NULL == posix_dataset->ds_files) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (size_t i = 0 ; i < posix_dataset->ds_max_open_files ; ++i) {
+      posix_dataset->ds_files[i].pf_file.f_bid = -1;
+      posix_dataset->ds_files[i].pf_file.f_fd = -1;
+    }
+  }
+
+  for (size_t i = 0 ; i < posix_dataset->ds_max_open_files ; ++i) {
+    pfile = posix_dataset->ds_files + i;
+    if (file_id == pfile->pf_file.f_bid && element == pfile->pf_file.f_element) {
+      pfile->pf_last_use = ++posix_dataset->ds_file_clock;
+      *file_out = &pfile->pf_file;
+      return HIO_SUCCESS;
+    }
+
+    /* unused entries have never been used so they are picked first */
+    if (NULL == lru || pfile->pf_last_use < lru->pf_last_use) {
+      lru = pfile;
+    }
+  }
+
+  rc = builtin_posix_file_name (posix_dataset, element, file_id, name, sizeof (name));
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  /* optimized mode data files are spread over the data roots by file index */
+  root = (HIO_FILE_MODE_OPTIMIZED == posix_dataset->ds_fmode) ? file_id % posix_dataset->ds_root_count : 0;
+
+  dirfd = builtin_posix_data_dir (posix_dataset, root, name);
+  if (0 > dirfd) {
+    return dirfd;
+  }
+
+  if (lru->pf_file.f_bid >= 0) {
+    /* a complete flush only sees open files so data in an evicted file is synced now. the
+     * failure is reported by the next complete flush */
+    rc = builtin_posix_sync_file (posix_dataset, &lru->pf_file);
+    if (HIO_SUCCESS != rc) {
+      hioi_log (hioi_object_context (&posix_dataset->base.ds_object), HIO_VERBOSE_WARN, "posix: could not sync "
+                "evicted data file %d. rc: %d", lru->pf_file.f_bid, rc);
+      if (HIO_SUCCESS == posix_dataset->ds_evict_rc) {
+        posix_dataset->ds_evict_rc = rc;
+      }
+    }
+    POSIX_TRACE_CALL(posix_dataset, hioi_file_close (&lru->pf_file), "file_close", lru->pf_file.f_bid, 0);
+  }
+
+  lru->pf_file.f_bid = -1;
+  lru->pf_file.f_element = element;
+  lru->pf_file.f_dirty = false;
+  lru->pf_file.f_wb_start = lru->pf_file.f_wb_end = 0;
+
+  POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_open_file (posix_module, posix_dataset, dirfd, name, &lru->pf_file),
+                   "file_open", file_id, 0);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  ++posix_dataset->ds_file_opens;
+  lru->pf_file.f_bid = file_id;
+  lru->pf_last_use = ++posix_dataset->ds_file_clock;
+  *file_out = &lru->pf_file;
+
+  return HIO_SUCCESS;
+}
+
 static int builtin_posix_element_translate_strided (builtin_posix_module_t *posix_module, hio_element_t element,
                                                     uint64_t offset, size_t *size, hio_file_t **file_out) {
   builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) hioi_element_dataset (element);
   size_t block_id, block_base, block_bound, block_offset, file_id, file_block;
   hio_context_t context = hioi_object_context (&element->e_object);
   hio_file_t *file;
-  int32_t file_index;
-  char *path;
   int rc;
 
   block_id = offset / posix_dataset->ds_bs;
@@ -1046,31 +3070,9 @@ static int builtin_posix_element_translate_strided (builtin_posix_module_t *posi
     *size = block_bound - offset;
   }
 
-  rc = asprintf (&path, "%s/data/%s_block.%08lu", posix_dataset->base_path, hioi_object_identifier(element),
-                 (unsigned long) file_id);
-  if (0 > rc) {
-    return HIO_ERR_OUT_OF_RESOURCE;
-  }
-
-  /* use crc as a hash to pick a file index to use */
-  file_index = file_id % HIO_POSIX_MAX_OPEN_FILES;
-  file = posix_dataset->files + file_index;
-
-  if (file_id != file->f_bid || file->f_element != element) {
-    if (file->f_bid >= 0) {
-      POSIX_TRACE_CALL(posix_dataset, hioi_file_close (file), "file_close", file->f_bid, 0);
-    }
-    file->f_bid = -1;
-
-    file->f_element = element;
-
-    POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_open_file (posix_module, posix_dataset, path, file),
-                     "file_open", file_id, 0);
-    if (HIO_SUCCESS != rc) {
-      return rc;
-    }
-
-    file->f_bid = file_id;
+  rc = builtin_posix_file_get (posix_module, posix_dataset, element, (int) file_id, &file);
+  if (HIO_SUCCESS != rc) {
+    return rc;
   }
 
   POSIX_TRACE_CALL(posix_dataset, hioi_file_seek (file, block_offset, SEEK_SET), "file_seek", file->f_bid, block_offset);
@@ -1088,7 +3090,6 @@ static int builtin_posix_element_translate_opt (builtin_posix_module_t *posix_mo
   hio_file_t *file;
   uint64_t file_offset;
   int file_index = 0;
-  char *path;
   int rc;
 
   hioi_log (context, HIO_VERBOSE_DEBUG_MED, "translating element %s offset %" PRIu64 " size %lu",
@@ -1097,8 +3098,12 @@ static int builtin_posix_element_translate_opt (builtin_posix_module_t *posix_mo
                    "translate_offset", offset, *size);
 #if HIO_MPI_HAVE(3)
   if (HIO_SUCCESS != rc && reading) {
-    POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_map_translate_offset (element, offset, &file_index, &file_offset, size),
-                     "map_translate_offset", offset, *size);
+    /* neighbouring reads usually fall in a segment that was already fetched */
+    rc = hioi_dataset_map_cache_lookup (element, offset, &file_index, &file_offset, size);
+    if (HIO_SUCCESS != rc) {
+      POSIX_TRACE_CALL(posix_dataset, rc = hioi_dataset_map_translate_offset (element, offset, &file_index, &file_offset, size),
+                       "map_translate_offset", offset, *size);
+    }
   }
 #endif
 
@@ -1109,6 +3114,9 @@ static int builtin_posix_element_translate_opt (builtin_posix_module_t *posix_mo
       return rc;
     }
 
+    /* existing data is overwritten in place */
+    hioi_element_clip_segment (element, offset, size);
+
     file_offset = builtin_posix_reserve (posix_dataset, size);
 
     if (hioi_context_using_mpi (context)) {
@@ -1117,51 +3125,70 @@ static int builtin_posix_element_translate_opt (builtin_posix_module_t *posix_mo
       file_index = 0;
     }
 
-    rc = asprintf (&path, "%s/data/data.%x", posix_dataset->base_path, file_index);
-    if (0 > rc) {
-      return HIO_ERR_OUT_OF_RESOURCE;
-    }
+    /* the data file index also identifies the data root holding the file */
+    file_index = file_index * posix_dataset->ds_root_count + posix_dataset->ds_reserved_root;
 
     hioi_element_add_segment (element, file_index, file_offset, offset, *size);
   } else {
     hioi_log (context, HIO_VERBOSE_DEBUG_MED, "offset found in file @ rank %d, offset %" PRIu64
               ", size %lu", file_index, file_offset, *size);
-    rc = asprintf (&path, "%s/data/data.%x", posix_dataset->base_path, file_index);
-    if (0 > rc) {
-      return HIO_ERR_OUT_OF_RESOURCE;
-    }
+  }
 
-    if (access (path, R_OK)) {
-      free (path);
-      rc = asprintf (&path, "%s/data.%x", posix_dataset->base_path, file_index);
-      if (0 > rc) {
-        return HIO_ERR_OUT_OF_RESOURCE;
-      }
-    }
+  /* node data files are shared by all elements */
+  rc = builtin_posix_file_get (posix_module, posix_dataset, NULL, file_index, &file);
+  if (HIO_SUCCESS != rc) {
+    return rc;
   }
 
-  /* use crc as a hash to pick a file index to use */
-  int internal_index = file_index % HIO_POSIX_MAX_OPEN_FILES;
-  file = posix_dataset->files + internal_index;
+  if (!reading) {
+    builtin_posix_preallocate (posix_dataset, file);
+  }
 
-  if (file_index != file->f_bid) {
-    if (file->f_bid >= 0) {
-      POSIX_TRACE_CALL(posix_dataset, hioi_file_close (file), "file_close", file->f_bid, 0);
-    }
+  POSIX_TRACE_CALL(posix_dataset, hioi_file_seek (file, file_offset, SEEK_SET), "file_seek", file->f_bid, file_offset);
 
-    file->f_bid = -1;
+  *file_out = file;
 
-    POSIX_TRACE_CALL(posix_dataset, rc = builtin_posix_open_file (posix_module, posix_dataset, path, file),
-                     "file_open", file_index, 0);
-    if (HIO_SUCCESS != rc) {
-      free (path);
+  return HIO_SUCCESS;
+}
+
+/**
+ * Translate an element offset in packed mode
+ *
+ * New data is appended to the container file of this rank. The segment list of each element
+ * serves as the segment table of the container.
+ */
+static int builtin_posix_element_translate_packed (builtin_posix_module_t *posix_module, hio_element_t element,
+                                                   uint64_t offset, size_t *size, hio_file_t **file_out,
+                                                   bool reading) {
+  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) hioi_element_dataset (element);
+  hio_context_t context = hioi_object_context (&element->e_object);
+  uint64_t file_offset;
+  int file_index = 0;
+  hio_file_t *file;
+  int rc;
+
+  rc = hioi_element_translate_offset (element, offset, &file_index, &file_offset, size);
+  if (HIO_SUCCESS != rc) {
+    if (reading) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_MED, "offset %" PRIu64 " not found", offset);
       return rc;
     }
 
-    file->f_bid = file_index;
+    /* existing data is overwritten in place */
+    hioi_element_clip_segment (element, offset, size);
+
+    file_index = context->c_rank;
+    file_offset = posix_dataset->ds_packed_offset;
+    posix_dataset->ds_packed_offset += *size;
+
+    hioi_element_add_segment (element, file_index, file_offset, offset, *size);
   }
 
-  free (path);
+  /* the container is shared by all elements of this rank */
+  rc = builtin_posix_file_get (posix_module, posix_dataset, NULL, file_index, &file);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
 
   POSIX_TRACE_CALL(posix_dataset, hioi_file_seek (file, file_offset, SEEK_SET), "file_seek", file->f_bid, file_offset);
 
@@ -1186,6 +3213,9 @@ static int builtin_posix_element_translate (builtin_posix_module_t *posix_module
   case HIO_FILE_MODE_OPTIMIZED:
     rc = builtin_posix_element_translate_opt (posix_module, element, offset, size, file_out, reading);
     break;
+  case HIO_FILE_MODE_PACKED:
+    rc = builtin_posix_element_translate_packed (posix_module, element, offset, size, file_out, reading);
+    break;
   }
 
   return rc;
@@ -1235,6 +3265,7 @@ static ssize_t builtin_posix_module_element_write_strided_internal (builtin_posi
       POSIX_TRACE_CALL(posix_dataset, ret = hioi_file_write (file, ptr, actual), "file_write", offset, actual);
       if (ret > 0) {
         bytes_written += ret;
+        builtin_posix_write_behind (posix_dataset, file, file->f_offset - ret, ret);
       }
 
       if (ret < actual) {
@@ -1263,8 +3294,9 @@ static ssize_t builtin_posix_module_element_write_strided_internal (builtin_posi
     return rc;
   }
 
-  if (offset + bytes_written > element->e_size) {
-    element->e_size = offset + bytes_written;
+  /* offset was advanced past the last byte written */
+  if (offset > element->e_size) {
+    element->e_size = offset;
   }
 
   stop = hioi_gettime ();
@@ -1386,9 +3418,7 @@ static int builtin_posix_module_process_reqs (hio_dataset_t dataset, hio_interna
       }
 
       req->ir_urequest[0] = new_request;
-      new_request->req_transferred = req->ir_status;
-      new_request->req_complete = true;
-      new_request->req_status = HIO_SUCCESS;
+      hioi_request_complete (new_request, req->ir_status, HIO_SUCCESS);
     }
 
     if (req->ir_status < 0) {
@@ -1406,6 +3436,375 @@ static int builtin_posix_module_process_reqs (hio_dataset_t dataset, hio_interna
   return rc;
 }
 
+/**
+ * Start write-back of the data written to a file
+ *
+ * @param[in] posix_dataset posix dataset
+ * @param[in] file          file that was written
+ * @param[in] offset        file offset of the write
+ * @param[in] count         number of bytes written
+ *
+ * Once ds_write_behind bytes have accumulated the kernel is asked to start writing the range
+ * without waiting for it. This spreads the write-back over the lifetime of the dataset so a
+ * complete flush has little left to do.
+ */
+static void builtin_posix_write_behind (builtin_posix_module_dataset_t *posix_dataset, hio_file_t *file,
+                                        uint64_t offset, size_t count) {
+  file->f_dirty = true;
+
+#if defined(HAVE_SYNC_FILE_RANGE)
+  if (0 == posix_dataset->ds_write_behind || -1 == file->f_fd) {
+    return;
+  }
+
+  if (file->f_wb_start == file->f_wb_end) {
+    file->f_wb_start = offset;
+    file->f_wb_end = offset + count;
+  } else {
+    if (offset < file->f_wb_start) {
+      file->f_wb_start = offset;
+    }
+
+    if (offset + count > file->f_wb_end) {
+      file->f_wb_end = offset + count;
+    }
+  }
+
+  if (file->f_wb_end - file->f_wb_start >= posix_dataset->ds_write_behind) {
+    POSIX_TRACE_CALL(posix_dataset, (void) sync_file_range (file->f_fd, file->f_wb_start, file->f_wb_end - file->f_wb_start,
+                                                            SYNC_FILE_RANGE_WRITE), "write_behind", file->f_bid,
+                     file->f_wb_end - file->f_wb_start);
+    file->f_wb_start = file->f_wb_end = 0;
+  }
+#endif
+}
+
+/**
+ * Sync a data file to the backing store
+ *
+ * Files that have not been written since they were last synced are skipped. If requested the
+ * file is dropped from the page cache once its data is stable.
+ */
+static int builtin_posix_sync_file (builtin_posix_module_dataset_t *posix_dataset, hio_file_t *file) {
+  int fd;
+
+  if (!file->f_dirty) {
+    return HIO_SUCCESS;
+  }
+
+  if (NULL != file->f_hndl) {
+    fflush (file->f_hndl);
+    fd = fileno (file->f_hndl);
+  } else {
+    fd = file->f_fd;
+  }
+
+  if (-1 == fd) {
+    return HIO_SUCCESS;
+  }
+
+  if (fsync (fd)) {
+    return hioi_err_errno (errno);
+  }
+
+  file->f_dirty = false;
+  file->f_wb_start = file->f_wb_end = 0;
+
+#if defined(HAVE_POSIX_FADVISE)
+  if (posix_dataset->ds_drop_cache) {
+    (void) posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+  }
+#endif
+
+  return HIO_SUCCESS;
+}
+
+typedef struct builtin_posix_sync_list_t {
+  builtin_posix_module_dataset_t *sl_dataset;
+  hio_file_t                    **sl_files;
+  size_t                          sl_count;
+  atomic_size_t                   sl_next;
+  atomic_int                      sl_rc;
+} builtin_posix_sync_list_t;
+
+static void *builtin_posix_sync_thread (void *arg) {
+  builtin_posix_sync_list_t *list = (builtin_posix_sync_list_t *) arg;
+  size_t index;
+
+  while ((index = atomic_fetch_add (&list->sl_next, 1)) < list->sl_count) {
+    int rc = builtin_posix_sync_file (list->sl_dataset, list->sl_files[index]);
+    if (HIO_SUCCESS != rc) {
+      atomic_store (&list->sl_rc, rc);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Collect the open data files of a dataset that have been written since they were last synced
+ *
+ * @param[in]  posix_dataset posix dataset
+ * @param[out] files_out     dirty files (free with free())
+ * @param[out] count_out     number of dirty files
+ */
+static int builtin_posix_dirty_files (builtin_posix_module_dataset_t *posix_dataset, hio_file_t ***files_out,
+                                      size_t *count_out) {
+  hio_dataset_t dataset = &posix_dataset->base;
+  size_t max_count = 0, count = 0;
+  hio_element_t element;
+  hio_file_t **files;
+
+  if (posix_dataset->ds_files) {
+    max_count += posix_dataset->ds_max_open_files;
+  }
+
+  hioi_list_foreach(element, dataset->ds_elist, struct hio_element, e_list) {
+    ++max_count;
+  }
+
+  files = calloc (max_count ? max_count : 1, sizeof (files[0]));
+  if (NULL == files) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  for (size_t i = 0 ; posix_dataset->ds_files && i < posix_dataset->ds_max_open_files ; ++i) {
+    hio_file_t *file = &posix_dataset->ds_files[i].pf_file;
+    if (file->f_bid >= 0 && file->f_dirty) {
+      files[count++] = file;
+    }
+  }
+
+  /* basic mode data is written to per-element files */
+  hioi_list_foreach(element, dataset->ds_elist, struct hio_element, e_list) {
+    if (element->e_file.f_dirty && (NULL != element->e_file.f_hndl || -1 != element->e_file.f_fd)) {
+      files[count++] = &element->e_file;
+    }
+  }
+
+  *files_out = files;
+  *count_out = count;
+
+  return HIO_SUCCESS;
+}
+
+/**
+ * Sync a list of data files
+ *
+ * fsync waits for the backing store so the files are synced by up to ds_flush_threads
+ * threads at the same time.
+ */
+static int builtin_posix_sync_list (builtin_posix_module_dataset_t *posix_dataset, hio_file_t **files, size_t count) {
+  builtin_posix_sync_list_t list = {.sl_dataset = posix_dataset, .sl_files = files, .sl_count = count};
+  unsigned thread_count = posix_dataset->ds_flush_threads, started = 0;
+  pthread_t *threads = NULL;
+
+  if (0 == count) {
+    return HIO_SUCCESS;
+  }
+
+  atomic_init (&list.sl_next, 0);
+  atomic_init (&list.sl_rc, HIO_SUCCESS);
+
+  if (thread_count > count) {
+    thread_count = count;
+  }
+
+  if (thread_count > 1) {
+    threads = calloc (thread_count - 1, sizeof (*threads));
+  }
+
+  for (unsigned i = 0 ; threads && i < thread_count - 1 ; ++i) {
+    if (pthread_create (threads + i, NULL, builtin_posix_sync_thread, &list)) {
+      break;
+    }
+    ++started;
+  }
+
+  /* this thread participates as well */
+  (void) builtin_posix_sync_thread (&list);
+
+  for (unsigned i = 0 ; i < started ; ++i) {
+    pthread_join (threads[i], NULL);
+  }
+
+  free (threads);
+
+  return atomic_load (&list.sl_rc);
+}
+
+/**
+ * Sync all open data files of a dataset
+ */
+static int builtin_posix_sync_files (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_file_t **files;
+  size_t count;
+  int rc;
+
+  rc = builtin_posix_dirty_files (posix_dataset, &files, &count);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  rc = builtin_posix_sync_list (posix_dataset, files, count);
+  free (files);
+
+  return rc;
+}
+
+/**
+ * Sync the file systems holding the data roots of a dataset
+ */
+static int builtin_posix_syncfs_roots (builtin_posix_module_dataset_t *posix_dataset) {
+#if defined(HAVE_SYNCFS)
+  for (int i = 0 ; i < posix_dataset->ds_root_count ; ++i) {
+    int dirfd = builtin_posix_data_dir (posix_dataset, i, NULL);
+    if (0 > dirfd) {
+      return dirfd;
+    }
+
+    if (syncfs (dirfd)) {
+      return hioi_err_errno (errno);
+    }
+  }
+
+  return HIO_SUCCESS;
+#else
+  return HIO_ERR_NOT_AVAILABLE;
+#endif
+}
+
+/**
+ * Sync the data of all ranks on a node with as few syncfs calls as possible
+ *
+ * A rank needs a syncfs that started after its data was written. Ranks that find a sync
+ * already in progress wait for it to finish and then for the next one, which may be issued
+ * on behalf of several ranks. Without a shared control block each rank syncs on its own.
+ */
+static int builtin_posix_syncfs (builtin_posix_module_dataset_t *posix_dataset) {
+  hio_shared_control_t *control = posix_dataset->base.ds_shared_control;
+  unsigned long ticket;
+  int rc = HIO_SUCCESS;
+
+  if (NULL == control) {
+    return builtin_posix_syncfs_roots (posix_dataset);
+  }
+
+  ticket = atomic_load (&control->s_sync_started);
+
+  while (atomic_load (&control->s_sync_completed) <= ticket) {
+    int unlocked = 0;
+
+    if (!atomic_compare_exchange_strong (&control->s_sync_lock, &unlocked, 1)) {
+      usleep (100);
+      continue;
+    }
+
+    if (atomic_load (&control->s_sync_completed) <= ticket) {
+      unsigned long generation = atomic_fetch_add (&control->s_sync_started, 1) + 1;
+
+      rc = builtin_posix_syncfs_roots (posix_dataset);
+      if (HIO_SUCCESS == rc) {
+        atomic_store (&control->s_sync_completed, generation);
+        ++posix_dataset->ds_syncfs_count;
+      }
+    }
+
+    atomic_store (&control->s_sync_lock, 0);
+
+    if (HIO_SUCCESS != rc) {
+      break;
+    }
+  }
+
+  return rc;
+}
+
+/**
+ * Return (and clear) any error from syncing data files evicted from the file cache
+ */
+static int builtin_posix_evict_rc (builtin_posix_module_dataset_t *posix_dataset) {
+  int rc = posix_dataset->ds_evict_rc;
+
+  posix_dataset->ds_evict_rc = HIO_SUCCESS;
+
+  return rc;
+}
+
+/**
+ * Flush all data files of the dataset to the backing store
+ *
+ * Called before the elements of the dataset are flushed. When many files are dirty on a
+ * posix-like (local) file system a single node-coordinated syncfs of the data roots is
+ * cheaper than an fsync of each file. Otherwise the dirty files are synced in parallel.
+ * Files synced here are skipped when the elements are flushed.
+ */
+static int builtin_posix_module_dataset_flush (hio_dataset_t dataset, hio_flush_mode_t mode) {
+  builtin_posix_module_dataset_t *posix_dataset = (builtin_posix_module_dataset_t *) dataset;
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  uint64_t start = hioi_gettime ();
+  hio_file_t **files;
+  size_t count;
+  bool use_syncfs;
+  int rc;
+
+  if (!(dataset->ds_flags & HIO_FLAG_WRITE)) {
+    return HIO_ERR_PERM;
+  }
+
+  if (HIO_FLUSH_MODE_COMPLETE != mode) {
+    return HIO_SUCCESS;
+  }
+
+  rc = builtin_posix_dirty_files (posix_dataset, &files, &count);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+#if defined(HAVE_SYNCFS)
+  /* files closed since the last flush were not synced and are only covered by syncfs */
+  use_syncfs = posix_dataset->ds_syncfs_threshold && HIO_FS_TYPE_DEFAULT == dataset->ds_fsattr.fs_type &&
+    count + posix_dataset->ds_dirty_closed >= posix_dataset->ds_syncfs_threshold;
+#else
+  use_syncfs = false;
+#endif
+
+  if (use_syncfs) {
+    rc = builtin_posix_syncfs (posix_dataset);
+    if (HIO_SUCCESS == rc) {
+      for (size_t i = 0 ; i < count ; ++i) {
+        files[i]->f_dirty = false;
+        files[i]->f_wb_start = files[i]->f_wb_end = 0;
+#if defined(HAVE_POSIX_FADVISE)
+        if (posix_dataset->ds_drop_cache && -1 != files[i]->f_fd) {
+          (void) posix_fadvise (files[i]->f_fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+#endif
+      }
+    }
+  } else {
+    rc = builtin_posix_sync_list (posix_dataset, files, count);
+  }
+
+  if (HIO_SUCCESS == rc) {
+    /* closed files only count towards the syncfs threshold of the flush that follows them */
+    posix_dataset->ds_dirty_closed = 0;
+  }
+
+  free (files);
+
+  if (HIO_SUCCESS == rc) {
+    rc = builtin_posix_evict_rc (posix_dataset);
+  }
+
+  posix_dataset->ds_flush_time += hioi_gettime () - start;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "posix: flushed %lu dirty file(s) using %s in %" PRIu64 " usec. rc: %d",
+            (unsigned long) count, use_syncfs ? "syncfs" : "fsync", hioi_gettime () - start, rc);
+
+  return rc;
+}
+
 static int builtin_posix_module_element_flush (hio_element_t element, hio_flush_mode_t mode) {
   builtin_posix_module_dataset_t *posix_dataset =
     (builtin_posix_module_dataset_t *) hioi_element_dataset (element);
@@ -1420,14 +3819,11 @@ static int builtin_posix_module_element_flush (hio_element_t element, hio_flush_
   }
 
   if (HIO_FILE_MODE_BASIC != posix_dataset->ds_fmode) {
-    for (int i = 0 ; i < HIO_POSIX_MAX_OPEN_FILES ; ++i) {
-      hioi_file_flush (posix_dataset->files + i);
-    }
-  } else {
-    hioi_file_flush (&element->e_file);
+    int rc = builtin_posix_sync_files (posix_dataset);
+    return (HIO_SUCCESS == rc) ? builtin_posix_evict_rc (posix_dataset) : rc;
   }
 
-  return HIO_SUCCESS;
+  return builtin_posix_sync_file (posix_dataset, &element->e_file);
 }
 
 static int builtin_posix_module_element_complete (hio_element_t element) {
@@ -1442,10 +3838,77 @@ static int builtin_posix_module_element_complete (hio_element_t element) {
   return HIO_SUCCESS;
 }
 
+#if defined(HAVE_POSIX_FADVISE)
+static int builtin_posix_file_willneed (hio_file_t *file, uint64_t offset, uint64_t length) {
+  int fd = (NULL != file->f_hndl) ? fileno (file->f_hndl) : file->f_fd;
+
+  if (0 > fd) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  return hioi_err_errno (posix_fadvise (fd, (off_t) offset, (off_t) length, POSIX_FADV_WILLNEED));
+}
+
+/**
+ * Ask the kernel to start reading the data of an element
+ *
+ * Basic mode elements are a single file. In optimized and packed modes only the file ranges
+ * listed in the segments of the element are requested. Strided elements have no segment
+ * list and are not prefetched.
+ */
+static int builtin_posix_module_element_prefetch (hio_element_t element) {
+  builtin_posix_module_dataset_t *posix_dataset =
+    (builtin_posix_module_dataset_t *) hioi_element_dataset (element);
+  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) posix_dataset->base.ds_module;
+  hio_context_t context = hioi_object_context (&element->e_object);
+  uint64_t start = hioi_gettime ();
+  int rc = HIO_SUCCESS;
+
+  if (HIO_FILE_MODE_BASIC == posix_dataset->ds_fmode) {
+    rc = builtin_posix_file_willneed (&element->e_file, 0, 0);
+  } else if (HIO_FILE_MODE_STRIDED != posix_dataset->ds_fmode) {
+    for (size_t i = 0 ; i < element->e_scount ; ++i) {
+      hio_manifest_segment_t *segment = element->e_sarray + i;
+      hio_file_t *file;
+
+      rc = builtin_posix_file_get (posix_module, posix_dataset, NULL, segment->seg_file_index, &file);
+      if (HIO_SUCCESS != rc) {
+        break;
+      }
+
+      rc = builtin_posix_file_willneed (file, segment->seg_foffset, segment->seg_length);
+      if (HIO_SUCCESS != rc) {
+        break;
+      }
+    }
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "posix: prefetched element %s in %" PRIu64 " usec. rc: %d",
+            hioi_object_identifier (element), hioi_gettime () - start, rc);
+
+  return rc;
+}
+#endif
+
 static int builtin_posix_module_fini (struct hio_module_t *module) {
+  builtin_posix_module_t *posix_module = (builtin_posix_module_t *) module;
+
   hioi_log (module->context, HIO_VERBOSE_DEBUG_LOW, "posix: finalizing module for data root %s",
 	    module->data_root);
 
+  /* finish removing any datasets in the trash */
+  pthread_mutex_lock (&posix_module->pm_unlink_lock);
+  posix_module->pm_unlink_shutdown = true;
+  pthread_cond_broadcast (&posix_module->pm_unlink_cond);
+  pthread_mutex_unlock (&posix_module->pm_unlink_lock);
+
+  if (posix_module->pm_unlink_running) {
+    pthread_join (posix_module->pm_unlink_thread, NULL);
+  }
+
+  pthread_cond_destroy (&posix_module->pm_unlink_cond);
+  pthread_mutex_destroy (&posix_module->pm_unlink_lock);
+
   free (module->data_root);
   free (module);
 
@@ -1477,7 +3940,8 @@ static int builtin_posix_component_query (hio_context_t context, const char *dat
 					  const char *next_data_root, hio_module_t **module) {
   builtin_posix_module_t *new_module;
 
-  if (0 == strncasecmp("datawarp", data_root, 8) || 0 == strncasecmp("dw", data_root, 2)) {
+  if (0 == strncasecmp("datawarp", data_root, 8) || 0 == strncasecmp("dw", data_root, 2) ||
+      0 == strncasecmp("stage:", data_root, 6)) {
     return HIO_ERR_NOT_AVAILABLE;
   }
 
@@ -1502,6 +3966,9 @@ static int builtin_posix_component_query (hio_context_t context, const char *dat
   new_module->base.data_root = strdup (data_root);
   new_module->base.context = context;
 
+  pthread_mutex_init (&new_module->pm_unlink_lock, NULL);
+  pthread_cond_init (&new_module->pm_unlink_cond, NULL);
+
   /* get the current umask */
   new_module->access_mode = umask (0);
   umask (new_module->access_mode);
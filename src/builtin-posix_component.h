@@ -25,20 +25,116 @@ typedef enum builtin_posix_dataset_fmode {
   HIO_FILE_MODE_OPTIMIZED,
   /** write block across multiple files */
   HIO_FILE_MODE_STRIDED,
+  /** each rank appends all of its elements to a single container file. only supported with
+   * unique address spaces */
+  HIO_FILE_MODE_PACKED,
 } builtin_posix_dataset_fmode_t;
 
+/** distribution of optimized mode data files over the posix data roots of a context */
+typedef enum builtin_posix_root_spread {
+  /** all data files are written to the data root the dataset is opened from */
+  HIO_POSIX_ROOT_SPREAD_NONE,
+  /** each node writes its data file to one of the data roots */
+  HIO_POSIX_ROOT_SPREAD_NODE,
+  /** each node writes one data file per data root and rotates blocks over them */
+  HIO_POSIX_ROOT_SPREAD_BLOCK,
+} builtin_posix_root_spread_t;
+
+/** number of tuning configurations remembered for each dataset name */
+#define HIO_POSIX_TUNE_HISTORY    16
+
 /* data types */
+typedef struct builtin_posix_tune_point_t {
+  /** stripe size */
+  uint64_t tp_ssize;
+  /** stripe count */
+  uint64_t tp_scount;
+  /** optimized mode block size */
+  uint64_t tp_bs;
+  /** aggregation buffer size */
+  uint64_t tp_buffer_size;
+  /** weighted average write bandwidth seen with this configuration (bytes/sec) */
+  uint64_t tp_bandwidth;
+  /** number of dataset instances written with this configuration */
+  uint64_t tp_samples;
+} builtin_posix_tune_point_t;
+
+/** tuning history kept for each dataset name (see hioi_dbd_alloc) */
+typedef struct builtin_posix_dataset_backend_data_t {
+  hio_dataset_backend_data_t base;
+
+  /** configurations tried so far */
+  builtin_posix_tune_point_t pd_points[HIO_POSIX_TUNE_HISTORY];
+  /** number of valid entries in pd_points */
+  int      pd_count;
+  /** number of neighbor configurations considered so far */
+  uint64_t pd_explored;
+} builtin_posix_dataset_backend_data_t;
+
+/** entry in the open file cache used by strided and optimized file modes */
+typedef struct builtin_posix_file_t {
+  /** open file. f_bid and f_element identify the cached file (f_bid < 0: unused) */
+  hio_file_t pf_file;
+  /** value of the dataset file clock when this file was last used */
+  uint64_t   pf_last_use;
+} builtin_posix_file_t;
+
 typedef struct builtin_posix_module_t {
   hio_module_t base;
   mode_t access_mode;
+
+  /** protects the background unlink state */
+  pthread_mutex_t pm_unlink_lock;
+  /** signaled when datasets are moved to the trash directory or the module is finalized */
+  pthread_cond_t  pm_unlink_cond;
+  /** background unlink thread (started on first use) */
+  pthread_t       pm_unlink_thread;
+  bool            pm_unlink_running;
+  /** the trash directory has datasets waiting to be removed */
+  bool            pm_unlink_pending;
+  /** the module is being finalized */
+  bool            pm_unlink_shutdown;
 } builtin_posix_module_t;
 
 typedef struct builtin_posix_module_dataset_t {
   /** base type */
   struct hio_dataset base;
 
-  /** open backing files */
-  hio_file_t files[HIO_POSIX_MAX_OPEN_FILES];
+  /** open backing files (least recently used file is closed first) */
+  builtin_posix_file_t *ds_files;
+
+  /** maximum number of backing files to keep open */
+  uint64_t ds_max_open_files;
+
+  /** clock used to order file cache entries by last use */
+  uint64_t ds_file_clock;
+
+  /** number of backing file opens caused by file cache misses */
+  uint64_t ds_file_opens;
+
+  /** time spent syncing data files (usec) */
+  uint64_t ds_flush_time;
+
+  /** number of syncfs calls made by this rank */
+  uint64_t ds_syncfs_count;
+
+  /** number of element files closed since the last complete flush without being synced */
+  uint64_t ds_dirty_closed;
+
+  /** directory containing the backing files in each data root (-1 if not yet opened) */
+  int ds_data_dirfd[HIO_MAX_DATA_ROOTS];
+
+  /** distribution of data files over data roots (optimized mode) */
+  builtin_posix_root_spread_t ds_root_spread;
+
+  /** number of data roots holding data files. data file i is in data root i % ds_root_count */
+  int ds_root_count;
+
+  /** data root of the current reservation */
+  int ds_reserved_root;
+
+  /** data root to use for the next reservation */
+  int ds_next_root;
 
   /** base path of this manifest */
   char *base_path;
@@ -51,9 +147,36 @@ typedef struct builtin_posix_module_dataset_t {
   /** space left in reserved file region */
   uint64_t reserved_remaining;
 
+  /** end of the data this rank has appended to its container file (packed mode) */
+  uint64_t ds_packed_offset;
+
+  /** size of the sub-blocks small reservations are rounded to (0: always reserve full blocks) */
+  uint64_t ds_sub_block_size;
+
+  /** space this rank has reserved from shared sub-blocks. once this reaches the block
+   * size the rank reserves full blocks */
+  uint64_t ds_sub_reserved;
+
+  /** preallocate blocks that will be completely filled by a write */
+  bool ds_preallocate;
+
+  /** file region to preallocate once the data file is open (size 0: none) */
+  uint64_t ds_prealloc_offset;
+  uint64_t ds_prealloc_size;
+
   /** stripe this rank should write */
   int my_stripe;
 
+  /** give each rank on a node its own stripe in optimized mode */
+  bool ds_stripe_exclusive;
+
+  /** number of stripes blocks are distributed over in optimized mode. each rank on a node
+   * only reserves blocks on stripe my_stripe (1: no stripe exclusivity) */
+  int ds_stripe_count;
+
+  /** number of stripes to simulate on filesystems without striping support (testing) */
+  uint32_t ds_simulate_stripes;
+
   /** use bzip2 to compress data manifests */
   bool                ds_use_bzip;
 
@@ -68,6 +191,40 @@ typedef struct builtin_posix_module_dataset_t {
 
   /** trace file */
   FILE               *ds_trace_fh;
+
+  /** number of instances of this dataset to keep after a successful close (0: keep all) */
+  uint32_t            ds_keep_last;
+
+  /** maximum number of ranks per node creating basic mode element files at the same time
+   * (0: no limit) */
+  uint32_t            ds_create_concurrency;
+
+  /** number of threads used to sync data files during a complete flush */
+  uint32_t            ds_flush_threads;
+
+  /** minimum number of dirty files for which syncfs is used instead of fsync (0: never) */
+  uint32_t            ds_syncfs_threshold;
+
+  /** start write-back of a data file once this many bytes have been written to it since the
+   * last write-back (0: disabled) */
+  uint64_t            ds_write_behind;
+
+  /** drop the page cache of data files once they have been synced */
+  bool                ds_drop_cache;
+
+  /** error syncing a data file evicted from the file cache. returned by the next complete flush */
+  int                 ds_evict_rc;
+
+  /** choose striping, block, and buffer sizes from the history of this dataset */
+  bool                ds_autotune;
+  /** keep the tuning history in the data root */
+  bool                ds_autotune_persist;
+  /** number of neighbor configurations that may be considered */
+  uint64_t            ds_autotune_explore;
+  /** configuration chosen for this instance */
+  builtin_posix_tune_point_t ds_tune;
+  /** bandwidth predicted for this instance (bytes/sec, 0 if unknown) */
+  uint64_t            ds_tune_predicted;
 } builtin_posix_module_dataset_t;
 
 extern hio_component_t builtin_posix_component;
@@ -0,0 +1,1023 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2014-2016 Los Alamos National Security, LLC.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/* tiered staging is a posix+ interface. datasets are written to a fast data root
+ * (node-local flash, tmpfs, etc) and copied to the following persistent data root
+ * by background threads after the dataset is closed. */
+#include "builtin-posix_component.h"
+#include "hio_internal.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include <sys/stat.h>
+
+/** size of the bounce buffer used when copy_file_range is not available */
+#define BUILTIN_STAGE_COPY_BUFFER_SIZE (1ul << 20)
+
+/** interval between checks for the other processes staging a dataset instance (usec) */
+#define BUILTIN_STAGE_PUBLISH_INTERVAL 10000
+
+/** stage request for a dataset instance */
+typedef struct builtin_stage_job_t {
+  /** next job in the stage queue */
+  struct builtin_stage_job_t *sj_next;
+  /** dataset directory on the fast data root */
+  char    *sj_fast_path;
+  /** dataset directory on the persistent data root */
+  char    *sj_slow_path;
+  /** dataset name */
+  char    *sj_name;
+  /** dataset identifier */
+  int64_t  sj_id;
+  /** number of processes staging this dataset instance */
+  int      sj_stager_count;
+  /** rank of this process (names the completion marker) */
+  int      sj_rank;
+  /** publish the top-level manifest once all processes have staged their files */
+  bool     sj_publish;
+  /** number of staged instances of this dataset to keep on the fast data root */
+  uint32_t sj_keep;
+  /** maximum time to wait for the other processes before giving up on publishing (seconds) */
+  uint32_t sj_timeout;
+  /** this process has staged its files. the job is waiting to publish the instance */
+  bool     sj_staged;
+  /** time the job was first run (usec) */
+  uint64_t sj_start;
+  /** time after which publishing is abandoned (usec) */
+  uint64_t sj_deadline;
+  /** the job is not run again before this time (usec) */
+  uint64_t sj_next_check;
+} builtin_stage_job_t;
+
+/**
+ * builtin stage module
+ *
+ * This module is a thin wrapper around the posix module. In addition to the
+ * posix module members it keeps track of the original open/fini functions,
+ * the persistent data root, and the state of the staging engine.
+ */
+typedef struct builtin_stage_module_t {
+  builtin_posix_module_t posix_module;
+  hio_module_dataset_open_fn_t posix_open;
+  hio_module_fini_fn_t posix_fini;
+  /** persistent data root datasets are staged to */
+  char *slow_root;
+
+  /** protects the stage queue */
+  pthread_mutex_t sm_lock;
+  /** signaled when a job is queued or the module is finalized */
+  pthread_cond_t  sm_cond;
+  /** stage queue */
+  builtin_stage_job_t *sm_head, *sm_tail;
+  /** stage threads (started on first use) */
+  pthread_t *sm_threads;
+  /** number of stage threads */
+  int sm_thread_count;
+  /** the module is being finalized. threads exit once the queue is empty */
+  bool sm_shutdown;
+} builtin_stage_module_t;
+
+typedef struct builtin_stage_module_dataset_t {
+  builtin_posix_module_dataset_t posix_dataset;
+  /** stage this dataset instance to the persistent data root */
+  bool stage_enable;
+  /** number of staged instances to keep on the fast data root */
+  uint32_t stage_keep;
+  /** number of stage threads to start */
+  uint32_t stage_threads;
+  /** publish timeout (seconds) */
+  uint32_t stage_timeout;
+
+  hio_dataset_close_fn_t posix_ds_close;
+} builtin_stage_module_dataset_t;
+
+static int builtin_stage_module_dataset_close (hio_dataset_t dataset);
+
+static void builtin_stage_job_free (builtin_stage_job_t *job) {
+  free (job->sj_fast_path);
+  free (job->sj_slow_path);
+  free (job->sj_name);
+  free (job);
+}
+
+/**
+ * Copy a single file
+ *
+ * @param[in] src        source path
+ * @param[in] dst        destination path
+ * @param[in] mode       access mode for the new file
+ * @param[in] exclusive  skip the file if the destination already exists. this ensures each
+ *                       file is only copied once when several processes share a fast data root
+ */
+static int builtin_stage_copy_file (const char *src, const char *dst, mode_t mode, bool exclusive) {
+  int in_fd, out_fd, rc = HIO_SUCCESS;
+  off_t in_off = 0, out_off = 0;
+  struct stat statinfo;
+  char *buffer = NULL;
+
+  in_fd = open (src, O_RDONLY);
+  if (0 > in_fd) {
+    return hioi_err_errno (errno);
+  }
+
+  out_fd = open (dst, O_WRONLY | O_CREAT | (exclusive ? O_EXCL : O_TRUNC), mode);
+  if (0 > out_fd) {
+    rc = (exclusive && EEXIST == errno) ? HIO_SUCCESS : hioi_err_errno (errno);
+    close (in_fd);
+    return rc;
+  }
+
+  if (fstat (in_fd, &statinfo)) {
+    rc = hioi_err_errno (errno);
+  }
+
+  while (HIO_SUCCESS == rc && in_off < statinfo.st_size) {
+    ssize_t bytes = -1;
+
+#if defined(HAVE_COPY_FILE_RANGE)
+    if (NULL == buffer) {
+      bytes = copy_file_range (in_fd, &in_off, out_fd, &out_off, statinfo.st_size - in_off, 0);
+      if (0 > bytes && (ENOSYS == errno || EXDEV == errno || EINVAL == errno || EOPNOTSUPP == errno)) {
+        /* not supported between these file systems. fall back on read/write */
+        bytes = -1;
+        errno = 0;
+      } else if (0 > bytes) {
+        rc = hioi_err_errno (errno);
+        break;
+      }
+    }
+#endif
+
+    if (0 > bytes) {
+      if (NULL == buffer) {
+        buffer = malloc (BUILTIN_STAGE_COPY_BUFFER_SIZE);
+        if (NULL == buffer) {
+          rc = HIO_ERR_OUT_OF_RESOURCE;
+          break;
+        }
+      }
+
+      bytes = pread (in_fd, buffer, BUILTIN_STAGE_COPY_BUFFER_SIZE, in_off);
+      if (0 < bytes) {
+        bytes = pwrite (out_fd, buffer, bytes, out_off);
+      }
+
+      if (0 > bytes) {
+        rc = hioi_err_errno (errno);
+        break;
+      }
+
+      in_off += bytes;
+      out_off += bytes;
+    }
+
+    if (0 == bytes) {
+      /* the file was truncated while copying */
+      break;
+    }
+  }
+
+  free (buffer);
+
+  /* the copy must be durable before the dataset is published */
+  if (HIO_SUCCESS == rc && fsync (out_fd)) {
+    rc = hioi_err_errno (errno);
+  }
+
+  close (out_fd);
+  close (in_fd);
+
+  return rc;
+}
+
+/**
+ * Recursively copy a dataset directory
+ *
+ * The top-level manifest is skipped. It is copied last by builtin_stage_publish.
+ */
+static int builtin_stage_copy_tree (const char *src, const char *dst, mode_t mode, bool top) {
+  int rc = HIO_SUCCESS;
+  struct dirent *entry;
+  DIR *dir;
+
+  dir = opendir (src);
+  if (NULL == dir) {
+    return hioi_err_errno (errno);
+  }
+
+  while (HIO_SUCCESS == rc && NULL != (entry = readdir (dir))) {
+    char *src_path, *dst_path;
+    struct stat statinfo;
+
+    if (0 == strcmp (entry->d_name, ".") || 0 == strcmp (entry->d_name, "..") ||
+        (top && 0 == strcmp (entry->d_name, "manifest.json"))) {
+      continue;
+    }
+
+    if (0 > asprintf (&src_path, "%s/%s", src, entry->d_name)) {
+      rc = HIO_ERR_OUT_OF_RESOURCE;
+      break;
+    }
+
+    if (0 > asprintf (&dst_path, "%s/%s", dst, entry->d_name)) {
+      free (src_path);
+      rc = HIO_ERR_OUT_OF_RESOURCE;
+      break;
+    }
+
+    if (lstat (src_path, &statinfo)) {
+      rc = hioi_err_errno (errno);
+    } else if (S_ISDIR(statinfo.st_mode)) {
+      if (mkdir (dst_path, mode) && EEXIST != errno) {
+        rc = hioi_err_errno (errno);
+      } else {
+        rc = builtin_stage_copy_tree (src_path, dst_path, mode, false);
+      }
+    } else if (S_ISREG(statinfo.st_mode)) {
+      rc = builtin_stage_copy_file (src_path, dst_path, mode & 0666, true);
+    }
+
+    free (src_path);
+    free (dst_path);
+  }
+
+  closedir (dir);
+
+  return rc;
+}
+
+/**
+ * Recursively remove a directory. Entries removed by another process are ignored.
+ */
+static void builtin_stage_remove_tree (const char *path) {
+  struct dirent *entry;
+  DIR *dir;
+
+  dir = opendir (path);
+  if (NULL == dir) {
+    return;
+  }
+
+  while (NULL != (entry = readdir (dir))) {
+    struct stat statinfo;
+    char *child;
+
+    if (0 == strcmp (entry->d_name, ".") || 0 == strcmp (entry->d_name, "..")) {
+      continue;
+    }
+
+    if (0 > asprintf (&child, "%s/%s", path, entry->d_name)) {
+      break;
+    }
+
+    if (0 == lstat (child, &statinfo) && S_ISDIR(statinfo.st_mode)) {
+      builtin_stage_remove_tree (child);
+    } else {
+      (void) unlink (child);
+    }
+
+    free (child);
+  }
+
+  closedir (dir);
+  (void) rmdir (path);
+}
+
+/**
+ * Count the completion markers left by the processes staging a dataset instance
+ */
+static int builtin_stage_count_markers (const char *path, int *staged, int *failed) {
+  struct dirent *entry;
+  DIR *dir;
+
+  *staged = *failed = 0;
+
+  dir = opendir (path);
+  if (NULL == dir) {
+    return hioi_err_errno (errno);
+  }
+
+  while (NULL != (entry = readdir (dir))) {
+    if (0 == strncmp (entry->d_name, ".staged.", 8)) {
+      ++*staged;
+    } else if (0 == strncmp (entry->d_name, ".failed.", 8)) {
+      ++*failed;
+    }
+  }
+
+  closedir (dir);
+
+  return HIO_SUCCESS;
+}
+
+static void builtin_stage_remove_markers (const char *path) {
+  struct dirent *entry;
+  char *marker;
+  DIR *dir;
+
+  dir = opendir (path);
+  if (NULL == dir) {
+    return;
+  }
+
+  while (NULL != (entry = readdir (dir))) {
+    if (strncmp (entry->d_name, ".staged.", 8)) {
+      continue;
+    }
+
+    if (0 < asprintf (&marker, "%s/%s", path, entry->d_name)) {
+      (void) unlink (marker);
+      free (marker);
+    }
+  }
+
+  closedir (dir);
+}
+
+static int builtin_stage_sync_dir (const char *path) {
+  int fd, rc = HIO_SUCCESS;
+
+  fd = open (path, O_RDONLY | O_DIRECTORY);
+  if (0 > fd) {
+    return hioi_err_errno (errno);
+  }
+
+  if (fsync (fd)) {
+    rc = hioi_err_errno (errno);
+  }
+
+  close (fd);
+
+  return rc;
+}
+
+/**
+ * Publish a staged dataset instance
+ *
+ * Copies the top-level manifest once all processes staging the instance have finished.
+ * Datasets are only listed on the persistent data root once the top-level manifest
+ * exists so it is renamed into place after the copy is durable.
+ *
+ * @returns HIO_ERR_NOT_AVAILABLE if other processes are still staging the instance
+ */
+static int builtin_stage_publish (builtin_stage_module_t *stage_module, builtin_stage_job_t *job) {
+  hio_context_t context = stage_module->posix_module.base.context;
+  mode_t mode = stage_module->posix_module.access_mode;
+  char *src = NULL, *tmp = NULL, *dst = NULL;
+  int rc, staged, failed;
+
+  rc = builtin_stage_count_markers (job->sj_slow_path, &staged, &failed);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  if (failed) {
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage: %d process(es) failed to stage dataset %s::%" PRId64
+              ". not publishing", failed, job->sj_name, job->sj_id);
+    return HIO_ERROR;
+  }
+
+  if (staged < job->sj_stager_count) {
+    if (job->sj_timeout && hioi_gettime () > job->sj_deadline) {
+      hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage: timed out waiting for dataset %s::%" PRId64
+                " to be staged. not publishing", job->sj_name, job->sj_id);
+      return HIO_ERR_TRUNCATE;
+    }
+
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  if (0 > asprintf (&src, "%s/manifest.json", job->sj_fast_path) ||
+      0 > asprintf (&tmp, "%s/.manifest.json.tmp", job->sj_slow_path) ||
+      0 > asprintf (&dst, "%s/manifest.json", job->sj_slow_path)) {
+    free (src);
+    free (tmp);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  rc = builtin_stage_copy_file (src, tmp, mode & 0666, false);
+  if (HIO_SUCCESS == rc && rename (tmp, dst)) {
+    rc = hioi_err_errno (errno);
+  }
+
+  if (HIO_SUCCESS == rc) {
+    rc = builtin_stage_sync_dir (job->sj_slow_path);
+  }
+
+  if (HIO_SUCCESS == rc) {
+    builtin_stage_remove_markers (job->sj_slow_path);
+  }
+
+  free (src);
+  free (tmp);
+  free (dst);
+
+  return rc;
+}
+
+static int builtin_stage_compare_ids (const void *a, const void *b) {
+  int64_t id_a = *(const int64_t *) a, id_b = *(const int64_t *) b;
+
+  /* newest (highest) identifier first */
+  return (id_a < id_b) - (id_a > id_b);
+}
+
+/**
+ * Evict old dataset instances from the fast data root
+ *
+ * Only instances that have been published on the persistent data root are candidates
+ * for eviction. The newest job->sj_keep of these are kept. The state is read from the
+ * file system so instances staged by earlier jobs (or processes) are also evicted.
+ */
+static void builtin_stage_evict (builtin_stage_module_t *stage_module, builtin_stage_job_t *job) {
+  hio_context_t context = stage_module->posix_module.base.context;
+  char *fast_dir, *slow_dir, *path, *tmp;
+  int64_t *ids = NULL;
+  size_t count = 0, size = 0;
+  struct dirent *entry;
+  DIR *dir;
+
+  fast_dir = strdup (job->sj_fast_path);
+  slow_dir = strdup (job->sj_slow_path);
+  if (NULL == fast_dir || NULL == slow_dir) {
+    free (fast_dir);
+    free (slow_dir);
+    return;
+  }
+
+  /* instance directories are named by dataset identifier under the dataset directory */
+  if (NULL != (tmp = strrchr (fast_dir, '/'))) {
+    *tmp = '\0';
+  }
+
+  if (NULL != (tmp = strrchr (slow_dir, '/'))) {
+    *tmp = '\0';
+  }
+
+  dir = opendir (fast_dir);
+  while (NULL != dir && NULL != (entry = readdir (dir))) {
+    int64_t id;
+
+    id = strtoll (entry->d_name, &tmp, 10);
+    if ('\0' != *tmp || tmp == entry->d_name) {
+      continue;
+    }
+
+    if (0 > asprintf (&path, "%s/%s/manifest.json", slow_dir, entry->d_name)) {
+      break;
+    }
+
+    if (0 == access (path, F_OK)) {
+      if (count == size) {
+        size = size ? size * 2 : 16;
+        tmp = realloc (ids, size * sizeof (*ids));
+        if (NULL == tmp) {
+          free (path);
+          break;
+        }
+        ids = (int64_t *) tmp;
+      }
+
+      ids[count++] = id;
+    }
+
+    free (path);
+  }
+
+  if (NULL != dir) {
+    closedir (dir);
+  }
+
+  if (count > job->sj_keep) {
+    qsort (ids, count, sizeof (*ids), builtin_stage_compare_ids);
+
+    for (size_t i = job->sj_keep ; i < count ; ++i) {
+      if (0 < asprintf (&path, "%s/%" PRId64, fast_dir, ids[i])) {
+        hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage: evicting staged dataset directory %s", path);
+        builtin_stage_remove_tree (path);
+        free (path);
+      }
+    }
+  }
+
+  free (ids);
+  free (fast_dir);
+  free (slow_dir);
+}
+
+/**
+ * Leave a marker telling the publishing process whether this process staged its data
+ */
+static int builtin_stage_mark (builtin_stage_module_t *stage_module, builtin_stage_job_t *job, bool staged) {
+  hio_context_t context = stage_module->posix_module.base.context;
+  mode_t mode = stage_module->posix_module.access_mode;
+  char *marker;
+  int rc = HIO_SUCCESS, fd;
+
+  if (0 > asprintf (&marker, "%s/.%s.%d", job->sj_slow_path, staged ? "staged" : "failed", job->sj_rank)) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  fd = open (marker, O_WRONLY | O_CREAT, mode & 0666);
+  if (0 <= fd) {
+    close (fd);
+  } else {
+    rc = hioi_err_errno (errno);
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage: could not create marker %s. errno: %d", marker, errno);
+  }
+
+  free (marker);
+
+  return rc;
+}
+
+/**
+ * Copy the files of a dataset instance this process is responsible for
+ */
+static int builtin_stage_copy (builtin_stage_module_t *stage_module, builtin_stage_job_t *job) {
+  hio_context_t context = stage_module->posix_module.base.context;
+  mode_t mode = stage_module->posix_module.access_mode;
+  int rc, marker_rc;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage: staging dataset %s::%" PRId64 " from %s to %s",
+            job->sj_name, job->sj_id, job->sj_fast_path, job->sj_slow_path);
+
+  rc = hio_mkpath (context, job->sj_slow_path, mode);
+  if (0 > rc && EEXIST != errno) {
+    rc = hioi_err_errno (errno);
+  } else {
+    rc = builtin_stage_copy_tree (job->sj_fast_path, job->sj_slow_path, mode, true);
+  }
+
+  /* tell the publishing process this process is done */
+  marker_rc = builtin_stage_mark (stage_module, job, HIO_SUCCESS == rc);
+  if (HIO_SUCCESS != marker_rc && HIO_SUCCESS == rc) {
+    /* the publisher would wait for a staged marker that never appears. fail the job locally (the
+     * fast copy is kept) and try to leave a failed marker so the publisher gives up */
+    rc = marker_rc;
+    marker_rc = builtin_stage_mark (stage_module, job, false);
+  }
+
+  if (HIO_SUCCESS != marker_rc) {
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage: could not report the staging status of dataset %s::%"
+              PRId64 " to the publishing process. it will wait up to %u seconds", job->sj_name, job->sj_id,
+              job->sj_timeout);
+  }
+
+  if (HIO_SUCCESS == rc) {
+    (void) builtin_stage_sync_dir (job->sj_slow_path);
+  }
+
+  return rc;
+}
+
+/**
+ * Run a stage job
+ *
+ * @returns true if the job is waiting for other processes to stage the instance. the job
+ *          must be run again once job->sj_next_check has passed
+ *
+ * The publishing process does not hold on to its stage thread while it waits for the
+ * other processes. The job is requeued instead so the thread can stage other datasets.
+ */
+static bool builtin_stage_run (builtin_stage_module_t *stage_module, builtin_stage_job_t *job) {
+  hio_context_t context = stage_module->posix_module.base.context;
+  int rc = HIO_SUCCESS;
+
+  if (!job->sj_staged) {
+    job->sj_start = hioi_gettime ();
+    rc = builtin_stage_copy (stage_module, job);
+    job->sj_staged = true;
+    job->sj_deadline = hioi_gettime () + (uint64_t) job->sj_timeout * 1000000;
+  }
+
+  if (HIO_SUCCESS == rc && job->sj_publish) {
+    rc = builtin_stage_publish (stage_module, job);
+    if (HIO_ERR_NOT_AVAILABLE == rc) {
+      job->sj_next_check = hioi_gettime () + BUILTIN_STAGE_PUBLISH_INTERVAL;
+      return true;
+    }
+  }
+
+  if (HIO_SUCCESS != rc) {
+    /* the fast copy is kept */
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage: error staging dataset %s::%" PRId64 " to %s. rc: %d",
+              job->sj_name, job->sj_id, job->sj_slow_path, rc);
+    return false;
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage: staged dataset %s::%" PRId64 " in %" PRIu64 " usec",
+            job->sj_name, job->sj_id, hioi_gettime () - job->sj_start);
+
+  builtin_stage_evict (stage_module, job);
+
+  return false;
+}
+
+/**
+ * Append a job to the stage queue (queue lock must be held)
+ */
+static void builtin_stage_append (builtin_stage_module_t *stage_module, builtin_stage_job_t *job) {
+  job->sj_next = NULL;
+
+  if (stage_module->sm_tail) {
+    stage_module->sm_tail->sj_next = job;
+  } else {
+    stage_module->sm_head = job;
+  }
+  stage_module->sm_tail = job;
+}
+
+/**
+ * Remove the first job that can run now from the stage queue (queue lock must be held)
+ *
+ * @param[out] next_check  earliest time a waiting job can run again (usec. 0: no job is waiting)
+ */
+static builtin_stage_job_t *builtin_stage_dequeue (builtin_stage_module_t *stage_module, uint64_t *next_check) {
+  builtin_stage_job_t *job, *prev = NULL;
+  uint64_t now = hioi_gettime ();
+
+  *next_check = 0;
+
+  for (job = stage_module->sm_head ; job ; prev = job, job = job->sj_next) {
+    if (job->sj_next_check <= now) {
+      if (prev) {
+        prev->sj_next = job->sj_next;
+      } else {
+        stage_module->sm_head = job->sj_next;
+      }
+
+      if (stage_module->sm_tail == job) {
+        stage_module->sm_tail = prev;
+      }
+
+      return job;
+    }
+
+    if (0 == *next_check || job->sj_next_check < *next_check) {
+      *next_check = job->sj_next_check;
+    }
+  }
+
+  return NULL;
+}
+
+static void *builtin_stage_thread (void *arg) {
+  builtin_stage_module_t *stage_module = (builtin_stage_module_t *) arg;
+  builtin_stage_job_t *job;
+  uint64_t next_check;
+  bool requeue;
+
+  pthread_mutex_lock (&stage_module->sm_lock);
+  do {
+    while (NULL == stage_module->sm_head && !stage_module->sm_shutdown) {
+      pthread_cond_wait (&stage_module->sm_cond, &stage_module->sm_lock);
+    }
+
+    if (NULL == stage_module->sm_head) {
+      /* shutting down and all queued datasets have been staged */
+      break;
+    }
+
+    job = builtin_stage_dequeue (stage_module, &next_check);
+    if (NULL == job) {
+      /* all queued jobs are waiting to publish. sleep until the first one can be checked
+       * again or a new job is queued */
+      struct timespec abstime = {.tv_sec = next_check / 1000000, .tv_nsec = (next_check % 1000000) * 1000};
+      (void) pthread_cond_timedwait (&stage_module->sm_cond, &stage_module->sm_lock, &abstime);
+      continue;
+    }
+    pthread_mutex_unlock (&stage_module->sm_lock);
+
+    requeue = builtin_stage_run (stage_module, job);
+    if (!requeue) {
+      builtin_stage_job_free (job);
+    }
+
+    pthread_mutex_lock (&stage_module->sm_lock);
+    if (requeue) {
+      builtin_stage_append (stage_module, job);
+    }
+  } while (1);
+  pthread_mutex_unlock (&stage_module->sm_lock);
+
+  return NULL;
+}
+
+static int builtin_stage_enqueue (builtin_stage_module_t *stage_module, builtin_stage_job_t *job, int thread_count) {
+  int rc = HIO_SUCCESS;
+
+  pthread_mutex_lock (&stage_module->sm_lock);
+  if (NULL == stage_module->sm_threads) {
+    stage_module->sm_threads = calloc (thread_count, sizeof (pthread_t));
+    if (NULL == stage_module->sm_threads) {
+      pthread_mutex_unlock (&stage_module->sm_lock);
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (int i = 0 ; i < thread_count ; ++i) {
+      if (pthread_create (stage_module->sm_threads + i, NULL, builtin_stage_thread, stage_module)) {
+        rc = hioi_err_errno (errno);
+        break;
+      }
+      ++stage_module->sm_thread_count;
+    }
+
+    if (0 == stage_module->sm_thread_count) {
+      free (stage_module->sm_threads);
+      stage_module->sm_threads = NULL;
+      pthread_mutex_unlock (&stage_module->sm_lock);
+      return rc;
+    }
+  }
+
+  builtin_stage_append (stage_module, job);
+
+  pthread_cond_signal (&stage_module->sm_cond);
+  pthread_mutex_unlock (&stage_module->sm_lock);
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_stage_module_dataset_open (struct hio_module_t *module, hio_dataset_t dataset) {
+  builtin_stage_module_t *stage_module = (builtin_stage_module_t *) module;
+  builtin_posix_module_t *posix_module = &stage_module->posix_module;
+  builtin_stage_module_dataset_t *stage_dataset = (builtin_stage_module_dataset_t *) dataset;
+  hio_context_t context = module->context;
+  int rc = HIO_SUCCESS;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "builtin-stage/dataset_open: opening dataset %s:%lu",
+            hioi_object_identifier (dataset), (unsigned long) dataset->ds_id);
+
+  /* open the posix dataset */
+  rc = stage_module->posix_open (&posix_module->base, dataset);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  dataset->ds_module = module;
+
+  stage_dataset->stage_enable = false;
+  if (dataset->ds_flags & HIO_FLAG_WRITE) {
+    stage_dataset->stage_enable = true;
+    hioi_config_add (context, &dataset->ds_object, &stage_dataset->stage_enable,
+                     "stage_enable", HIO_CONFIG_TYPE_BOOL, NULL, "Copy this dataset instance to the "
+                     "persistent data root after it is closed (default: true)", 0);
+
+    stage_dataset->stage_keep = 1;
+    hioi_config_add (context, &dataset->ds_object, &stage_dataset->stage_keep,
+                     "stage_keep_count", HIO_CONFIG_TYPE_UINT32, NULL, "Number of staged instances of "
+                     "this dataset to keep on the fast data root. Older instances are removed from the "
+                     "fast data root once they are durable on the persistent data root (default: 1)", 0);
+
+    stage_dataset->stage_threads = 2;
+    hioi_config_add (context, &dataset->ds_object, &stage_dataset->stage_threads,
+                     "stage_threads", HIO_CONFIG_TYPE_UINT32, NULL, "Number of background threads used "
+                     "to copy datasets to the persistent data root. Only used by the first staged "
+                     "dataset (default: 2)", 0);
+    if (0 == stage_dataset->stage_threads) {
+      stage_dataset->stage_threads = 1;
+    }
+
+    stage_dataset->stage_timeout = 3600;
+    hioi_config_add (context, &dataset->ds_object, &stage_dataset->stage_timeout,
+                     "stage_publish_timeout", HIO_CONFIG_TYPE_UINT32, NULL, "Maximum time in seconds "
+                     "to wait for all processes to stage their files before giving up on a dataset "
+                     "instance (0: wait forever, default: 3600)", 0);
+  }
+
+  if (stage_dataset->stage_enable && (dataset->ds_flags & HIO_FLAG_CREAT) && 0 == context->c_rank) {
+    char *slow_path;
+
+    /* remove any previous copy of this instance so stale files are not mixed in */
+    rc = asprintf (&slow_path, "%s/%s.hio/%s/%lu", stage_module->slow_root, hioi_object_identifier (context),
+                   hioi_object_identifier (dataset), (unsigned long) dataset->ds_id);
+    if (0 < rc) {
+      builtin_stage_remove_tree (slow_path);
+      free (slow_path);
+    }
+  }
+
+  /* override posix dataset functions (keep copies) */
+  stage_dataset->posix_ds_close = dataset->ds_close;
+  dataset->ds_close = builtin_stage_module_dataset_close;
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_stage_module_dataset_close (hio_dataset_t dataset) {
+  builtin_stage_module_dataset_t *stage_dataset = (builtin_stage_module_dataset_t *) dataset;
+  builtin_stage_module_t *stage_module = (builtin_stage_module_t *) dataset->ds_module;
+  builtin_posix_module_dataset_t *posix_dataset = &stage_dataset->posix_dataset;
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  bool stage = stage_dataset->stage_enable && (dataset->ds_flags & HIO_FLAG_WRITE);
+  int stager = 1, stager_count = 1;
+  builtin_stage_job_t *job;
+  char *fast_path = NULL;
+  int rc;
+
+  if (stage) {
+    /* keep a copy of the base path used by the posix module */
+    fast_path = strdup (posix_dataset->base_path);
+    if (NULL == fast_path) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+  }
+
+  rc = stage_dataset->posix_ds_close (dataset);
+  if (HIO_SUCCESS != rc || !stage) {
+    free (fast_path);
+    return rc;
+  }
+
+  /* one process per node stages the files on that node. if the fast data root is shared
+   * the stagers divide the files between them */
+#if HIO_MPI_HAVE(3)
+  if (MPI_COMM_NULL != context->c_shared_comm) {
+    stager = (0 == context->c_shared_rank || 0 == context->c_rank);
+  }
+#endif
+
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    stager_count = stager;
+    MPI_Allreduce (MPI_IN_PLACE, &stager_count, 1, MPI_INT, MPI_SUM, context->c_comm);
+  }
+#endif
+
+  if (!stager) {
+    free (fast_path);
+    return HIO_SUCCESS;
+  }
+
+  job = calloc (1, sizeof (*job));
+  if (NULL == job) {
+    free (fast_path);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  job->sj_fast_path = fast_path;
+  job->sj_name = strdup (hioi_object_identifier (dataset));
+  job->sj_id = dataset->ds_id;
+  job->sj_stager_count = stager_count;
+  job->sj_rank = context->c_rank;
+  job->sj_publish = (0 == context->c_rank);
+  job->sj_keep = stage_dataset->stage_keep;
+  job->sj_timeout = stage_dataset->stage_timeout;
+
+  rc = asprintf (&job->sj_slow_path, "%s/%s.hio/%s/%lu", stage_module->slow_root, hioi_object_identifier (context),
+                 hioi_object_identifier (dataset), (unsigned long) dataset->ds_id);
+  if (0 > rc || NULL == job->sj_name) {
+    job->sj_slow_path = (0 > rc) ? NULL : job->sj_slow_path;
+    builtin_stage_job_free (job);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage/dataset_close: queueing stage of dataset %s::%" PRId64
+            " to %s", job->sj_name, job->sj_id, job->sj_slow_path);
+
+  rc = builtin_stage_enqueue (stage_module, job, stage_dataset->stage_threads);
+  if (HIO_SUCCESS != rc) {
+    hioi_err_push (rc, &dataset->ds_object, "builtin-stage/dataset_close: could not start stage threads");
+    builtin_stage_job_free (job);
+  }
+
+  return rc;
+}
+
+static int builtin_stage_module_fini (struct hio_module_t *module) {
+  builtin_stage_module_t *stage_module = (builtin_stage_module_t *) module;
+  hio_context_t context = module->context;
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Finalizing stage module for data root %s", module->data_root);
+
+  /* wait for all queued datasets to be staged */
+  pthread_mutex_lock (&stage_module->sm_lock);
+  stage_module->sm_shutdown = true;
+  pthread_cond_broadcast (&stage_module->sm_cond);
+  pthread_mutex_unlock (&stage_module->sm_lock);
+
+  for (int i = 0 ; i < stage_module->sm_thread_count ; ++i) {
+    pthread_join (stage_module->sm_threads[i], NULL);
+  }
+  free (stage_module->sm_threads);
+
+  pthread_cond_destroy (&stage_module->sm_cond);
+  pthread_mutex_destroy (&stage_module->sm_lock);
+  free (stage_module->slow_root);
+
+  if (stage_module->posix_fini) {
+    /* posix fini will free the module so call this last */
+    stage_module->posix_fini (&stage_module->posix_module.base);
+  } else {
+    free (module->data_root);
+    free (module);
+  }
+
+  return HIO_SUCCESS;
+}
+
+static int builtin_stage_component_init (hio_context_t context) {
+  /* nothing to do */
+  return HIO_SUCCESS;
+}
+
+static int builtin_stage_component_fini (void) {
+  /* nothing to do */
+  return HIO_SUCCESS;
+}
+
+static int builtin_stage_component_query (hio_context_t context, const char *data_root,
+                                          const char *next_data_root, hio_module_t **module) {
+  builtin_stage_module_t *new_module;
+  hio_module_t *posix_module;
+  const char *slow_root;
+  int rc;
+
+  if (strncasecmp ("stage:", data_root, 6)) {
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage/query: module stage does not match for data "
+              "root %s", data_root);
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  if (NULL == next_data_root) {
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage/query: stage data root %s must be followed by the "
+              "persistent data root to stage to", data_root);
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  slow_root = next_data_root;
+  if (0 == strncasecmp (slow_root, "posix:", 6)) {
+    slow_root += 6;
+  }
+
+  if (access (slow_root, F_OK)) {
+    hioi_log (context, HIO_VERBOSE_ERROR, "builtin-stage/query: persistent data root %s is not accessible",
+              next_data_root);
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  /* get a builtin-posix module for interfacing with the fast data root */
+  rc = builtin_posix_component.query (context, data_root + 6, NULL, &posix_module);
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  /* allocate a new stage I/O module */
+  new_module = calloc (1, sizeof (builtin_stage_module_t));
+  if (NULL == new_module) {
+    posix_module->fini (posix_module);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  memcpy (&new_module->posix_module, posix_module, sizeof (new_module->posix_module));
+
+  new_module->posix_open = posix_module->dataset_open;
+  new_module->posix_fini = posix_module->fini;
+  new_module->posix_module.base.dataset_open = builtin_stage_module_dataset_open;
+  new_module->posix_module.base.ds_object_size = sizeof (builtin_stage_module_dataset_t);
+  new_module->posix_module.base.fini = builtin_stage_module_fini;
+
+  free (posix_module);
+
+  pthread_mutex_init (&new_module->sm_lock, NULL);
+  pthread_cond_init (&new_module->sm_cond, NULL);
+
+  new_module->slow_root = strdup (slow_root);
+  if (NULL == new_module->slow_root) {
+    new_module->posix_module.base.fini ((hio_module_t *) new_module);
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "builtin-stage/query: created stage module for data root %s. "
+            "staging to %s", new_module->posix_module.base.data_root, new_module->slow_root);
+
+  *module = &new_module->posix_module.base;
+
+  return HIO_SUCCESS;
+}
+
+hio_component_t builtin_stage_component = {
+  .init = builtin_stage_component_init,
+  .fini = builtin_stage_component_fini,
+
+  .query = builtin_stage_component_query,
+  .flags = 0,
+  .priority = 10,
+};
@@ -21,6 +21,7 @@
 #include <errno.h>
 
 extern hio_component_t builtin_posix_component;
+extern hio_component_t builtin_stage_component;
 #if HIO_USE_DATAWARP
 extern hio_component_t builtin_datawarp_component;
 #endif
@@ -28,6 +29,7 @@ extern hio_component_t builtin_datawarp_component;
 #define MAX_COMPONENTS 128
 
 static hio_component_t *hio_builtin_components[] = {&builtin_posix_component,
+                                                    &builtin_stage_component,
 #if HIO_USE_DATAWARP
                                                     &builtin_datawarp_component,
 #endif
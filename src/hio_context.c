@@ -67,6 +67,19 @@ static void hioi_context_release (hio_object_t object) {
 
   free (context->c_droots);
 
+  if (-1 != context->c_req_fd[0]) {
+    close (context->c_req_fd[0]);
+    if (context->c_req_fd[1] != context->c_req_fd[0]) {
+      close (context->c_req_fd[1]);
+    }
+  }
+
+  pthread_cond_destroy (&context->c_req_cond);
+  pthread_mutex_destroy (&context->c_req_lock);
+
+  /* modules (and their threads) may log until they are finalized */
+  free (context->c_msg_id);
+
   /* clean up dataset data structures */
   hioi_list_foreach_safe(ds_data, next, context->c_ds_data, hio_dataset_data_t, dd_list) {
     hio_dataset_backend_data_t *db_data, *db_next;
@@ -168,6 +181,10 @@ static hio_context_t hio_context_alloc (const char *identifier) {
 
   hioi_list_init (new_context->c_ds_data);
 
+  pthread_mutex_init (&new_context->c_req_lock, NULL);
+  pthread_cond_init (&new_context->c_req_cond, NULL);
+  new_context->c_req_fd[0] = new_context->c_req_fd[1] = -1;
+
   return new_context;
 }
 
@@ -349,6 +366,33 @@ static int hio_init_common (hio_context_t context, const char *config_file, cons
                    "print_statistics", HIO_CONFIG_TYPE_BOOL, NULL, "Print statistics "
                    "to stdout when the context is closed (default: 0)", 0);
 
+  context->c_unlink_threads = 4;
+  hioi_config_add (context, &context->c_object, &context->c_unlink_threads,
+                   "unlink_threads", HIO_CONFIG_TYPE_UINT32, NULL, "Number of threads used "
+                   "to remove the files of a dataset (default: 4)", 0);
+
+  context->c_unlink_background = false;
+  hioi_config_add (context, &context->c_object, &context->c_unlink_background,
+                   "unlink_background", HIO_CONFIG_TYPE_BOOL, NULL, "Rename unlinked or "
+                   "truncated datasets out of the way and remove their files in the background. "
+                   "Removal is finished by hio_fini() (default: 0)", 0);
+
+  context->c_checkpoint_mtbf = 0;
+  hioi_config_add (context, &context->c_object, &context->c_checkpoint_mtbf,
+                   "checkpoint_mtbf", HIO_CONFIG_TYPE_UINT64, NULL, "Mean time between failures "
+                   "of the job in seconds used to compute the optimal checkpoint interval (default: "
+                   "0 - estimate from node_mtbf and the number of nodes)", 0);
+
+  /* five years */
+  context->c_node_mtbf = 157680000;
+  hioi_config_add (context, &context->c_object, &context->c_node_mtbf,
+                   "node_mtbf", HIO_CONFIG_TYPE_UINT64, NULL, "Mean time between failures of a "
+                   "single node in seconds (default: 157680000)", 0);
+
+  hioi_perf_add (context, &context->c_object, &context->c_checkpoint_interval,
+                 "checkpoint_interval", HIO_CONFIG_TYPE_UINT64, NULL, "Optimal checkpoint "
+                 "interval in seconds computed by the last call to hio_dataset_should_checkpoint()", 0);
+
 #if HIO_USE_DATAWARP
   context->c_dw_root = strdup ("auto");
   hioi_config_add (context, &context->c_object, &context->c_dw_root,
@@ -500,26 +544,73 @@ int hio_init_mpi (hio_context_t *new_context, MPI_Comm *comm, const char *config
 }
 #endif
 
+int hioi_context_start_background (hio_context_t context, void *(*fn) (void *), void *arg) {
+  pthread_attr_t attr;
+  pthread_t thread;
+  int rc;
+
+#if HIO_MPI_HAVE(1)
+  if (hioi_context_using_mpi (context)) {
+    int provided;
+
+    MPI_Query_thread (&provided);
+    if (MPI_THREAD_MULTIPLE != provided) {
+      return HIO_ERR_NOT_AVAILABLE;
+    }
+  }
+#endif
+
+  hioi_context_wait_pending (context);
+
+  pthread_mutex_lock (&context->c_req_lock);
+  ++context->c_pending_ops;
+  pthread_mutex_unlock (&context->c_req_lock);
+
+  pthread_attr_init (&attr);
+  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  rc = pthread_create (&thread, &attr, fn, arg);
+  pthread_attr_destroy (&attr);
+
+  if (0 != rc) {
+    hioi_context_background_done (context);
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  return HIO_SUCCESS;
+}
+
+void hioi_context_background_done (hio_context_t context) {
+  pthread_mutex_lock (&context->c_req_lock);
+  --context->c_pending_ops;
+  pthread_cond_broadcast (&context->c_req_cond);
+  pthread_mutex_unlock (&context->c_req_lock);
+}
+
+void hioi_context_wait_pending (hio_context_t context) {
+  pthread_mutex_lock (&context->c_req_lock);
+  while (context->c_pending_ops) {
+    pthread_cond_wait (&context->c_req_cond, &context->c_req_lock);
+  }
+  pthread_mutex_unlock (&context->c_req_lock);
+}
+
 int hio_fini (hio_context_t *context) {
   if (NULL == context || NULL == *context) {
     return HIO_SUCCESS;
   }
 
+  /* finish any background close before tearing down the context */
+  hioi_context_wait_pending (*context);
+
   hioi_log (*context, HIO_VERBOSE_DEBUG_LOW, "Destroying context with identifier %s",
             (*context)->c_object.identifier);
-  
-  free((*context)->c_msg_id); 
+
   hioi_object_release (&(*context)->c_object);
   *context = HIO_OBJECT_NULL;
 
   return hioi_component_fini ();
 }
 
-void hio_should_checkpoint (hio_context_t ctx, int *hint) {
-  /* TODO -- implement this */
-  *hint = HIO_SCP_MUST_CHECKPOINT;
-}
-
 hio_module_t *hioi_context_select_module (hio_context_t context) {
   /* TODO -- finish implementation */
   if (-1 == context->c_cur_module) {
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
 
 static hio_var_enum_value_t hioi_dataset_fs_type_enum_values[] = {
   {.string_value = "default", .value = HIO_FS_TYPE_DEFAULT},
@@ -27,7 +28,7 @@ static hio_var_enum_t hioi_dataset_fs_type_enum = {
   .values = hioi_dataset_fs_type_enum_values,
 };
 
-static int hioi_dataset_data_lookup (hio_context_t context, const char *name, hio_dataset_data_t **data) {
+int hioi_dataset_data_lookup (hio_context_t context, const char *name, hio_dataset_data_t **data) {
   hio_dataset_data_t *ds_data;
 
   /* look for existing persistent data */
@@ -82,6 +83,9 @@ static void hioi_dataset_release (hio_object_t object) {
     hioi_list_remove(element, e_list);
     hioi_object_release (&element->e_object);
   }
+
+  free (dataset->ds_data_roots);
+  free (dataset->ds_prefetch);
 }
 
 hio_dataset_t hioi_dataset_alloc (hio_context_t context, const char *name, int64_t id,
@@ -120,8 +124,9 @@ hio_dataset_t hioi_dataset_alloc (hio_context_t context, const char *name, int64
   new_dataset->ds_element_open = hioi_dataset_element_open_stub;
 #if HIO_MPI_HAVE(3)
   new_dataset->ds_shared_win = MPI_WIN_NULL;
+  new_dataset->ds_segment_win = MPI_WIN_NULL;
   new_dataset->ds_map.map_elements.md_win = MPI_WIN_NULL;
-  new_dataset->ds_map.map_segments.md_win = MPI_WIN_NULL;
+  new_dataset->ds_map.map_index_win = MPI_WIN_NULL;
 #endif
 
   new_dataset->ds_fsattr.fs_type = HIO_FS_TYPE_DEFAULT;
@@ -129,6 +134,28 @@ hio_dataset_t hioi_dataset_alloc (hio_context_t context, const char *name, int64
                    "dataset_filesystem_type", HIO_CONFIG_TYPE_INT32, &hioi_dataset_fs_type_enum,
                    "Type of filesystem this dataset resides on", HIO_VAR_FLAG_READONLY);
 
+#if HIO_MPI_HAVE(3)
+  new_dataset->ds_map.map_bulk_build = true;
+  hioi_config_add (context, &new_dataset->ds_object, &new_dataset->ds_map.map_bulk_build,
+                   "dataset_map_bulk_build", HIO_CONFIG_TYPE_BOOL, NULL,
+                   "Build the distributed element map with collective exchanges between node leaders "
+                   "instead of one-sided operations per item", 0);
+
+  new_dataset->ds_map.map_cache_size = 64;
+  hioi_config_add (context, &new_dataset->ds_object, &new_dataset->ds_map.map_cache_size,
+                   "dataset_map_cache_size", HIO_CONFIG_TYPE_UINT64, NULL,
+                   "Maximum number of remote segment map entries cached per element (0 disables "
+                   "the cache)", 0);
+
+  hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_mcache_hits, "map_cache_hits",
+                 HIO_CONFIG_TYPE_UINT64, NULL, "Number of offset translations satisfied by the element "
+                 "map caches", 0);
+
+  hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_map_lookups, "map_remote_lookups",
+                 HIO_CONFIG_TYPE_UINT64, NULL, "Number of offset translations that searched the "
+                 "distributed segment map", 0);
+#endif
+
   hioi_config_add (context, &new_dataset->ds_object, &new_dataset->ds_data->dd_average_size,
                    "dataset_expected_size", HIO_CONFIG_TYPE_INT64, NULL,
                    "Expected global size of this dataset", 0);
@@ -139,6 +166,14 @@ hio_dataset_t hioi_dataset_alloc (hio_context_t context, const char *name, int64
                    "dataset_buffer_size", HIO_CONFIG_TYPE_INT64, NULL,
                    "Buffer size to use for aggregating read and write operations", 0);
 
+  if (flags & HIO_FLAG_READ) {
+    new_dataset->ds_prefetch = strdup ("");
+    hioi_config_add (context, &new_dataset->ds_object, &new_dataset->ds_prefetch,
+                     "dataset_prefetch_elements", HIO_CONFIG_TYPE_STRING, NULL,
+                     "Comma-separated list of elements whose data is loaded in the background "
+                     "as soon as the dataset is opened (default: none)", HIO_VAR_FLAG_DEFAULT);
+  }
+
   /* set up performance variables */
   hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_bread, "bytes_read",
                  HIO_CONFIG_TYPE_UINT64, NULL, "Total number of bytes read in this dataset instance", 0);
@@ -146,15 +181,92 @@ hio_dataset_t hioi_dataset_alloc (hio_context_t context, const char *name, int64
   hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_bwritten, "bytes_written",
                  HIO_CONFIG_TYPE_UINT64, NULL, "Total number of bytes written in this dataset instance", 0);
 
+  hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_scount_before, "segments_before_compaction",
+                 HIO_CONFIG_TYPE_UINT64, NULL, "Number of element segments before compaction", 0);
+
+  hioi_perf_add (context, &new_dataset->ds_object, &new_dataset->ds_stat.s_scount_after, "segments_after_compaction",
+                 HIO_CONFIG_TYPE_UINT64, NULL, "Number of element segments remaining after compaction", 0);
+
   hioi_list_init (new_dataset->ds_elist);
 
   return new_dataset;
 }
 
+void hioi_dataset_prefetch (hio_dataset_t dataset) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  char *names, *name, *last;
+
+  if (!(dataset->ds_flags & HIO_FLAG_READ) || NULL == dataset->ds_prefetch || '\0' == dataset->ds_prefetch[0]) {
+    return;
+  }
+
+  names = strdup (dataset->ds_prefetch);
+  if (NULL == names) {
+    return;
+  }
+
+  for (name = strtok_r (names, ",", &last) ; name ; name = strtok_r (NULL, ",", &last)) {
+    int rank = (HIO_SET_ELEMENT_SHARED == dataset->ds_mode) ? -1 : context->c_rank;
+    hio_element_t element;
+    int rc;
+
+    /* opening an element the dataset does not have would add an empty element to it */
+    hioi_object_lock (&dataset->ds_object);
+    element = hioi_dataset_lookup_element (dataset, name, rank);
+    hioi_object_unlock (&dataset->ds_object);
+    if (NULL == element && !dataset->ds_elements_by_name) {
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Not prefetching element %s. the dataset does not have it", name);
+      continue;
+    }
+
+    rc = hioi_element_open_internal (dataset, &element, name, HIO_FLAG_READ, context->c_rank);
+    if (HIO_SUCCESS != rc) {
+      /* a prefetch hint is allowed to name elements this rank does not have */
+      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "Could not prefetch element %s. rc: %d", name, rc);
+      continue;
+    }
+
+    if (element->e_prefetch) {
+      (void) element->e_prefetch (element);
+    }
+
+    (void) hioi_element_close_internal (element);
+  }
+
+  free (names);
+}
+
+hio_element_t hioi_dataset_lookup_element (hio_dataset_t dataset, const char *identifier, int rank) {
+  hio_element_t element;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    if (rank == element->e_rank && 0 == strcmp (hioi_object_identifier (element), identifier)) {
+      return element;
+    }
+  }
+
+  return NULL;
+}
+
 void hioi_dataset_add_element (hio_dataset_t dataset, hio_element_t element) {
   hioi_list_append (element, dataset->ds_elist, e_list);
 }
 
+void hioi_dataset_compact_segments (hio_dataset_t dataset) {
+  uint64_t before = 0, after = 0;
+  hio_element_t element;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    before += element->e_scount;
+    (void) hioi_element_compact_segments (element);
+    after += element->e_scount;
+  }
+
+  /* compaction may run more than once on a dataset. only the latest pass is reported */
+  dataset->ds_stat.s_scount_before = before;
+  dataset->ds_stat.s_scount_after = after;
+}
+
 hio_dataset_backend_data_t *hioi_dbd_alloc (hio_dataset_data_t *data, const char *backend_name, size_t size) {
   hio_dataset_backend_data_t *new_backend_data;
 
@@ -203,6 +315,11 @@ int hioi_dataset_gather_manifest_comm (hio_dataset_t dataset, MPI_Comm comm, uns
   unsigned char *remote_data;
   MPI_Request reqs[2];
 
+  if (!simple) {
+    /* fuse contiguous segments before they are written to the manifest */
+    hioi_dataset_compact_segments (dataset);
+  }
+
   hioi_timed_call(rc = hioi_manifest_serialize (dataset, data_out, data_size_out, compress_data, simple));
   if (HIO_SUCCESS != rc) {
     return rc;
@@ -258,14 +375,14 @@ int hioi_dataset_gather_manifest_comm (hio_dataset_t dataset, MPI_Comm comm, uns
                 right);
       hioi_timed_call(MPI_Recv (remote_data, recv_size_right, MPI_CHAR, right, 1002, comm, MPI_STATUS_IGNORE));
       hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "merging manifest data from %d", right);
-      hioi_timed_call(hioi_manifest_merge_data2 (data_out, data_size_out, remote_data, recv_size_right));
+      hioi_timed_call(hioi_manifest_merge_data2 (dataset, data_out, data_size_out, remote_data, recv_size_right));
     }
 
     hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "receiving %lu bytes of manifest data from %d", recv_size_left,
               left);
     hioi_timed_call(MPI_Recv (remote_data, recv_size_left, MPI_CHAR, left, 1002, comm, MPI_STATUS_IGNORE));
     hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "merging manifest data from %d", left);
-    hioi_timed_call(hioi_manifest_merge_data2 (data_out, data_size_out, remote_data, recv_size_left));
+    hioi_timed_call(hioi_manifest_merge_data2 (dataset, data_out, data_size_out, remote_data, recv_size_left));
     free (remote_data);
   }
 
@@ -407,7 +524,8 @@ int hioi_dataset_scatter_unique (hio_dataset_t dataset, const unsigned char *man
   io_leader = all_ranks[context->c_rank];
   free (all_ranks);
 
-  rc = MPI_Comm_split (context->c_comm, io_leader, 0, &io_comm);
+  /* the rank holding the manifest must be the root of the scatter */
+  rc = MPI_Comm_split (context->c_comm, io_leader, io_leader != context->c_rank, &io_comm);
   if (MPI_SUCCESS != rc) {
     return hioi_err_mpi (rc);
   }
@@ -417,12 +535,256 @@ int hioi_dataset_scatter_unique (hio_dataset_t dataset, const unsigned char *man
     return HIO_SUCCESS;
   }
 
-  rc = hioi_dataset_scatter_comm (dataset, context->c_comm, manifest, manifest_size, rc);
+  rc = hioi_dataset_scatter_comm (dataset, io_comm, manifest, manifest_size, rc);
   MPI_Comm_free (&io_comm);
 
   return rc;
 }
 
+/* element exchange buffer layout (native byte order, all ranks in a job share an architecture):
+ *   uint32_t element count
+ *   per element: uint32_t identifier length, identifier (no terminator), int32_t rank,
+ *                int64_t size, uint32_t segment count, hio_manifest_segment_t[segment count] */
+static int hioi_dataset_pack_elements (hio_dataset_t dataset, unsigned char **data_out, size_t *data_size_out) {
+  size_t data_size = sizeof (uint32_t);
+  unsigned char *data, *cur;
+  hio_element_t element;
+  uint32_t count = 0;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    data_size += 3 * sizeof (uint32_t) + sizeof (int64_t) + strlen (hioi_object_identifier (element)) +
+      element->e_scount * sizeof (element->e_sarray[0]);
+    ++count;
+  }
+
+  cur = data = malloc (data_size);
+  if (NULL == data) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  memcpy (cur, &count, sizeof (count));
+  cur += sizeof (count);
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    const char *identifier = hioi_object_identifier (element);
+    uint32_t length = strlen (identifier), scount = element->e_scount;
+    int32_t rank = element->e_rank;
+    int64_t size = element->e_size;
+
+    memcpy (cur, &length, sizeof (length));
+    cur += sizeof (length);
+    memcpy (cur, identifier, length);
+    cur += length;
+    memcpy (cur, &rank, sizeof (rank));
+    cur += sizeof (rank);
+    memcpy (cur, &size, sizeof (size));
+    cur += sizeof (size);
+    memcpy (cur, &scount, sizeof (scount));
+    cur += sizeof (scount);
+    if (scount) {
+      memcpy (cur, element->e_sarray, scount * sizeof (element->e_sarray[0]));
+      cur += scount * sizeof (element->e_sarray[0]);
+    }
+  }
+
+  *data_out = data;
+  *data_size_out = data_size;
+
+  return HIO_SUCCESS;
+}
+
+static int hioi_dataset_unpack_elements (hio_dataset_t dataset, const unsigned char *data, size_t data_size) {
+  const unsigned char *cur = data, *end = data + data_size;
+  uint32_t count, length, scount;
+  hio_element_t element;
+  char *identifier;
+  int64_t size;
+  int32_t rank;
+  int rc;
+
+  if (data_size < sizeof (count)) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  memcpy (&count, cur, sizeof (count));
+  cur += sizeof (count);
+
+  for (uint32_t i = 0 ; i < count ; ++i) {
+    bool new_element = false;
+
+    if ((size_t) (end - cur) < sizeof (length)) {
+      return HIO_ERR_BAD_PARAM;
+    }
+
+    memcpy (&length, cur, sizeof (length));
+    cur += sizeof (length);
+
+    if ((size_t) (end - cur) < length + 2 * sizeof (uint32_t) + sizeof (int64_t)) {
+      return HIO_ERR_BAD_PARAM;
+    }
+
+    identifier = strndup ((const char *) cur, length);
+    if (NULL == identifier) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+    cur += length;
+
+    memcpy (&rank, cur, sizeof (rank));
+    cur += sizeof (rank);
+    memcpy (&size, cur, sizeof (size));
+    cur += sizeof (size);
+    memcpy (&scount, cur, sizeof (scount));
+    cur += sizeof (scount);
+
+    if ((size_t) (end - cur) < scount * sizeof (hio_manifest_segment_t)) {
+      free (identifier);
+      return HIO_ERR_BAD_PARAM;
+    }
+
+    element = hioi_dataset_lookup_element (dataset, identifier, rank);
+    if (NULL == element) {
+      element = hioi_element_alloc (dataset, identifier, rank);
+      if (NULL == element) {
+        free (identifier);
+        return HIO_ERR_OUT_OF_RESOURCE;
+      }
+
+      new_element = true;
+    }
+
+    free (identifier);
+
+    if (size > element->e_size) {
+      element->e_size = size;
+    }
+
+    rc = hioi_element_append_segments (element, (const hio_manifest_segment_t *) cur, scount);
+    if (HIO_SUCCESS != rc) {
+      if (new_element) {
+        hioi_object_release (&element->e_object);
+      }
+      return rc;
+    }
+
+    cur += scount * sizeof (hio_manifest_segment_t);
+
+    if (new_element) {
+      hioi_dataset_add_element (dataset, element);
+    }
+  }
+
+  return HIO_SUCCESS;
+}
+
+int hioi_dataset_gather_elements (hio_dataset_t dataset, MPI_Comm comm, int root) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  unsigned char *data = NULL, *all_data = NULL;
+  int rank, size, rc, mpirc, my_size;
+  size_t data_size = 0, total_size = 0;
+  bool receiving, all = (0 > root);
+  hio_element_t element;
+  int *sizes, *displs;
+
+  MPI_Comm_rank (comm, &rank);
+  MPI_Comm_size (comm, &size);
+
+  receiving = all || rank == root;
+
+  sizes = calloc (2 * size, sizeof (int));
+  assert (NULL != sizes);
+  displs = sizes + size;
+
+  rc = hioi_dataset_pack_elements (dataset, &data, &data_size);
+  if (HIO_SUCCESS == rc && data_size > INT_MAX) {
+    rc = HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  /* a negative size signals a failure on that rank */
+  my_size = (HIO_SUCCESS == rc) ? (int) data_size : -1;
+
+  do {
+    if (all) {
+      mpirc = MPI_Allgather (&my_size, 1, MPI_INT, sizes, 1, MPI_INT, comm);
+    } else {
+      mpirc = MPI_Gather (&my_size, 1, MPI_INT, sizes, 1, MPI_INT, root, comm);
+    }
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+      break;
+    }
+
+    if (receiving) {
+      for (int i = 0 ; i < size ; ++i) {
+        if (0 > sizes[i] || total_size + sizes[i] > INT_MAX) {
+          rc = (HIO_SUCCESS == rc) ? HIO_ERROR : rc;
+          break;
+        }
+
+        displs[i] = (int) total_size;
+        total_size += sizes[i];
+      }
+    }
+
+    if (!all) {
+      /* only the root knows if all ranks succeeded */
+      mpirc = MPI_Bcast (&rc, 1, MPI_INT, root, comm);
+      if (MPI_SUCCESS != mpirc) {
+        rc = hioi_err_mpi (mpirc);
+        break;
+      }
+    }
+
+    if (HIO_SUCCESS != rc) {
+      break;
+    }
+
+    if (receiving) {
+      all_data = malloc (total_size);
+      assert (NULL != all_data);
+    }
+
+    if (all) {
+      mpirc = MPI_Allgatherv (data, my_size, MPI_BYTE, all_data, sizes, displs, MPI_BYTE, comm);
+    } else {
+      mpirc = MPI_Gatherv (data, my_size, MPI_BYTE, all_data, sizes, displs, MPI_BYTE, root, comm);
+    }
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+      break;
+    }
+
+    if (!receiving) {
+      break;
+    }
+
+    /* merge the elements read by the other ranks then sort and compact each segment array once */
+    for (int i = 0 ; i < size ; ++i) {
+      if (i == rank) {
+        continue;
+      }
+
+      rc = hioi_dataset_unpack_elements (dataset, all_data + displs[i], sizes[i]);
+      if (HIO_SUCCESS != rc) {
+        hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "hioi_dataset_gather_elements: failed to unpack elements "
+                  "from rank %d. rc: %d", i, rc);
+        break;
+      }
+    }
+
+    hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+      hioi_element_sort_segments (element);
+    }
+
+    hioi_dataset_compact_segments (dataset);
+  } while (0);
+
+  free (all_data);
+  free (sizes);
+  free (data);
+
+  return rc;
+}
+
 #endif /* HIO_MPI_HAVE(1) */
 
 int hioi_dataset_open_internal (hio_module_t *module, hio_dataset_t dataset) {
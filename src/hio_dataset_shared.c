@@ -12,6 +12,13 @@
 #include "hio_internal.h"
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/** maximum length of the name of a POSIX shared memory control block */
+#define HIO_SHM_NAME_MAX 64
 
 static int request_compare (const void *a, const void *b) {
   const hio_internal_request_t **reqa = (const hio_internal_request_t **) a;
@@ -70,9 +77,179 @@ int hioi_dataset_buffer_flush (hio_dataset_t dataset) {
   return rc;
 }
 
+static size_t hioi_dataset_control_block_size (int stripes) {
+  /* ensure data block starts on a cache line boundary */
+  return (sizeof (hio_shared_control_t) + stripes * sizeof (((hio_shared_control_t *) 0)->s_stripes[0]) + 127) & ~127;
+}
+
+static void hioi_dataset_control_block_init (hio_shared_control_t *control, int master, int stripes) {
+  pthread_mutexattr_t mutex_attr;
+  pthread_condattr_t cond_attr;
+
+  control->s_master = master;
+
+  pthread_mutexattr_init (&mutex_attr);
+  pthread_mutexattr_setpshared (&mutex_attr, PTHREAD_PROCESS_SHARED);
+  pthread_condattr_init (&cond_attr);
+  pthread_condattr_setpshared (&cond_attr, PTHREAD_PROCESS_SHARED);
+
+  pthread_mutex_init (&control->s_create_mutex, &mutex_attr);
+  pthread_cond_init (&control->s_create_cond, &cond_attr);
+  control->s_creating = 0;
+
+  /* fixme - not sure this is the right way to ensure stripe 0 mutex gets init'd */
+  for (int i = 0 ; i < stripes ; ++i) {
+    pthread_mutex_init (&control->s_stripes[i].s_mutex, &mutex_attr);
+    atomic_init (&control->s_stripes[i].s_index, 0);
+    control->s_stripes[i].s_sub_offset = 0;
+    control->s_stripes[i].s_sub_remaining = 0;
+  }
+
+  pthread_condattr_destroy (&cond_attr);
+  pthread_mutexattr_destroy (&mutex_attr);
+}
+
+#if HIO_MPI_HAVE(1)
+/**
+ * Check whether all processes in the context share a node
+ *
+ * Used when MPI-3 shared memory communicators are not available to decide if
+ * a POSIX shared memory control block can be used.
+ */
+static bool hioi_context_single_node (hio_context_t context) {
+  char name[MPI_MAX_PROCESSOR_NAME], root_name[MPI_MAX_PROCESSOR_NAME];
+  int len, same;
+
+  memset (name, 0, sizeof (name));
+  MPI_Get_processor_name (name, &len);
+  memcpy (root_name, name, sizeof (name));
+
+  if (MPI_SUCCESS != MPI_Bcast (root_name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, 0, context->c_comm)) {
+    return false;
+  }
+
+  same = !strcmp (name, root_name);
+  if (MPI_SUCCESS != MPI_Allreduce (MPI_IN_PLACE, &same, 1, MPI_INT, MPI_MIN, context->c_comm)) {
+    return false;
+  }
+
+  return !!same;
+}
+#endif
+
+/**
+ * Set up the control block in POSIX shared memory
+ *
+ * Used when no MPI-3 shared memory window is available: serial tools, multi-threaded
+ * jobs, and multi-process jobs on a single node with an older MPI. A single process maps
+ * anonymous memory. Otherwise rank 0 creates a named shared memory object that all other
+ * ranks map before it is unlinked. If the control block can not be created on all ranks
+ * this function returns HIO_SUCCESS without setting ds_shared_control.
+ */
+static int hioi_dataset_shared_init_posix (hio_dataset_t dataset, int stripes) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  size_t control_block_size = hioi_dataset_control_block_size (stripes);
+  void *base = MAP_FAILED;
+
+  if (!hioi_context_using_mpi (context) || 1 == context->c_size) {
+    base = mmap (NULL, control_block_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == base) {
+      hioi_log (context, HIO_VERBOSE_WARN, "could not map control block, errno: %d", errno);
+      return HIO_SUCCESS;
+    }
+
+    memset (base, 0, control_block_size);
+    hioi_dataset_control_block_init ((hio_shared_control_t *) base, context->c_rank, stripes);
+    dataset->ds_shared_control = (hio_shared_control_t *) base;
+    dataset->ds_shared_size = control_block_size;
+
+    return HIO_SUCCESS;
+  }
+
+#if HIO_MPI_HAVE(1)
+  char name[HIO_SHM_NAME_MAX] = "";
+  int fd, success;
+
+  if (!hioi_context_single_node (context)) {
+    /* coordination between nodes requires MPI-3 */
+    return HIO_SUCCESS;
+  }
+
+  if (0 == context->c_rank) {
+    static atomic_uint shm_count;
+
+    snprintf (name, sizeof (name), "/hio.%d.%" PRIx64 ".%x", (int) getpid (), (uint64_t) dataset->ds_id,
+              atomic_fetch_add (&shm_count, 1));
+    fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (0 <= fd) {
+      if (0 == ftruncate (fd, control_block_size)) {
+        base = mmap (NULL, control_block_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+
+      close (fd);
+
+      if (MAP_FAILED != base) {
+        hioi_dataset_control_block_init ((hio_shared_control_t *) base, context->c_rank, stripes);
+      } else {
+        shm_unlink (name);
+        name[0] = '\0';
+      }
+    } else {
+      hioi_log (context, HIO_VERBOSE_WARN, "could not create shared memory control block %s, errno: %d",
+                name, errno);
+      name[0] = '\0';
+    }
+  }
+
+  if (MPI_SUCCESS != MPI_Bcast (name, sizeof (name), MPI_CHAR, 0, context->c_comm) || '\0' == name[0]) {
+    return HIO_SUCCESS;
+  }
+
+  if (0 != context->c_rank) {
+    fd = shm_open (name, O_RDWR, 0600);
+    if (0 <= fd) {
+      base = mmap (NULL, control_block_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close (fd);
+    }
+  }
+
+  success = MAP_FAILED != base;
+  (void) MPI_Allreduce (MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, context->c_comm);
+
+  /* all ranks have either mapped the object or given up on it */
+  if (0 == context->c_rank) {
+    shm_unlink (name);
+  }
+
+  if (!success) {
+    hioi_log (context, HIO_VERBOSE_WARN, "could not map shared memory control block on all ranks, name: %s", name);
+    if (MAP_FAILED != base) {
+      munmap (base, control_block_size);
+    }
+
+    return HIO_SUCCESS;
+  }
+
+  dataset->ds_shared_control = (hio_shared_control_t *) base;
+  dataset->ds_shared_size = control_block_size;
+#endif
+
+  return HIO_SUCCESS;
+}
+
+static void hioi_dataset_shared_fini_posix (hio_dataset_t dataset) {
+  if (0 == dataset->ds_shared_size) {
+    return;
+  }
+
+  munmap ((void *) dataset->ds_shared_control, dataset->ds_shared_size);
+  dataset->ds_shared_control = NULL;
+  dataset->ds_shared_size = 0;
+}
+
 #if HIO_MPI_HAVE(3)
 
-int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes) {
+static int hioi_dataset_shared_init_mpi (hio_dataset_t dataset, int stripes) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
   size_t ds_buffer_size = dataset->ds_buffer_size;
   size_t control_block_size;
@@ -81,12 +258,7 @@ int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes) {
   int rc, disp_unit;
   void *base;
 
-  if (MPI_COMM_NULL == context->c_shared_comm) {
-    return HIO_SUCCESS;
-  }
-
-  /* ensure data block starts on a cache line boundary */
-  control_block_size = (sizeof (hio_shared_control_t) + stripes * sizeof (dataset->ds_shared_control->s_stripes[0]) + 127) & ~127;
+  control_block_size = hioi_dataset_control_block_size (stripes);
   data_size = ds_buffer_size + control_block_size * (0 == context->c_shared_rank);
 
   rc = MPI_Win_allocate_shared (data_size, 1, MPI_INFO_NULL,
@@ -97,23 +269,10 @@ int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes) {
   }
 
   if (0 == context->c_shared_rank) {
-    pthread_mutexattr_t mutex_attr;
-
     /* initialize the control structure */
     memset (base, 0, control_block_size);
-    dataset->ds_shared_control = (hio_shared_control_t *) (intptr_t) base;
-    dataset->ds_shared_control->s_master = context->c_rank;
-
-    pthread_mutexattr_init (&mutex_attr);
-    pthread_mutexattr_setpshared (&mutex_attr, PTHREAD_PROCESS_SHARED);
+    hioi_dataset_control_block_init ((hio_shared_control_t *) base, context->c_rank, stripes);
 
-    /* fixme - not sure this is the right way to ensure stripe 0 mutex gets init'd */
-    for (int i = 0 ; i < stripes ; ++i) {
-      pthread_mutex_init (&dataset->ds_shared_control->s_stripes[i].s_mutex, &mutex_attr);
-      atomic_init (&dataset->ds_shared_control->s_stripes[i].s_index, 0);
-    }
-
-    pthread_mutexattr_destroy (&mutex_attr);
     /* master base follows the control block */
     dataset->ds_buffer.b_base = (void *)((intptr_t) base + control_block_size);
   } else {
@@ -140,17 +299,218 @@ int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes) {
   return HIO_SUCCESS;
 }
 
+/* layout of the node segment table. the table is a header followed by an array
+ * of element descriptors followed by a flat array of sorted segments */
+typedef struct hio_segment_table_header_t {
+  /** number of element descriptors */
+  uint64_t sth_element_count;
+  /** total number of segments */
+  uint64_t sth_segment_count;
+} hio_segment_table_header_t;
+
+typedef struct hio_segment_table_element_t {
+  /** element identifier */
+  char     ste_name[HIO_ELEMENT_NAME_MAX + 1];
+  /** element rank (-1 for shared) */
+  int32_t  ste_rank;
+  /** element size */
+  int64_t  ste_size;
+  /** index of the first segment of this element in the segment array */
+  uint64_t ste_sindex;
+  /** number of segments */
+  uint64_t ste_scount;
+} hio_segment_table_element_t;
+
+static void hioi_dataset_segment_table_fill (hio_dataset_t dataset, void *base) {
+  hio_segment_table_header_t *header = (hio_segment_table_header_t *) base;
+  hio_segment_table_element_t *table_elements = (hio_segment_table_element_t *) (header + 1);
+  hio_manifest_segment_t *segments;
+  hio_element_t element;
+  uint64_t sindex = 0;
+  int i = 0;
+
+  segments = (hio_manifest_segment_t *) (table_elements + header->sth_element_count);
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    hio_segment_table_element_t *table_element = table_elements + i++;
+
+    /* the shared window is not zeroed */
+    strncpy (table_element->ste_name, hioi_object_identifier (element), HIO_ELEMENT_NAME_MAX);
+    table_element->ste_name[HIO_ELEMENT_NAME_MAX] = '\0';
+    table_element->ste_rank = element->e_rank;
+    table_element->ste_size = element->e_size;
+    table_element->ste_sindex = sindex;
+    table_element->ste_scount = element->e_scount;
+
+    if (element->e_scount) {
+      memcpy (segments + sindex, element->e_sarray, element->e_scount * sizeof (segments[0]));
+      sindex += element->e_scount;
+    }
+  }
+}
+
+static int hioi_dataset_segment_table_attach (hio_dataset_t dataset, void *base) {
+  hio_segment_table_header_t *header = (hio_segment_table_header_t *) base;
+  hio_segment_table_element_t *table_elements = (hio_segment_table_element_t *) (header + 1);
+  hio_manifest_segment_t *segments;
+
+  segments = (hio_manifest_segment_t *) (table_elements + header->sth_element_count);
+
+  for (uint64_t i = 0 ; i < header->sth_element_count ; ++i) {
+    hio_segment_table_element_t *table_element = table_elements + i;
+    hio_element_t element;
+
+    element = hioi_dataset_lookup_element (dataset, table_element->ste_name, table_element->ste_rank);
+    if (NULL == element) {
+      element = hioi_element_alloc (dataset, table_element->ste_name, table_element->ste_rank);
+      if (NULL == element) {
+        return HIO_ERR_OUT_OF_RESOURCE;
+      }
+
+      hioi_dataset_add_element (dataset, element);
+    }
+
+    hioi_object_lock (&element->e_object);
+    if (!element->e_sarray_shared) {
+      free (element->e_sarray);
+    }
+
+    element->e_size = table_element->ste_size;
+    element->e_sarray = segments + table_element->ste_sindex;
+    element->e_scount = element->e_ssize = table_element->ste_scount;
+    element->e_sarray_shared = true;
+    hioi_object_unlock (&element->e_object);
+  }
+
+  return HIO_SUCCESS;
+}
+
+int hioi_dataset_shared_segments_init (hio_dataset_t dataset) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  uint64_t element_count = 0, segment_count = 0;
+  hio_element_t element;
+  MPI_Aint table_size = 0;
+  int rc, disp_unit;
+  long size_data;
+  MPI_Win win;
+  void *base;
+
+  if (MPI_COMM_NULL == context->c_shared_comm) {
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  if (0 == context->c_shared_rank) {
+    hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+      if (strlen (hioi_object_identifier (element)) > HIO_ELEMENT_NAME_MAX) {
+        /* can not be represented in the table */
+        element_count = 0;
+        table_size = -1;
+        break;
+      }
+
+      ++element_count;
+      segment_count += element->e_scount;
+    }
+
+    if (0 <= table_size) {
+      table_size = sizeof (hio_segment_table_header_t) + element_count * sizeof (hio_segment_table_element_t) +
+        segment_count * sizeof (hio_manifest_segment_t);
+    }
+  }
+
+  size_data = (long) table_size;
+  rc = MPI_Bcast (&size_data, 1, MPI_LONG, 0, context->c_shared_comm);
+  if (MPI_SUCCESS != rc) {
+    return hioi_err_mpi (rc);
+  }
+
+  if (0 > size_data) {
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  rc = MPI_Win_allocate_shared (table_size, 1, MPI_INFO_NULL, context->c_shared_comm, &base, &win);
+  if (MPI_SUCCESS != rc) {
+    hioi_log (context, HIO_VERBOSE_WARN, "could not allocate shared segment table, size: %ld", size_data);
+    return HIO_ERR_NOT_AVAILABLE;
+  }
+
+  if (0 == context->c_shared_rank) {
+    hio_segment_table_header_t *header = (hio_segment_table_header_t *) base;
+
+    header->sth_element_count = element_count;
+    header->sth_segment_count = segment_count;
+    hioi_dataset_segment_table_fill (dataset, base);
+  }
+
+  MPI_Barrier (context->c_shared_comm);
+
+  rc = MPI_Win_shared_query (win, 0, &table_size, &disp_unit, &base);
+  if (MPI_SUCCESS != rc) {
+    hioi_log (context, HIO_VERBOSE_WARN, "error querying shared segment table, rc: %d", rc);
+    MPI_Win_free (&win);
+    return HIO_ERROR;
+  }
+
+  dataset->ds_segment_win = win;
+
+  rc = hioi_dataset_segment_table_attach (dataset, base);
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "shared segment table holds %ld bytes", size_data);
+
+  return rc;
+}
+
+static void hioi_dataset_shared_segments_fini (hio_dataset_t dataset) {
+  hio_element_t element;
+
+  if (MPI_WIN_NULL == dataset->ds_segment_win) {
+    return;
+  }
+
+  /* detach elements from the table before it goes away */
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    hioi_object_lock (&element->e_object);
+    if (element->e_sarray_shared) {
+      element->e_sarray = NULL;
+      element->e_scount = element->e_ssize = 0;
+      element->e_sarray_shared = false;
+    }
+    hioi_object_unlock (&element->e_object);
+  }
+
+  MPI_Win_free (&dataset->ds_segment_win);
+}
+
+#endif /* HIO_MPI_HAVE(3) */
+
+int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes) {
+#if HIO_MPI_HAVE(3)
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+
+  if (MPI_COMM_NULL != context->c_shared_comm) {
+    return hioi_dataset_shared_init_mpi (dataset, stripes);
+  }
+#endif
+
+  return hioi_dataset_shared_init_posix (dataset, stripes);
+}
+
 int hioi_dataset_shared_fini (hio_dataset_t dataset) {
+  hioi_dataset_shared_fini_posix (dataset);
+
+#if HIO_MPI_HAVE(3)
   hio_context_t context = hioi_object_context (&dataset->ds_object);
   if (hioi_context_using_mpi (context)) {
+    hioi_dataset_shared_segments_fini (dataset);
+
     if (MPI_WIN_NULL == dataset->ds_shared_win) {
       return HIO_SUCCESS;
     }
 
     MPI_Win_free (&dataset->ds_shared_win);
+    dataset->ds_shared_control = NULL;
   }
+#endif
 
   return HIO_SUCCESS;
 }
-
-#endif /* HIO_MPI_HAVE(3) */
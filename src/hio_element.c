@@ -19,7 +19,43 @@
 static void hioi_element_release (hio_object_t object) {
   hio_element_t element = (hio_element_t) object;
 
-  free (element->e_sarray);
+  if (!element->e_sarray_shared) {
+    free (element->e_sarray);
+  }
+
+#if HIO_MPI_HAVE(3)
+  free (element->e_mcache);
+#endif
+}
+
+/**
+ * Make a private copy of a shared segment array before modifying it
+ *
+ * @param[in] element hio element handle
+ *
+ * The element lock must be held by the caller.
+ */
+static int hioi_element_segments_private (hio_element_t element) {
+  hio_manifest_segment_t *sarray = NULL;
+
+  if (!element->e_sarray_shared) {
+    return HIO_SUCCESS;
+  }
+
+  if (element->e_scount) {
+    sarray = malloc (element->e_scount * sizeof (element->e_sarray[0]));
+    if (NULL == sarray) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    memcpy (sarray, element->e_sarray, element->e_scount * sizeof (element->e_sarray[0]));
+  }
+
+  element->e_sarray = sarray;
+  element->e_ssize = element->e_scount;
+  element->e_sarray_shared = false;
+
+  return HIO_SUCCESS;
 }
 
 hio_element_t hioi_element_alloc (hio_dataset_t dataset, const char *name, const int rank) {
@@ -150,11 +186,17 @@ static int hioi_element_segment_compare (const void *key, const void *value) {
 int hioi_element_add_segment (hio_element_t element, int file_index, uint64_t file_offset, uint64_t app_offset,
                               size_t seg_length) {
   hio_manifest_segment_t *segment = NULL;
-  int seg_index = 0;
+  int seg_index = 0, rc;
   void *tmp;
 
   hioi_object_lock (&element->e_object);
 
+  rc = hioi_element_segments_private (element);
+  if (HIO_SUCCESS != rc) {
+    hioi_object_unlock (&element->e_object);
+    return rc;
+  }
+
   if (element->e_sarray) {
     unsigned long last_offset, last_file_offset;
 
@@ -277,3 +319,155 @@ int hioi_element_translate_offset (hio_element_t element, uint64_t app_offset, i
 
   return rc;
 }
+
+void hioi_element_clip_segment (hio_element_t element, uint64_t app_offset, size_t *length) {
+  size_t low = 0, high;
+
+  hioi_object_lock (&element->e_object);
+
+  /* find the first segment that starts after the offset */
+  high = element->e_scount;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+
+    if (element->e_sarray[mid].seg_offset <= app_offset) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  if (low < element->e_scount && app_offset + *length > element->e_sarray[low].seg_offset) {
+    *length = element->e_sarray[low].seg_offset - app_offset;
+  }
+
+  hioi_object_unlock (&element->e_object);
+}
+
+/**
+ * Append segment descriptors to an element
+ *
+ * @param[in] element  hio element handle
+ * @param[in] segments segment descriptors to append
+ * @param[in] count    number of segment descriptors
+ *
+ * Segments are appended without maintaining the sort order of the
+ * element's segment array. This allows segments from many sources to
+ * be added to an element in bulk. hioi_element_sort_segments() must be
+ * called before the element is used for offset translation.
+ */
+int hioi_element_append_segments (hio_element_t element, const hio_manifest_segment_t *segments, int count) {
+  void *tmp;
+  int rc;
+
+  if (0 == count) {
+    return HIO_SUCCESS;
+  }
+
+  hioi_object_lock (&element->e_object);
+
+  rc = hioi_element_segments_private (element);
+  if (HIO_SUCCESS != rc) {
+    hioi_object_unlock (&element->e_object);
+    return rc;
+  }
+
+  if (element->e_scount + count > element->e_ssize) {
+    tmp = realloc (element->e_sarray, (element->e_scount + count) * sizeof (element->e_sarray[0]));
+    if (NULL == tmp) {
+      hioi_object_unlock (&element->e_object);
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    element->e_sarray = (hio_manifest_segment_t *) tmp;
+    element->e_ssize = element->e_scount + count;
+  }
+
+  memcpy (element->e_sarray + element->e_scount, segments, count * sizeof (element->e_sarray[0]));
+  element->e_scount += count;
+
+  hioi_object_unlock (&element->e_object);
+
+  return HIO_SUCCESS;
+}
+
+static int hioi_element_segment_sort_compare (const void *a, const void *b) {
+  const hio_manifest_segment_t *segment_a = (const hio_manifest_segment_t *) a;
+  const hio_manifest_segment_t *segment_b = (const hio_manifest_segment_t *) b;
+
+  if (segment_a->seg_offset > segment_b->seg_offset) {
+    return 1;
+  }
+
+  return (segment_a->seg_offset < segment_b->seg_offset) ? -1 : 0;
+}
+
+/**
+ * Sort the segment array of an element by application offset
+ *
+ * @param[in] element hio element handle
+ */
+void hioi_element_sort_segments (hio_element_t element) {
+  hioi_object_lock (&element->e_object);
+  /* the shared segment table is already sorted */
+  if (element->e_scount > 1 && !element->e_sarray_shared) {
+    qsort (element->e_sarray, element->e_scount, sizeof (element->e_sarray[0]),
+           hioi_element_segment_sort_compare);
+  }
+  hioi_object_unlock (&element->e_object);
+}
+
+/**
+ * Compact the segment array of an element
+ *
+ * @param[in] element hio element handle
+ *
+ * @returns the number of segments removed
+ *
+ * Fuses runs of segments that are contiguous in both application and file
+ * space and drops zero-length segments. Overlapping segments are kept since
+ * the order of the array says nothing about which write came last. The
+ * segment array must be sorted by application offset.
+ */
+size_t hioi_element_compact_segments (hio_element_t element) {
+  size_t count = 0, removed;
+
+  hioi_object_lock (&element->e_object);
+
+  if (element->e_sarray_shared) {
+    /* the shared segment table is compacted when it is built */
+    hioi_object_unlock (&element->e_object);
+    return 0;
+  }
+
+  for (size_t i = 0 ; i < element->e_scount ; ++i) {
+    hio_manifest_segment_t *segment = element->e_sarray + i;
+
+    if (0 == segment->seg_length) {
+      continue;
+    }
+
+    if (count) {
+      hio_manifest_segment_t *last = element->e_sarray + count - 1;
+      uint64_t last_offset = last->seg_offset + last->seg_length;
+
+      if (segment->seg_offset == last_offset && segment->seg_file_index == last->seg_file_index &&
+          segment->seg_foffset == last->seg_foffset + last->seg_length) {
+        last->seg_length += segment->seg_length;
+        continue;
+      }
+    }
+
+    if (count != i) {
+      element->e_sarray[count] = *segment;
+    }
+    ++count;
+  }
+
+  removed = element->e_scount - count;
+  element->e_scount = count;
+
+  hioi_object_unlock (&element->e_object);
+
+  return removed;
+}
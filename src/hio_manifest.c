@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <string.h>
+#include <ctype.h>
 #include <assert.h>
 #include <unistd.h>
 #include <bzlib.h>
@@ -45,6 +46,9 @@
 #define HIO_MANIFEST_KEY_MTIME        "hio_mtime"
 #define HIO_MANIFEST_KEY_COMM_SIZE    "hio_comm_size"
 #define HIO_MANIFEST_KEY_STATUS       "hio_status"
+#define HIO_MANIFEST_KEY_SHARD_SIZE   "hio_manifest_shard_size"
+#define HIO_MANIFEST_KEY_DATA_ROOTS   "hio_data_roots"
+#define HIO_MANIFEST_KEY_DIR_SHARD    "hio_dir_shard_size"
 #define HIO_SEGMENT_KEY_FILE_OFFSET   "loff"
 #define HIO_SEGMENT_KEY_APP_OFFSET0   "off"
 #define HIO_SEGMENT_KEY_LENGTH        "len"
@@ -123,19 +127,6 @@ static int hioi_manifest_get_number (json_object *parent, const char *name, unsi
   return HIO_SUCCESS;
 }
 
-static int hioi_manifest_get_signed_number (json_object *parent, const char *name, long *value) {
-  json_object *object;
-
-  object = hioi_manifest_find_object (parent, name);
-  if (NULL == object) {
-    return HIO_ERR_NOT_FOUND;
-  }
-
-  *value = (long) json_object_get_int64 (object);
-
-  return HIO_SUCCESS;
-}
-
 static json_object *hio_manifest_generate_simple_3_0 (hio_dataset_t dataset) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
   hio_object_t hio_object = &dataset->ds_object;
@@ -207,6 +198,18 @@ static json_object *hio_manifest_generate_simple_3_0 (hio_dataset_t dataset) {
   hioi_manifest_set_signed_number (top, HIO_MANIFEST_KEY_STATUS, (long) dataset->ds_status);
   hioi_manifest_set_number (top, HIO_MANIFEST_KEY_MTIME, (unsigned long) time (NULL));
 
+  if (dataset->ds_mshard_size > 0) {
+    hioi_manifest_set_number (top, HIO_MANIFEST_KEY_SHARD_SIZE, (unsigned long) dataset->ds_mshard_size);
+  }
+
+  if (NULL != dataset->ds_data_roots) {
+    hioi_manifest_set_string (top, HIO_MANIFEST_KEY_DATA_ROOTS, dataset->ds_data_roots);
+  }
+
+  if (dataset->ds_dir_shard_size > 0) {
+    hioi_manifest_set_number (top, HIO_MANIFEST_KEY_DIR_SHARD, (unsigned long) dataset->ds_dir_shard_size);
+  }
+
   return top;
 }
 
@@ -374,401 +377,976 @@ int hioi_manifest_save (hio_dataset_t dataset, const unsigned char *manifest_dat
   return rc == data_size ? HIO_SUCCESS : HIO_ERR_TRUNCATE;
 }
 
-static int hioi_manifest_parse_segment_2_1 (hio_element_t element, json_object *segment_object) {
-  unsigned long file_offset, app_offset0, length, file_index;
-  int rc;
+/*
+ * Streaming manifest parser
+ *
+ * The manifest is walked in a single pass without building a json-c object tree. Element
+ * segments are added to the element (e_sarray) as they are encountered. Only the subset
+ * of JSON produced by the manifest generators (2.x and 3.x) is interpreted; any other
+ * value is skipped without being decoded.
+ */
 
-  rc = hioi_manifest_get_number (segment_object, HIO_SEGMENT_KEY_FILE_OFFSET, &file_offset);
-  if (HIO_SUCCESS != rc) {
-    return rc;
+typedef struct hioi_manifest_stream_t {
+  /** current position in the manifest text */
+  const char *ms_cur;
+  /** end of the manifest text */
+  const char *ms_end;
+  /** scratch buffer for decoded strings */
+  char       *ms_string;
+  /** size of the scratch buffer */
+  size_t      ms_string_size;
+} hioi_manifest_stream_t;
+
+enum {
+  HIO_MANIFEST_FOUND_COMPAT       = 0x01,
+  HIO_MANIFEST_FOUND_DATASET_MODE = 0x02,
+  HIO_MANIFEST_FOUND_FILE_MODE    = 0x04,
+  HIO_MANIFEST_FOUND_COMM_SIZE    = 0x08,
+  HIO_MANIFEST_FOUND_STATUS       = 0x10,
+  HIO_MANIFEST_FOUND_MTIME        = 0x20,
+  HIO_MANIFEST_FOUND_DATASET_ID   = 0x40,
+  HIO_MANIFEST_FOUND_SHARD_SIZE   = 0x80,
+  HIO_MANIFEST_FOUND_ELEMENTS     = 0x100,
+  HIO_MANIFEST_FOUND_DATA_ROOTS   = 0x200,
+  HIO_MANIFEST_FOUND_DIR_SHARD    = 0x400,
+};
+
+/** top-level manifest values collected by the streaming parser */
+typedef struct hioi_manifest_info_t {
+  /** mask of HIO_MANIFEST_FOUND_* values */
+  unsigned    mi_found;
+  /** manifest compatibility version */
+  char        mi_compat[8];
+  /** dataset mode */
+  int         mi_dataset_mode;
+  /** file mode (top-level key in 2.0 manifests, configuration block in 3.0 manifests) */
+  char        mi_file_mode[32];
+  int64_t     mi_comm_size;
+  int64_t     mi_status;
+  int64_t     mi_mtime;
+  int64_t     mi_dataset_id;
+  int64_t     mi_shard_size;
+  /** data roots holding the data files (allocated) */
+  char       *mi_data_roots;
+  /** number of ranks or files sharing each data subdirectory */
+  int64_t     mi_dir_shard_size;
+  /** the entire top-level object has been read */
+  bool        mi_final;
+} hioi_manifest_info_t;
+
+/**
+ * Elements array callback
+ *
+ * Called with the stream positioned at the start of the elements array. The callback
+ * may return HIO_ERR_NOT_AVAILABLE without consuming any input to defer processing
+ * of the array until the rest of the top-level object has been read.
+ */
+typedef int (*hioi_manifest_elements_fn_t) (hioi_manifest_stream_t *stream, hioi_manifest_info_t *info, void *ctx);
+
+static void hioi_manifest_stream_init (hioi_manifest_stream_t *stream, const unsigned char *data, size_t data_size) {
+  const char *end = memchr (data, '\0', data_size);
+
+  stream->ms_cur = (const char *) data;
+  stream->ms_end = end ? end : (const char *) data + data_size;
+  stream->ms_string = NULL;
+  stream->ms_string_size = 0;
+}
+
+static void hioi_manifest_info_fini (hioi_manifest_info_t *info) {
+  free (info->mi_data_roots);
+  info->mi_data_roots = NULL;
+}
+
+static void hioi_manifest_stream_fini (hioi_manifest_stream_t *stream) {
+  free (stream->ms_string);
+  stream->ms_string = NULL;
+}
+
+static int hioi_manifest_stream_peek (hioi_manifest_stream_t *stream) {
+  while (stream->ms_cur < stream->ms_end && isspace ((unsigned char) stream->ms_cur[0])) {
+    ++stream->ms_cur;
   }
 
-  rc = hioi_manifest_get_number (segment_object, HIO_SEGMENT_KEY_APP_OFFSET0, &app_offset0);
-  if (HIO_SUCCESS != rc) {
-    return rc;
+  return (stream->ms_cur < stream->ms_end) ? stream->ms_cur[0] : EOF;
+}
+
+static bool hioi_manifest_stream_accept (hioi_manifest_stream_t *stream, int c) {
+  if (c == hioi_manifest_stream_peek (stream)) {
+    ++stream->ms_cur;
+    return true;
   }
 
-  rc = hioi_manifest_get_number (segment_object, HIO_SEGMENT_KEY_LENGTH, &length);
-  if (HIO_SUCCESS != rc) {
-    return rc;
+  return false;
+}
+
+/**
+ * Append a character to the stream's scratch buffer
+ *
+ * @param[in] stream     manifest stream
+ * @param[in] length     current length of the decoded string
+ * @param[in] c          byte read from the stream or unicode code point of an escape
+ * @param[in] encode     encode c as utf-8. bytes read as is from the stream are already encoded
+ *
+ * @returns the number of bytes appended or an hio error code
+ */
+static int hioi_manifest_stream_append (hioi_manifest_stream_t *stream, size_t length, unsigned int c,
+                                        bool encode) {
+  if (length + 4 >= stream->ms_string_size) {
+    size_t new_size = stream->ms_string_size ? stream->ms_string_size * 2 : 256;
+    char *tmp = realloc (stream->ms_string, new_size);
+    if (NULL == tmp) {
+      return HIO_ERR_OUT_OF_RESOURCE;
+    }
+
+    stream->ms_string = tmp;
+    stream->ms_string_size = new_size;
+  }
+
+  /* encode the character as utf-8 */
+  if (!encode || c < 0x80) {
+    stream->ms_string[length] = (char) c;
+    return 1;
+  }
+
+  if (c < 0x800) {
+    stream->ms_string[length] = (char) (0xc0 | (c >> 6));
+    stream->ms_string[length + 1] = (char) (0x80 | (c & 0x3f));
+    return 2;
+  }
+
+  if (c < 0x10000) {
+    stream->ms_string[length] = (char) (0xe0 | (c >> 12));
+    stream->ms_string[length + 1] = (char) (0x80 | ((c >> 6) & 0x3f));
+    stream->ms_string[length + 2] = (char) (0x80 | (c & 0x3f));
+    return 3;
+  }
+
+  stream->ms_string[length] = (char) (0xf0 | (c >> 18));
+  stream->ms_string[length + 1] = (char) (0x80 | ((c >> 12) & 0x3f));
+  stream->ms_string[length + 2] = (char) (0x80 | ((c >> 6) & 0x3f));
+  stream->ms_string[length + 3] = (char) (0x80 | (c & 0x3f));
+  return 4;
+}
+
+/**
+ * Read the four hex digits of a \u escape
+ */
+static int hioi_manifest_stream_hex4 (hioi_manifest_stream_t *stream, unsigned int *value) {
+  unsigned int c = 0;
+
+  if (stream->ms_end - stream->ms_cur < 4) {
+    return HIO_ERROR;
+  }
+
+  for (int i = 0 ; i < 4 ; ++i) {
+    int digit = (unsigned char) *(stream->ms_cur++);
+
+    if (!isxdigit (digit)) {
+      return HIO_ERROR;
+    }
+
+    c = (c << 4) | (isdigit (digit) ? digit - '0' : tolower (digit) - 'a' + 10);
   }
 
-  rc = hioi_manifest_get_number (segment_object, HIO_SEGMENT_KEY_FILE_INDEX, &file_index);
+  *value = c;
+
+  return HIO_SUCCESS;
+}
+
+/**
+ * Read a \u escape (positioned after the u)
+ *
+ * Characters outside the basic multilingual plane are escaped as a utf-16 surrogate
+ * pair. Unpaired surrogates are rejected.
+ */
+static int hioi_manifest_stream_unicode (hioi_manifest_stream_t *stream, unsigned int *value) {
+  unsigned int c, low;
+  int rc;
+
+  rc = hioi_manifest_stream_hex4 (stream, &c);
   if (HIO_SUCCESS != rc) {
-    hioi_err_push (HIO_ERROR, &element->e_object, "Manfest segment missing file_index property");
     return rc;
   }
 
-  return hioi_element_add_segment (element, file_index, file_offset, app_offset0, length);
-}
+  if (c >= 0xdc00 && c < 0xe000) {
+    return HIO_ERROR;
+  }
 
-static int hioi_manifest_parse_segments_2_1 (hio_element_t element, json_object *object) {
-  hio_context_t context = hioi_object_context (&element->e_object);
-  int segment_count = json_object_array_length (object);
+  if (c >= 0xd800 && c < 0xdc00) {
+    if (stream->ms_end - stream->ms_cur < 2 || '\\' != stream->ms_cur[0] || 'u' != stream->ms_cur[1]) {
+      return HIO_ERROR;
+    }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "parsing %d segments in element %s", segment_count,
-            hioi_object_identifier (&element->e_object));
+    stream->ms_cur += 2;
 
-  for (int i = 0 ; i < segment_count ; ++i) {
-    json_object *segment_object = json_object_array_get_idx (object, i);
-    int rc = hioi_manifest_parse_segment_2_1 (element, segment_object);
+    rc = hioi_manifest_stream_hex4 (stream, &low);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
+
+    if (low < 0xdc00 || low >= 0xe000) {
+      return HIO_ERROR;
+    }
+
+    c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
   }
 
+  *value = c;
+
   return HIO_SUCCESS;
 }
 
-static int hioi_manifest_parse_element_2_0 (hio_dataset_t dataset, json_object *element_object) {
-  hio_context_t context = hioi_object_context (&dataset->ds_object);
-  hio_element_t element = NULL;
-  json_object *segments_object;
-  bool new_element = true;
-  const char *tmp_string;
-  unsigned long value;
-  int rc, rank;
+/**
+ * Read a string from the manifest stream
+ *
+ * @param[in]  stream     manifest stream
+ * @param[out] string_out decoded string (may be NULL)
+ *
+ * The decoded string is stored in the stream's scratch buffer and is only valid until
+ * the next string is read.
+ */
+static int hioi_manifest_stream_string (hioi_manifest_stream_t *stream, const char **string_out) {
+  size_t length = 0;
+  int rc;
 
-  rc = hioi_manifest_get_string (element_object, HIO_MANIFEST_PROP_IDENTIFIER, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (HIO_ERROR, &dataset->ds_object, "manifest element missing identifier property");
+  if (!hioi_manifest_stream_accept (stream, '"')) {
     return HIO_ERROR;
   }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "parsing manifest element: %s", tmp_string);
+  while (stream->ms_cur < stream->ms_end && '"' != stream->ms_cur[0]) {
+    unsigned int c = (unsigned char) *(stream->ms_cur++);
+    bool encode = false;
 
-  if (HIO_SET_ELEMENT_UNIQUE == dataset->ds_mode) {
-    rc = hioi_manifest_get_number (element_object, HIO_MANIFEST_PROP_RANK, &value);
-    if (HIO_SUCCESS != rc) {
-      hioi_object_release (&element->e_object);
-      return HIO_ERR_BAD_PARAM;
+    if ('\\' == c) {
+      if (stream->ms_cur >= stream->ms_end) {
+        return HIO_ERROR;
+      }
+
+      c = (unsigned char) *(stream->ms_cur++);
+      switch (c) {
+      case 'b':
+        c = '\b';
+        break;
+      case 'f':
+        c = '\f';
+        break;
+      case 'n':
+        c = '\n';
+        break;
+      case 'r':
+        c = '\r';
+        break;
+      case 't':
+        c = '\t';
+        break;
+      case 'u':
+        rc = hioi_manifest_stream_unicode (stream, &c);
+        if (HIO_SUCCESS != rc) {
+          return rc;
+        }
+        encode = true;
+        break;
+      default:
+        /* '"', '\\', and '/' are stored as is */
+        break;
+      }
     }
 
-    if (value != context->c_rank) {
-      /* nothing to do */
-      return HIO_SUCCESS;
+    if (NULL != string_out) {
+      rc = hioi_manifest_stream_append (stream, length, c, encode);
+      if (0 > rc) {
+        return rc;
+      }
+
+      length += rc;
     }
+  }
 
-    rank = value;
-  } else {
-    rank = -1;
+  if (stream->ms_cur >= stream->ms_end) {
+    return HIO_ERROR;
   }
 
-  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
-    if (!strcmp (hioi_object_identifier(element), tmp_string) && rank == element->e_rank) {
-      new_element = false;
-      break;
+  /* skip the closing quote */
+  ++stream->ms_cur;
+
+  if (NULL != string_out) {
+    rc = hioi_manifest_stream_append (stream, length, '\0', false);
+    if (0 > rc) {
+      return rc;
     }
+
+    *string_out = stream->ms_string;
   }
 
-  if (new_element) {
-    element = hioi_element_alloc (dataset, (const char *) tmp_string, rank);
-    if (NULL == element) {
-      return HIO_ERR_OUT_OF_RESOURCE;
+  return HIO_SUCCESS;
+}
+
+static int hioi_manifest_stream_number (hioi_manifest_stream_t *stream, int64_t *value) {
+  char tmp[32], *end;
+  size_t length;
+
+  (void) hioi_manifest_stream_peek (stream);
+
+  for (length = 0 ; stream->ms_cur + length < stream->ms_end && length < sizeof (tmp) - 1 ; ++length) {
+    char c = stream->ms_cur[length];
+    if (!(isdigit ((unsigned char) c) || '-' == c || '+' == c || '.' == c || 'e' == c || 'E' == c)) {
+      break;
     }
+
+    tmp[length] = c;
   }
 
-  rc = hioi_manifest_get_number (element_object, HIO_MANIFEST_PROP_SIZE, &value);
-  if (HIO_SUCCESS != rc) {
-    hioi_object_release (&element->e_object);
-    return HIO_ERR_BAD_PARAM;
+  tmp[length] = '\0';
+
+  if ('-' == tmp[0]) {
+    *value = (int64_t) strtoll (tmp, &end, 10);
+  } else {
+    *value = (int64_t) strtoull (tmp, &end, 10);
   }
 
-  if (dataset->ds_mode == HIO_SET_ELEMENT_UNIQUE || value > element->e_size) {
-    element->e_size = value;
+  if (end == tmp) {
+    return HIO_ERROR;
   }
 
-  segments_object = hioi_manifest_find_object (element_object, "segments");
-  if (NULL != segments_object) {
-    rc = hioi_manifest_parse_segments_2_1 (element, segments_object);
-    if (HIO_SUCCESS != rc) {
-      hioi_object_release (&element->e_object);
-      return rc;
+  /* any fractional part or exponent is ignored */
+  stream->ms_cur += length;
+
+  return HIO_SUCCESS;
+}
+
+/* skip over a value of any type without decoding it */
+static int hioi_manifest_stream_skip (hioi_manifest_stream_t *stream) {
+  int c = hioi_manifest_stream_peek (stream), depth = 0;
+  bool in_string = false;
+
+  if ('"' == c) {
+    return hioi_manifest_stream_string (stream, NULL);
+  }
+
+  if ('{' != c && '[' != c) {
+    /* number or literal */
+    while (stream->ms_cur < stream->ms_end && !strchr (",]} \t\r\n", stream->ms_cur[0])) {
+      ++stream->ms_cur;
     }
+
+    return HIO_SUCCESS;
   }
 
-  if (new_element) {
-    hioi_dataset_add_element (dataset, element);
+  for ( ; stream->ms_cur < stream->ms_end ; ++stream->ms_cur) {
+    c = stream->ms_cur[0];
+
+    if (in_string) {
+      if ('\\' == c) {
+        ++stream->ms_cur;
+      } else if ('"' == c) {
+        in_string = false;
+      }
+    } else if ('"' == c) {
+      in_string = true;
+    } else if ('{' == c || '[' == c) {
+      ++depth;
+    } else if (('}' == c || ']' == c) && 0 == --depth) {
+      ++stream->ms_cur;
+      return HIO_SUCCESS;
+    }
+  }
+
+  return HIO_ERROR;
+}
+
+/* read the next object key. returns HIO_ERR_NOT_FOUND at the end of the object */
+static int hioi_manifest_stream_key (hioi_manifest_stream_t *stream, bool first, const char **key) {
+  if (hioi_manifest_stream_accept (stream, '}')) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  if (!first && !hioi_manifest_stream_accept (stream, ',')) {
+    return HIO_ERROR;
+  }
+
+  if (HIO_SUCCESS != hioi_manifest_stream_string (stream, key) || !hioi_manifest_stream_accept (stream, ':')) {
+    return HIO_ERROR;
   }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "found element with identifier %s in manifest",
-	    element->e_object.identifier);
+  return HIO_SUCCESS;
+}
+
+/* advance to the next array item. returns HIO_ERR_NOT_FOUND at the end of the array */
+static int hioi_manifest_stream_next_item (hioi_manifest_stream_t *stream, bool first) {
+  if (hioi_manifest_stream_accept (stream, ']')) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  if (!first && !hioi_manifest_stream_accept (stream, ',')) {
+    return HIO_ERROR;
+  }
 
   return HIO_SUCCESS;
 }
 
-static int hioi_manifest_parse_elements_2_0 (hio_dataset_t dataset, json_object *object) {
-  hio_context_t context = hioi_object_context (&dataset->ds_object);
-  int element_count = json_object_array_length (object);
+static int hioi_manifest_stream_dataset_mode (const char *string) {
+  if (0 == strcmp (string, "unique")) {
+    return HIO_SET_ELEMENT_UNIQUE;
+  }
+
+  if (0 == strcmp (string, "shared")) {
+    return HIO_SET_ELEMENT_SHARED;
+  }
+
+  return -1;
+}
+
+/**
+ * Walk the top-level manifest object
+ *
+ * @param[in]    stream    manifest stream
+ * @param[inout] info      top-level manifest values
+ * @param[in]    fn        callback for the elements array (may be NULL)
+ * @param[in]    ctx       callback context
+ * @param[in]    stop_mask stop reading as soon as all of these values have been found (0: read everything)
+ */
+/* read the dataset configuration block. only the file mode is needed to interpret the manifest */
+static int hioi_manifest_stream_config (hioi_manifest_stream_t *stream, hioi_manifest_info_t *info) {
+  const char *key, *value;
+  bool first = true;
+  int rc;
+
+  if (!hioi_manifest_stream_accept (stream, '{')) {
+    return HIO_ERROR;
+  }
+
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_key (stream, first, &key))) {
+    first = false;
+
+    if (0 == strcmp (key, "dataset_file_mode")) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        strncpy (info->mi_file_mode, value, sizeof (info->mi_file_mode) - 1);
+        info->mi_found |= HIO_MANIFEST_FOUND_FILE_MODE;
+      }
+    } else {
+      rc = hioi_manifest_stream_skip (stream);
+    }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "parsing %d elements in manifest", element_count);
-  for (int i = 0 ; i < element_count ; ++i) {
-    json_object *element_object = json_object_array_get_idx (object, i);
-    int rc = hioi_manifest_parse_element_2_0 (dataset, element_object);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
   }
 
+  return (HIO_ERR_NOT_FOUND == rc) ? HIO_SUCCESS : rc;
+}
+
+static int hioi_manifest_stream_walk (hioi_manifest_stream_t *stream, hioi_manifest_info_t *info,
+                                      hioi_manifest_elements_fn_t fn, void *ctx, unsigned stop_mask) {
+  const char *deferred = NULL, *key, *value;
+  int rc = HIO_SUCCESS;
+  bool first = true;
+
+  memset (info, 0, sizeof (*info));
+
+  if (!hioi_manifest_stream_accept (stream, '{')) {
+    return HIO_ERROR;
+  }
+
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_key (stream, first, &key))) {
+    first = false;
+
+    if (0 == strcmp (key, HIO_MANIFEST_PROP_COMPAT)) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        strncpy (info->mi_compat, value, sizeof (info->mi_compat) - 1);
+        info->mi_found |= HIO_MANIFEST_FOUND_COMPAT;
+      }
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_DATASET_MODE)) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        info->mi_dataset_mode = hioi_manifest_stream_dataset_mode (value);
+        info->mi_found |= HIO_MANIFEST_FOUND_DATASET_MODE;
+      }
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_FILE_MODE)) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        strncpy (info->mi_file_mode, value, sizeof (info->mi_file_mode) - 1);
+        info->mi_found |= HIO_MANIFEST_FOUND_FILE_MODE;
+      }
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_COMM_SIZE)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_comm_size);
+      info->mi_found |= HIO_MANIFEST_FOUND_COMM_SIZE;
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_STATUS)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_status);
+      info->mi_found |= HIO_MANIFEST_FOUND_STATUS;
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_MTIME)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_mtime);
+      info->mi_found |= HIO_MANIFEST_FOUND_MTIME;
+    } else if (0 == strcmp (key, HIO_MANIFEST_PROP_DATASET_ID)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_dataset_id);
+      info->mi_found |= HIO_MANIFEST_FOUND_DATASET_ID;
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_SHARD_SIZE)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_shard_size);
+      info->mi_found |= HIO_MANIFEST_FOUND_SHARD_SIZE;
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_DATA_ROOTS)) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        free (info->mi_data_roots);
+        info->mi_data_roots = strdup (value);
+        if (NULL == info->mi_data_roots) {
+          rc = HIO_ERR_OUT_OF_RESOURCE;
+        }
+        info->mi_found |= HIO_MANIFEST_FOUND_DATA_ROOTS;
+      }
+    } else if (0 == strcmp (key, HIO_MANIFEST_KEY_DIR_SHARD)) {
+      rc = hioi_manifest_stream_number (stream, &info->mi_dir_shard_size);
+      info->mi_found |= HIO_MANIFEST_FOUND_DIR_SHARD;
+    } else if (0 == strcmp (key, "config")) {
+      rc = hioi_manifest_stream_config (stream, info);
+    } else if (0 == strcmp (key, "elements") && NULL != fn) {
+      (void) hioi_manifest_stream_peek (stream);
+      rc = fn (stream, info, ctx);
+      if (HIO_ERR_NOT_AVAILABLE == rc) {
+        /* come back to the elements once the remainder of the header has been read */
+        deferred = stream->ms_cur;
+        rc = hioi_manifest_stream_skip (stream);
+      }
+    } else {
+      rc = hioi_manifest_stream_skip (stream);
+    }
+
+    if (HIO_SUCCESS != rc) {
+      break;
+    }
+
+    if (stop_mask && (info->mi_found & stop_mask) == stop_mask) {
+      /* all requested values have been found */
+      return HIO_SUCCESS;
+    }
+  }
+
+  if (HIO_ERR_NOT_FOUND != rc) {
+    return (HIO_SUCCESS == rc) ? HIO_ERROR : rc;
+  }
+
+  info->mi_final = true;
+
+  if (NULL != deferred) {
+    stream->ms_cur = deferred;
+    return fn (stream, info, ctx);
+  }
+
   return HIO_SUCCESS;
 }
 
-static int hioi_manifest_parse_2_0 (hio_dataset_t dataset, json_object *object) {
+/* verify the top-level manifest values and apply them to the dataset */
+static int hioi_manifest_stream_apply_header (hio_dataset_t dataset, hioi_manifest_info_t *info) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
-  json_object *elements_object;
-  unsigned long mode = 0, size;
-  const char *tmp_string;
-  long status;
+  bool version_2_0;
   int rc;
 
   /* check for compatibility with this manifest version */
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_PROP_COMPAT, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (rc, &dataset->ds_object, "manifest missing required %s key",
+  if (!(info->mi_found & HIO_MANIFEST_FOUND_COMPAT)) {
+    hioi_err_push (HIO_ERR_NOT_FOUND, &dataset->ds_object, "manifest missing required %s key",
                    HIO_MANIFEST_PROP_COMPAT);
-    return rc;
+    return HIO_ERR_NOT_FOUND;
   }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "compatibility version of manifest: %s",
-            (char *) tmp_string);
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "compatibility version of manifest: %s", info->mi_compat);
 
-  if (strcmp ((char *) tmp_string, "2.0")) {
+  version_2_0 = (0 == strcmp (info->mi_compat, "2.0"));
+  if (!version_2_0 && strcmp (info->mi_compat, "3.0")) {
     /* incompatible version */
     return HIO_ERROR;
   }
 
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_KEY_DATASET_MODE, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (rc, &dataset->ds_object, "manifest missing required %s key",
+  if (!(info->mi_found & HIO_MANIFEST_FOUND_DATASET_MODE)) {
+    hioi_err_push (HIO_ERR_NOT_FOUND, &dataset->ds_object, "manifest missing required %s key",
                    HIO_MANIFEST_KEY_DATASET_MODE);
-    return rc;
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  if (0 > info->mi_dataset_mode) {
+    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "unknown dataset mode specified in manifest");
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  if (info->mi_dataset_mode != dataset->ds_mode) {
+    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object,
+                   "mismatch in dataset mode. requested: %d, actual: %d", info->mi_dataset_mode,
+                   dataset->ds_mode);
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  if (HIO_SET_ELEMENT_UNIQUE == info->mi_dataset_mode) {
+    /* verify that the same number of ranks are in use */
+    if (!(info->mi_found & HIO_MANIFEST_FOUND_COMM_SIZE)) {
+      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "manifest missing required %s key",
+                     HIO_MANIFEST_KEY_COMM_SIZE);
+      return HIO_ERR_BAD_PARAM;
+    }
+
+    if (info->mi_comm_size != context->c_size) {
+      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "communicator size does not match dataset");
+      return HIO_ERR_BAD_PARAM;
+    }
+  }
+
+  if (version_2_0 && !(info->mi_found & HIO_MANIFEST_FOUND_FILE_MODE)) {
+    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "file mode was not specified in manifest");
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  /* the file mode used by the writer determines how the data is laid out */
+  if (info->mi_found & HIO_MANIFEST_FOUND_FILE_MODE) {
+    rc = hio_config_set_value (&dataset->ds_object, "dataset_file_mode", info->mi_file_mode);
+    if (HIO_SUCCESS != rc) {
+      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "bad file mode: %s", info->mi_file_mode);
+      return HIO_ERR_BAD_PARAM;
+    }
+  }
+
+  if (!(info->mi_found & HIO_MANIFEST_FOUND_STATUS)) {
+    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "manifest status key missing");
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  dataset->ds_status = (int) info->mi_status;
+
+  /* the shard layout is determined by the writer. manifests without the key (including all
+   * 2.0 manifests) were written as a single top-level manifest */
+  dataset->ds_mshard_size = (info->mi_found & HIO_MANIFEST_FOUND_SHARD_SIZE) ? (int32_t) info->mi_shard_size : 0;
+
+  /* data manifests do not repeat the data root list so only replace it if present */
+  if (info->mi_found & HIO_MANIFEST_FOUND_DATA_ROOTS) {
+    free (dataset->ds_data_roots);
+    dataset->ds_data_roots = info->mi_data_roots;
+    info->mi_data_roots = NULL;
+  }
+
+  if (info->mi_found & HIO_MANIFEST_FOUND_DIR_SHARD) {
+    dataset->ds_dir_shard_size = (uint32_t) info->mi_dir_shard_size;
+  }
+
+  return HIO_SUCCESS;
+}
+
+static int hioi_manifest_stream_segments (hioi_manifest_stream_t *stream, hio_element_t element) {
+  hio_context_t context = hioi_object_context (&element->e_object);
+  int rc, segment_count = 0;
+  const char *key;
+
+  if (!hioi_manifest_stream_accept (stream, '[')) {
+    return HIO_ERROR;
+  }
+
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_next_item (stream, 0 == segment_count))) {
+    int64_t file_offset = 0, app_offset0 = 0, length = 0, file_index = -1;
+    bool first = true;
+
+    if (!hioi_manifest_stream_accept (stream, '{')) {
+      return HIO_ERROR;
+    }
+
+    while (HIO_SUCCESS == (rc = hioi_manifest_stream_key (stream, first, &key))) {
+      first = false;
+
+      if (0 == strcmp (key, HIO_SEGMENT_KEY_FILE_OFFSET)) {
+        rc = hioi_manifest_stream_number (stream, &file_offset);
+      } else if (0 == strcmp (key, HIO_SEGMENT_KEY_APP_OFFSET0)) {
+        rc = hioi_manifest_stream_number (stream, &app_offset0);
+      } else if (0 == strcmp (key, HIO_SEGMENT_KEY_LENGTH)) {
+        rc = hioi_manifest_stream_number (stream, &length);
+      } else if (0 == strcmp (key, HIO_SEGMENT_KEY_FILE_INDEX)) {
+        rc = hioi_manifest_stream_number (stream, &file_index);
+      } else {
+        rc = hioi_manifest_stream_skip (stream);
+      }
+
+      if (HIO_SUCCESS != rc) {
+        return rc;
+      }
+    }
+
+    if (HIO_ERR_NOT_FOUND != rc) {
+      return rc;
+    }
+
+    if (0 > file_index) {
+      hioi_err_push (HIO_ERROR, &element->e_object, "Manfest segment missing file_index property");
+      return HIO_ERR_NOT_FOUND;
+    }
+
+    rc = hioi_element_add_segment (element, (int) file_index, (uint64_t) file_offset, (uint64_t) app_offset0,
+                                   (size_t) length);
+    if (HIO_SUCCESS != rc) {
+      return rc;
+    }
+
+    ++segment_count;
   }
 
-  if (0 == strcmp (tmp_string, "unique")) {
-    mode = HIO_SET_ELEMENT_UNIQUE;
-  } else if (0 == strcmp (tmp_string, "shared")) {
-    mode = HIO_SET_ELEMENT_SHARED;
-  } else {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object,
-                   "unknown dataset mode specified in manifest: %s", (const char *) tmp_string);
-    return HIO_ERR_BAD_PARAM;
-  }
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "parsed %d segments in element %s", segment_count,
+            hioi_object_identifier (&element->e_object));
+
+  return (HIO_ERR_NOT_FOUND == rc) ? HIO_SUCCESS : rc;
+}
+
+static hio_element_t hioi_manifest_stream_lookup_element (hio_dataset_t dataset, const char *identifier, int rank,
+                                                          bool *new_element) {
+  hio_element_t element;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    if (!strcmp (hioi_object_identifier(element), identifier) && rank == element->e_rank) {
+      *new_element = false;
+      return element;
+    }
+  }
+
+  element = hioi_element_alloc (dataset, identifier, rank);
+  *new_element = (NULL != element);
+
+  return element;
+}
+
+static int hioi_manifest_stream_element (hioi_manifest_stream_t *stream, hio_dataset_t dataset) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  int64_t size = 0, rank = -1;
+  const char *segments = NULL, *key, *value;
+  hio_element_t element = NULL;
+  bool new_element = false, first = true, found_size = false;
+  bool unique = HIO_SET_ELEMENT_UNIQUE == dataset->ds_mode;
+  char *identifier = NULL;
+  int rc;
+
+  if (!hioi_manifest_stream_accept (stream, '{')) {
+    return HIO_ERROR;
+  }
+
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_key (stream, first, &key))) {
+    first = false;
+
+    if (0 == strcmp (key, HIO_MANIFEST_PROP_IDENTIFIER)) {
+      rc = hioi_manifest_stream_string (stream, &value);
+      if (HIO_SUCCESS == rc) {
+        free (identifier);
+        identifier = strdup (value);
+        if (NULL == identifier) {
+          rc = HIO_ERR_OUT_OF_RESOURCE;
+        }
+      }
+    } else if (0 == strcmp (key, HIO_MANIFEST_PROP_SIZE)) {
+      rc = hioi_manifest_stream_number (stream, &size);
+      found_size = true;
+    } else if (0 == strcmp (key, HIO_MANIFEST_PROP_RANK)) {
+      rc = hioi_manifest_stream_number (stream, &rank);
+    } else if (0 == strcmp (key, "segments") && NULL == element && NULL != identifier && (!unique || rank >= 0)) {
+      if (unique && rank != context->c_rank) {
+        /* segments belong to another rank */
+        rc = hioi_manifest_stream_skip (stream);
+      } else {
+        /* the element is known. add the segments directly to it */
+        element = hioi_manifest_stream_lookup_element (dataset, identifier, unique ? (int) rank : -1, &new_element);
+        rc = (NULL == element) ? HIO_ERR_OUT_OF_RESOURCE : hioi_manifest_stream_segments (stream, element);
+      }
+    } else if (0 == strcmp (key, "segments")) {
+      /* the element is not yet known. parse the segments after the element has been read */
+      (void) hioi_manifest_stream_peek (stream);
+      segments = stream->ms_cur;
+      rc = hioi_manifest_stream_skip (stream);
+    } else {
+      rc = hioi_manifest_stream_skip (stream);
+    }
+
+    if (HIO_SUCCESS != rc) {
+      break;
+    }
+  }
+
+  do {
+    if (HIO_ERR_NOT_FOUND != rc) {
+      if (HIO_SUCCESS == rc) {
+        rc = HIO_ERROR;
+      }
+      break;
+    }
+
+    if (NULL == identifier) {
+      hioi_err_push (HIO_ERROR, &dataset->ds_object, "manifest element missing identifier property");
+      rc = HIO_ERROR;
+      break;
+    }
+
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "parsing manifest element: %s", identifier);
+
+    if (unique) {
+      if (0 > rank) {
+        rc = HIO_ERR_BAD_PARAM;
+        break;
+      }
+
+      if (rank != context->c_rank) {
+        /* nothing to do */
+        rc = HIO_SUCCESS;
+        break;
+      }
+    }
+
+    if (NULL == element) {
+      element = hioi_manifest_stream_lookup_element (dataset, identifier, unique ? (int) rank : -1, &new_element);
+      if (NULL == element) {
+        rc = HIO_ERR_OUT_OF_RESOURCE;
+        break;
+      }
+    }
+
+    if (!found_size) {
+      rc = HIO_ERR_BAD_PARAM;
+      break;
+    }
+
+    if (unique || size > element->e_size) {
+      element->e_size = size;
+    }
 
-  if (mode != dataset->ds_mode) {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object,
-                   "mismatch in dataset mode. requested: %d, actual: %d", mode,
-                   dataset->ds_mode);
-    return HIO_ERR_BAD_PARAM;
-  }
+    if (NULL != segments) {
+      const char *save = stream->ms_cur;
 
-  if (HIO_SET_ELEMENT_UNIQUE == mode) {
-    /* verify that the same number of ranks are in use */
-    rc = hioi_manifest_get_number (object, HIO_MANIFEST_KEY_COMM_SIZE, &size);
-    if (HIO_SUCCESS != rc) {
-      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "manifest missing required %s key",
-                     HIO_MANIFEST_KEY_COMM_SIZE);
-      return HIO_ERR_BAD_PARAM;
+      stream->ms_cur = segments;
+      rc = hioi_manifest_stream_segments (stream, element);
+      stream->ms_cur = save;
+      if (HIO_SUCCESS != rc) {
+        break;
+      }
     }
 
-    if (size != context->c_size) {
-      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "communicator size does not match dataset",
-                     HIO_MANIFEST_KEY_COMM_SIZE);
-      return HIO_ERR_BAD_PARAM;
+    if (new_element) {
+      hioi_dataset_add_element (dataset, element);
+      new_element = false;
     }
-  }
 
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_KEY_FILE_MODE, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "file mode was not specified in manifest");
-    return HIO_ERR_BAD_PARAM;
-  }
+    hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "found element with identifier %s in manifest",
+              element->e_object.identifier);
 
-  rc = hio_config_set_value (&dataset->ds_object, "dataset_file_mode", (const char *) tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "bad file mode: %s", tmp_string);
-    return HIO_ERR_BAD_PARAM;
-  }
+    rc = HIO_SUCCESS;
+  } while (0);
 
-  rc = hioi_manifest_get_signed_number (object, HIO_MANIFEST_KEY_STATUS, &status);
-  if (HIO_SUCCESS != rc) {
-    return HIO_ERR_BAD_PARAM;
+  if (new_element) {
+    hioi_object_release (&element->e_object);
   }
 
-  dataset->ds_status = status;
-
-  /* find and parse all elements covered by this manifest */
-  elements_object = hioi_manifest_find_object (object, "elements");
-  if (NULL == elements_object) {
-    /* no elements in this file */
-    return HIO_SUCCESS;
-  }
+  free (identifier);
 
-  return hioi_manifest_parse_elements_2_0 (dataset, elements_object);
+  return rc;
 }
 
-static int hioi_manifest_parse_3_0 (hio_dataset_t dataset, json_object *object) {
+static int hioi_manifest_stream_elements (hioi_manifest_stream_t *stream, hioi_manifest_info_t *info, void *ctx) {
+  hio_dataset_t dataset = (hio_dataset_t) ctx;
   hio_context_t context = hioi_object_context (&dataset->ds_object);
-  json_object *elements_object, *config;
-  unsigned long mode = 0, size;
-  const char *tmp_string;
-  long status;
-  int rc;
+  unsigned required = HIO_MANIFEST_FOUND_COMPAT | HIO_MANIFEST_FOUND_DATASET_MODE | HIO_MANIFEST_FOUND_STATUS;
+  int rc, element_count = 0;
 
-  /* check for compatibility with this manifest version */
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_PROP_COMPAT, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (rc, &dataset->ds_object, "manifest missing required %s key",
-                   HIO_MANIFEST_PROP_COMPAT);
-    return rc;
+  if (HIO_SET_ELEMENT_UNIQUE == dataset->ds_mode) {
+    required |= HIO_MANIFEST_FOUND_COMM_SIZE;
   }
 
-  if (strcmp ((char *) tmp_string, "3.0")) {
-    /* incompatible version */
-    return hioi_manifest_parse_2_0 (dataset, object);
+  if (0 == strcmp (info->mi_compat, "2.0")) {
+    required |= HIO_MANIFEST_FOUND_FILE_MODE;
   }
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "compatibility version of manifest: %s",
-            (char *) tmp_string);
+  if (!info->mi_final && (info->mi_found & required) != required) {
+    /* the header must be verified before any elements are added */
+    return HIO_ERR_NOT_AVAILABLE;
+  }
 
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_KEY_DATASET_MODE, &tmp_string);
+  rc = hioi_manifest_stream_apply_header (dataset, info);
   if (HIO_SUCCESS != rc) {
-    hioi_err_push (rc, &dataset->ds_object, "manifest missing required %s key",
-                   HIO_MANIFEST_KEY_DATASET_MODE);
     return rc;
   }
 
-  if (0 == strcmp (tmp_string, "unique")) {
-    mode = HIO_SET_ELEMENT_UNIQUE;
-  } else if (0 == strcmp (tmp_string, "shared")) {
-    mode = HIO_SET_ELEMENT_SHARED;
-  } else {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object,
-                   "unknown dataset mode specified in manifest: %s", (const char *) tmp_string);
-    return HIO_ERR_BAD_PARAM;
-  }
+  info->mi_found |= HIO_MANIFEST_FOUND_ELEMENTS;
 
-  if (mode != dataset->ds_mode) {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object,
-                   "mismatch in dataset mode. requested: %d, actual: %d", mode,
-                   dataset->ds_mode);
-    return HIO_ERR_BAD_PARAM;
+  if (!hioi_manifest_stream_accept (stream, '[')) {
+    return HIO_ERROR;
   }
 
-  if (HIO_SET_ELEMENT_UNIQUE == mode) {
-    /* verify that the same number of ranks are in use */
-    rc = hioi_manifest_get_number (object, HIO_MANIFEST_KEY_COMM_SIZE, &size);
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_next_item (stream, 0 == element_count))) {
+    rc = hioi_manifest_stream_element (stream, dataset);
     if (HIO_SUCCESS != rc) {
-      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "manifest missing required %s key",
-                     HIO_MANIFEST_KEY_COMM_SIZE);
-      return HIO_ERR_BAD_PARAM;
-    }
-
-    if (size != context->c_size) {
-      hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "communicator size does not match dataset",
-                     HIO_MANIFEST_KEY_COMM_SIZE);
-      return HIO_ERR_BAD_PARAM;
-    }
-  }
-
-
-  config = hioi_manifest_find_object (object, "config");
-  if (NULL != config) {
-    json_object_object_foreach (object, key, value) {
-      hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "found manifest configuration key %s", key);
-      rc = hio_config_set_value (&dataset->ds_object, key, json_object_get_string (value));
-      if (HIO_SUCCESS != rc) {
-        hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "error parsing manifest configuration key: %s", key);
-      }
+      return rc;
     }
-  }
 
-  rc = hioi_manifest_get_signed_number (object, HIO_MANIFEST_KEY_STATUS, &status);
-  if (HIO_SUCCESS != rc) {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &dataset->ds_object, "manifest status key missing");
-    return HIO_ERR_BAD_PARAM;
+    ++element_count;
   }
 
-  dataset->ds_status = status;
-
-  /* find and parse all elements covered by this manifest */
-  elements_object = hioi_manifest_find_object (object, "elements");
-  if (NULL == elements_object) {
-    /* no elements in this file */
-    return HIO_SUCCESS;
-  }
+  hioi_log (context, HIO_VERBOSE_DEBUG_MED, "parsed %d elements in manifest", element_count);
 
-  return hioi_manifest_parse_elements_2_0 (dataset, elements_object);
+  return (HIO_ERR_NOT_FOUND == rc) ? HIO_SUCCESS : rc;
 }
 
-static int hioi_manifest_parse_header_2_0 (hio_context_t context, hio_dataset_header_t *header, json_object *object) {
-  const char *tmp_string;
-  unsigned long value;
-  long svalue;
-  int rc;
-
-  /* check for compatibility with this manifest version */
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_PROP_COMPAT, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    return rc;
-  }
+/** list of ranks found in a manifest */
+typedef struct hioi_manifest_rank_list_t {
+  int   *rl_ranks;
+  int    rl_count;
+  int    rl_size;
+} hioi_manifest_rank_list_t;
 
-  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "compatibility version of manifest: %s", (char *) tmp_string);
+static int hioi_manifest_stream_element_ranks (hioi_manifest_stream_t *stream, hioi_manifest_info_t *info, void *ctx) {
+  hioi_manifest_rank_list_t *list = (hioi_manifest_rank_list_t *) ctx;
+  int rc, element_count = 0;
+  const char *key;
 
-  if (strcmp (tmp_string, "2.0") && strcmp (tmp_string, "3.0")) {
-    /* incompatible version */
+  if (!hioi_manifest_stream_accept (stream, '[')) {
     return HIO_ERROR;
   }
 
-  /* fill in header */
-  rc = hioi_manifest_get_string (object, HIO_MANIFEST_KEY_DATASET_MODE, &tmp_string);
-  if (HIO_SUCCESS != rc) {
-    return rc;
-  }
-
-  if (0 == strcmp (tmp_string, "unique")) {
-    value = HIO_SET_ELEMENT_UNIQUE;
-  } else if (0 == strcmp (tmp_string, "shared")) {
-    value = HIO_SET_ELEMENT_SHARED;
-  } else {
-    hioi_err_push (HIO_ERR_BAD_PARAM, &context->c_object, "unknown dataset mode specified in manifest: "
-                  "%s", tmp_string);
-    return HIO_ERR_BAD_PARAM;
-  }
+  while (HIO_SUCCESS == (rc = hioi_manifest_stream_next_item (stream, 0 == element_count))) {
+    bool first = true;
+    int64_t rank = -1;
 
-  if (HIO_SUCCESS != rc) {
-    return HIO_ERR_BAD_PARAM;
-  }
+    ++element_count;
 
-  header->ds_mode = value;
+    if (!hioi_manifest_stream_accept (stream, '{')) {
+      return HIO_ERROR;
+    }
 
-  rc = hioi_manifest_get_signed_number (object, HIO_MANIFEST_KEY_STATUS, &svalue);
+    while (HIO_SUCCESS == (rc = hioi_manifest_stream_key (stream, first, &key))) {
+      first = false;
 
-  if (HIO_SUCCESS != rc) {
-    return HIO_ERR_BAD_PARAM;
-  }
+      if (0 == strcmp (key, HIO_MANIFEST_PROP_RANK)) {
+        rc = hioi_manifest_stream_number (stream, &rank);
+      } else {
+        /* segments are skipped without being decoded */
+        rc = hioi_manifest_stream_skip (stream);
+      }
 
-  header->ds_status = svalue;
+      if (HIO_SUCCESS != rc) {
+        return rc;
+      }
+    }
 
-  rc = hioi_manifest_get_number (object, HIO_MANIFEST_KEY_MTIME, &value);
+    if (HIO_ERR_NOT_FOUND != rc) {
+      return rc;
+    }
 
-  if (HIO_SUCCESS != rc) {
-    return HIO_ERR_BAD_PARAM;
-  }
+    if (0 > rank) {
+      return HIO_ERR_NOT_FOUND;
+    }
 
-  header->ds_mtime = value;
+    if (list->rl_count == list->rl_size) {
+      int new_size = list->rl_size ? list->rl_size * 2 : 64;
+      int *tmp = realloc (list->rl_ranks, new_size * sizeof (int));
+      if (NULL == tmp) {
+        return HIO_ERR_OUT_OF_RESOURCE;
+      }
 
-  rc = hioi_manifest_get_number (object, HIO_MANIFEST_PROP_DATASET_ID, &value);
+      list->rl_ranks = tmp;
+      list->rl_size = new_size;
+    }
 
-  if (HIO_SUCCESS != rc) {
-    return HIO_ERR_BAD_PARAM;
+    list->rl_ranks[list->rl_count++] = (int) rank;
   }
 
-  header->ds_id = value;
-
-  return HIO_SUCCESS;
+  return (HIO_ERR_NOT_FOUND == rc) ? HIO_SUCCESS : rc;
 }
 
-static int hioi_manifest_decompress (unsigned char **data, size_t data_size) {
+static int hioi_manifest_decompress (unsigned char **data, size_t *data_size) {
   const size_t increment = 8192;
   char *uncompressed, *tmp;
   bz_stream strm;
@@ -784,7 +1362,7 @@ static int hioi_manifest_decompress (unsigned char **data, size_t data_size) {
   strm.bzfree = NULL;
   strm.opaque = NULL;
   strm.next_in = (char *) *data;
-  strm.avail_in = data_size;
+  strm.avail_in = *data_size;
   strm.next_out = uncompressed;
   strm.avail_out = size = increment;
 
@@ -816,12 +1394,14 @@ static int hioi_manifest_decompress (unsigned char **data, size_t data_size) {
   } while (1);
 
   *data = (unsigned char *) uncompressed;
+  *data_size = size - strm.avail_out;
   return HIO_SUCCESS;
 }
 
 int hioi_manifest_deserialize (hio_dataset_t dataset, const unsigned char *data, size_t data_size) {
+  hioi_manifest_stream_t stream;
+  hioi_manifest_info_t info;
   bool free_data = false;
-  json_object *object;
   int rc;
 
   if (data_size < 2 || NULL == data) {
@@ -830,7 +1410,7 @@ int hioi_manifest_deserialize (hio_dataset_t dataset, const unsigned char *data,
 
   if ('B' == data[0] && 'Z' == data[1]) {
     /* gz compressed */
-    rc = hioi_manifest_decompress ((unsigned char **) &data, data_size);
+    rc = hioi_manifest_decompress ((unsigned char **) &data, &data_size);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
@@ -838,15 +1418,15 @@ int hioi_manifest_deserialize (hio_dataset_t dataset, const unsigned char *data,
     free_data = true;
   }
 
-  object = json_tokener_parse ((char *) data);
-  if (NULL == object) {
-    if (free_data) {
-      free ((char *) data);
-    }
-    return HIO_ERROR;
+  hioi_manifest_stream_init (&stream, data, data_size);
+  rc = hioi_manifest_stream_walk (&stream, &info, hioi_manifest_stream_elements, dataset, 0);
+  if (HIO_SUCCESS == rc && !(info.mi_found & HIO_MANIFEST_FOUND_ELEMENTS)) {
+    /* no elements in this manifest */
+    rc = hioi_manifest_stream_apply_header (dataset, &info);
   }
+  hioi_manifest_info_fini (&info);
+  hioi_manifest_stream_fini (&stream);
 
-  rc = hioi_manifest_parse_3_0 (dataset, object);
   if (free_data) {
     free ((char *) data);
   }
@@ -991,7 +1571,63 @@ static int segment_compare (const void *arg1, const void *arg2) {
   return (base1 < base2) ? -1 : 0;
 }
 
-static int hioi_manifest_merge_internal (json_object *object1, json_object *object2) {
+/**
+ * Compact a sorted json segment array
+ *
+ * @param[in] element  json element object containing the segments
+ * @param[in] segments sorted json segment array
+ *
+ * Equivalent of hioi_element_compact_segments() for the merged manifest.
+ */
+static int hioi_manifest_compact_segments_json (json_object *element, json_object *segments) {
+  int segment_count = json_object_array_length (segments);
+  unsigned long last_offset = 0, last_foffset = 0, last_findex = 0, last_length = 0;
+  json_object *compact, *last = NULL;
+
+  compact = json_object_new_array ();
+  if (NULL == compact) {
+    return HIO_ERR_OUT_OF_RESOURCE;
+  }
+
+  for (int i = 0 ; i < segment_count ; ++i) {
+    json_object *segment = json_object_array_get_idx (segments, i);
+    unsigned long offset = 0, foffset = 0, findex = 0, length = 0;
+
+    (void) hioi_manifest_get_number (segment, HIO_SEGMENT_KEY_APP_OFFSET0, &offset);
+    (void) hioi_manifest_get_number (segment, HIO_SEGMENT_KEY_FILE_OFFSET, &foffset);
+    (void) hioi_manifest_get_number (segment, HIO_SEGMENT_KEY_FILE_INDEX, &findex);
+    (void) hioi_manifest_get_number (segment, HIO_SEGMENT_KEY_LENGTH, &length);
+
+    if (0 == length) {
+      continue;
+    }
+
+    if (NULL != last) {
+      if (offset == last_offset + last_length && findex == last_findex && foffset == last_foffset + last_length) {
+        last_length += length;
+        json_object_object_del (last, HIO_SEGMENT_KEY_LENGTH);
+        hioi_manifest_set_number (last, HIO_SEGMENT_KEY_LENGTH, last_length);
+        continue;
+      }
+    }
+
+    json_object_get (segment);
+    json_object_array_add (compact, segment);
+
+    last = segment;
+    last_offset = offset;
+    last_foffset = foffset;
+    last_findex = findex;
+    last_length = length;
+  }
+
+  /* replaces (and releases) the original segment array */
+  json_object_object_add (element, "segments", compact);
+
+  return HIO_SUCCESS;
+}
+
+static int hioi_manifest_merge_internal (hio_dataset_t dataset, json_object *object1, json_object *object2) {
   json_object *elements1, *elements2;
   int rc, manifest_mode;
   const char *tmp_string;
@@ -1072,8 +1708,12 @@ static int hioi_manifest_merge_internal (json_object *object1, json_object *obje
           }
 
           json_object_put (segments);
-          /* re-sort the segment array by base pointer */
+          /* re-sort the segment array by base pointer and fuse contiguous runs */
           json_object_array_sort (segments1, segment_compare);
+          rc = hioi_manifest_compact_segments_json (element1, segments1);
+          if (HIO_SUCCESS != rc) {
+            return rc;
+          }
         } else {
           json_object_object_add (element1, "segments", segments);
         }
@@ -1099,7 +1739,8 @@ static int hioi_manifest_merge_internal (json_object *object1, json_object *obje
   return HIO_SUCCESS;
 }
 
-int hioi_manifest_merge_data2 (unsigned char **data1, size_t *data1_size, const unsigned char *data2, size_t data2_size) {
+int hioi_manifest_merge_data2 (hio_dataset_t dataset, unsigned char **data1, size_t *data1_size, const unsigned char *data2,
+                               size_t data2_size) {
   bool free_data2 = false, compressed = false;
   json_object *object1, *object2;
   unsigned char *data1_save;
@@ -1125,7 +1766,7 @@ int hioi_manifest_merge_data2 (unsigned char **data1, size_t *data1_size, const
   if ('B' == data1[0][0] && 'Z' == data1[0][1]) {
     data1_save = data1[0];
     /* bz2 compressed */
-    rc = hioi_manifest_decompress (data1, *data1_size);
+    rc = hioi_manifest_decompress (data1, data1_size);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
@@ -1142,7 +1783,7 @@ int hioi_manifest_merge_data2 (unsigned char **data1, size_t *data1_size, const
   /* decompress the data if necessary */
   if ('B' == data2[0] && 'Z' == data2[1]) {
     /* bz2 compressed */
-    rc = hioi_manifest_decompress ((unsigned char **) &data2, data2_size);
+    rc = hioi_manifest_decompress ((unsigned char **) &data2, &data2_size);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
@@ -1156,7 +1797,7 @@ int hioi_manifest_merge_data2 (unsigned char **data1, size_t *data1_size, const
     return HIO_ERROR;
   }
 
-  rc = hioi_manifest_merge_internal (object1, object2);
+  rc = hioi_manifest_merge_internal (dataset, object1, object2);
   if (free_data2) {
     free ((void *) data2);
   }
@@ -1179,16 +1820,15 @@ static int rank_compare (const void *a, const void *b) {
 }
 
 int hioi_manifest_ranks (const unsigned char *manifest, size_t manifest_size, int **ranks, int *rank_count) {
-  json_object *object = NULL, *elements;
-  int manifest_ranks, element_count;
-  unsigned char *rank_map = NULL;
+  hioi_manifest_rank_list_t list = {.rl_ranks = NULL, .rl_count = 0, .rl_size = 0};
+  hioi_manifest_stream_t stream;
+  hioi_manifest_info_t info;
   bool free_manifest = false;
-  int rc = HIO_SUCCESS;
-  unsigned long size;
+  int rc, manifest_ranks;
 
   if ('B' == manifest[0] && 'Z' == manifest[1]) {
     /* bz2 compressed */
-    rc = hioi_manifest_decompress ((unsigned char **) &manifest, manifest_size);
+    rc = hioi_manifest_decompress ((unsigned char **) &manifest, &manifest_size);
     if (HIO_SUCCESS != rc) {
       return rc;
     }
@@ -1197,16 +1837,22 @@ int hioi_manifest_ranks (const unsigned char *manifest, size_t manifest_size, in
     free_manifest = true;
   }
 
+  /* only the rank of each element is decoded. segment data is skipped */
+  hioi_manifest_stream_init (&stream, manifest, manifest_size);
+  rc = hioi_manifest_stream_walk (&stream, &info, hioi_manifest_stream_element_ranks, &list, 0);
+  hioi_manifest_info_fini (&info);
+  hioi_manifest_stream_fini (&stream);
+
+  if (free_manifest) {
+    free ((void *) manifest);
+  }
+
   do {
-    object = json_tokener_parse ((char *) manifest);
-    if (NULL == object) {
-      rc = HIO_ERROR;
+    if (HIO_SUCCESS != rc) {
       break;
     }
 
-    elements = hioi_manifest_find_object (object, "elements");
-    element_count = elements ? json_object_array_length (elements) : 0;
-    if (0 == element_count) {
+    if (0 == list.rl_count) {
       /* no elements */
       *ranks = NULL;
       *rank_count = 0;
@@ -1214,41 +1860,23 @@ int hioi_manifest_ranks (const unsigned char *manifest, size_t manifest_size, in
     }
 
     /* find out how many ranks were used to write the manifest */
-    rc = hioi_manifest_get_number (object, HIO_MANIFEST_KEY_COMM_SIZE, &size);
-    if (HIO_SUCCESS != rc) {
+    if (!(info.mi_found & HIO_MANIFEST_FOUND_COMM_SIZE)) {
+      rc = HIO_ERR_NOT_FOUND;
       break;
     }
 
-    rank_map = calloc (1, (size >> 3) + 1);
-    if (NULL == rank_map) {
-      rc = HIO_ERR_OUT_OF_RESOURCE;
-      break;
-    }
+    /* sort the rank array by rank and remove duplicates */
+    (void) qsort (list.rl_ranks, list.rl_count, sizeof (int), rank_compare);
 
     manifest_ranks = 0;
-
-    /* allocate enough space to hold the maximum number of ranks that
-     * can appear in the manifest. */
-    *ranks = (int *) calloc (element_count, sizeof (ranks[0][0]));
-    if (NULL == *ranks) {
-      rc = HIO_ERR_OUT_OF_RESOURCE;
-      break;
-    }
-
-    for (int i = 0 ; i < element_count ; ++i) {
-      json_object *element = json_object_array_get_idx (elements, i);
-      unsigned long rank;
-
-      assert (NULL != element);
-
-      rc = hioi_manifest_get_number (element, HIO_MANIFEST_PROP_RANK, &rank);
-      if (HIO_SUCCESS != rc) {
+    for (int i = 0 ; i < list.rl_count ; ++i) {
+      if (list.rl_ranks[i] >= info.mi_comm_size) {
+        rc = HIO_ERR_BAD_PARAM;
         break;
       }
 
-      if (!(rank_map[rank >> 3] & (1 << (rank & 0x7)))) {
-        ranks[0][manifest_ranks++] = (int) rank;
-        rank_map[rank >> 3] |= 1 << (rank & 0x7);
+      if (0 == manifest_ranks || list.rl_ranks[i] != list.rl_ranks[manifest_ranks - 1]) {
+        list.rl_ranks[manifest_ranks++] = list.rl_ranks[i];
       }
     }
 
@@ -1256,45 +1884,95 @@ int hioi_manifest_ranks (const unsigned char *manifest, size_t manifest_size, in
       break;
     }
 
-    if (0 == manifest_ranks) {
-      free (*ranks);
-      *ranks = NULL;
-      rc = HIO_ERR_BAD_PARAM;
-      break;
-    }
-
     /* shrink the array if there were fewer ranks than elements */
-    void *tmp = realloc (*ranks, sizeof (ranks[0][0]) * manifest_ranks);
-    if (NULL == tmp) {
-      free (*ranks);
-      *ranks = NULL;
+    *ranks = (int *) realloc (list.rl_ranks, sizeof (int) * manifest_ranks);
+    if (NULL == *ranks) {
       rc = HIO_ERR_OUT_OF_RESOURCE;
       break;
     }
-    *ranks = (int *) tmp;
 
-    /* sort the rank array by rank */
-    (void) qsort (*ranks, manifest_ranks, sizeof (int), rank_compare);
+    list.rl_ranks = NULL;
     *rank_count = manifest_ranks;
   } while (0);
 
-  if (object) {
-    json_object_put (object);
-  }
+  free (list.rl_ranks);
 
-  if (free_manifest) {
-    free ((void *) manifest);
+  return rc;
+}
+
+/**
+ * Read the header values of a bz2 compressed manifest
+ *
+ * The header values are near the start of the manifest. Rather than decompressing the
+ * whole manifest the file is decompressed a piece at a time, doubling the amount each
+ * round, until the values have been found in the data decompressed so far.
+ */
+static int hioi_manifest_read_header_bz2 (FILE *fh, hioi_manifest_info_t *info, unsigned stop_mask) {
+  size_t size = 0, target = 16384;
+  hioi_manifest_stream_t stream;
+  char *buffer = NULL, *tmp;
+  bool done = false;
+  int rc, bzerr;
+  BZFILE *bzf;
+
+  memset (info, 0, sizeof (*info));
+
+  bzf = BZ2_bzReadOpen (&bzerr, fh, 0, 0, NULL, 0);
+  if (BZ_OK != bzerr) {
+    return HIO_ERROR;
   }
 
-  free (rank_map);
+  do {
+    tmp = realloc (buffer, target);
+    if (NULL == tmp) {
+      rc = HIO_ERR_OUT_OF_RESOURCE;
+      break;
+    }
+    buffer = tmp;
+
+    while (size < target && !done) {
+      int count = BZ2_bzRead (&bzerr, bzf, buffer + size, (int) (target - size));
+      if (BZ_OK != bzerr && BZ_STREAM_END != bzerr) {
+        break;
+      }
+
+      size += count;
+      done = (BZ_STREAM_END == bzerr);
+    }
+
+    if (BZ_OK != bzerr && BZ_STREAM_END != bzerr) {
+      rc = HIO_ERROR;
+      break;
+    }
+
+    hioi_manifest_stream_init (&stream, (unsigned char *) buffer, size);
+    rc = hioi_manifest_stream_walk (&stream, info, NULL, NULL, stop_mask);
+    /* a number at the very end of the data decompressed so far may be cut short */
+    if (done || (HIO_SUCCESS == rc && (info->mi_found & stop_mask) == stop_mask && stream.ms_cur < stream.ms_end)) {
+      hioi_manifest_stream_fini (&stream);
+      break;
+    }
+
+    hioi_manifest_stream_fini (&stream);
+    hioi_manifest_info_fini (info);
+    target *= 2;
+  } while (1);
+
+  BZ2_bzReadClose (&bzerr, bzf);
+  free (buffer);
 
   return rc;
 }
 
 int hioi_manifest_read_header (hio_context_t context, hio_dataset_header_t *header, const char *path) {
+  const unsigned stop_mask = HIO_MANIFEST_FOUND_COMPAT | HIO_MANIFEST_FOUND_DATASET_MODE | HIO_MANIFEST_FOUND_STATUS |
+    HIO_MANIFEST_FOUND_MTIME | HIO_MANIFEST_FOUND_DATASET_ID;
   unsigned char *manifest = NULL;
+  hioi_manifest_stream_t stream;
+  hioi_manifest_info_t info;
   size_t manifest_size;
-  json_object *object;
+  char magic[2];
+  FILE *fh;
   int rc;
 
   hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "loading json dataset manifest header from %s", path);
@@ -1307,31 +1985,67 @@ int hioi_manifest_read_header (hio_context_t context, hio_dataset_header_t *head
     return HIO_ERR_PERM;
   }
 
-  rc = hioi_manifest_read (path, &manifest, &manifest_size);
-  if (HIO_SUCCESS != rc || NULL == manifest) {
-    return rc;
+  fh = fopen (path, "r");
+  if (NULL == fh) {
+    return hioi_err_errno (errno);
   }
 
-  if ('B' == manifest[0] && 'Z' == manifest[1]) {
-    unsigned char *data = manifest;
-    /* gz compressed */
-    rc = hioi_manifest_decompress ((unsigned char **) &data, manifest_size);
-    if (HIO_SUCCESS != rc) {
+  if (2 == fread (magic, 1, 2, fh) && 'B' == magic[0] && 'Z' == magic[1]) {
+    /* bz2 compressed */
+    rewind (fh);
+    rc = hioi_manifest_read_header_bz2 (fh, &info, stop_mask);
+    fclose (fh);
+  } else {
+    fclose (fh);
+
+    rc = hioi_manifest_read (path, &manifest, &manifest_size);
+    if (HIO_SUCCESS != rc || NULL == manifest) {
       return rc;
     }
+
+    /* stop reading as soon as the header values have been found */
+    hioi_manifest_stream_init (&stream, manifest, manifest_size);
+    rc = hioi_manifest_stream_walk (&stream, &info, NULL, NULL, stop_mask);
+    hioi_manifest_stream_fini (&stream);
     free (manifest);
-    manifest = data;
   }
 
-  object = json_tokener_parse ((char *) manifest);
-  if (NULL == object) {
-    free (manifest);
+  hioi_manifest_info_fini (&info);
+
+  if (HIO_SUCCESS != rc) {
+    return rc;
+  }
+
+  /* check for compatibility with this manifest version */
+  if (!(info.mi_found & HIO_MANIFEST_FOUND_COMPAT)) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  hioi_log (context, HIO_VERBOSE_DEBUG_LOW, "compatibility version of manifest: %s", info.mi_compat);
+
+  if (strcmp (info.mi_compat, "2.0") && strcmp (info.mi_compat, "3.0")) {
+    /* incompatible version */
     return HIO_ERROR;
   }
 
-  rc = hioi_manifest_parse_header_2_0 (context, header, object);
-  json_object_put (object);
-  free (manifest);
+  /* fill in header */
+  if (!(info.mi_found & HIO_MANIFEST_FOUND_DATASET_MODE)) {
+    return HIO_ERR_NOT_FOUND;
+  }
 
-  return rc;
+  if (0 > info.mi_dataset_mode) {
+    hioi_err_push (HIO_ERR_BAD_PARAM, &context->c_object, "unknown dataset mode specified in manifest");
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  if ((info.mi_found & stop_mask) != stop_mask) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  header->ds_mode = info.mi_dataset_mode;
+  header->ds_status = (int) info.mi_status;
+  header->ds_mtime = (uint64_t) info.mi_mtime;
+  header->ds_id = (uint64_t) info.mi_dataset_id;
+
+  return HIO_SUCCESS;
 }
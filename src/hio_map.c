@@ -47,31 +47,6 @@ typedef struct hio_map_element_t {
   uint32_t me_index;
 } hio_map_element_t;
 
-typedef struct hio_map_segment_t {
-  hio_map_item_common_t ms_common;
-
-  struct hio_map_segment_key_t {
-    /** reserved for future use (padding) */
-    uint32_t ms_resv0;
-    /** element index */
-    uint32_t ms_index;
-    /** segment application offset */
-    uint64_t ms_aoff;
-    /** segment size */
-    uint64_t ms_size;
-  } key;
-
-  struct hio_map_segment_value_t {
-    /* file address */
-    /** reserved for future use (padding) */
-    uint32_t ms_resv1;
-    /** index of file holding the segment */
-    uint32_t ms_findex;
-    /** offset of segment within the file */
-    uint64_t ms_foff;
-  } value;
-} hio_map_segment_t;
-
 typedef bool (*hioi_map_key_compare_fn_t) (const void *a, const void *b);
 typedef void (*hioi_map_element_prepare_fn_t) (MPI_Win win, void *data, void *key, int64_t count);
 typedef uint64_t (*hioi_map_hash_fn_t) (void *value);
@@ -81,13 +56,6 @@ static void hioi_prepare_element (MPI_Win win, void *data, void *value, int64_t
   map_element->me_index = count;
 }
 
-static void hioi_prepare_segment (MPI_Win win, void *data, void *value, int64_t count) {
-  hio_map_segment_t *map_segment = (hio_map_segment_t *) data;
-  struct hio_map_segment_value_t *ms_value = (struct hio_map_segment_value_t *) value;
-
-  map_segment->value = ms_value[0];
-}
-
 static uint64_t hioi_hash_element (void *key) {
   char *key_string = (char *) key;
   uint64_t value = 5381;
@@ -99,58 +67,32 @@ static uint64_t hioi_hash_element (void *key) {
   return value;
 }
 
-static uint64_t hioi_hash_int64 (int64_t key) {
-  uint64_t value = (uint64_t) key;
-
-  value += ~(value << 15);
-  value ^= value >> 10;
-  value += value << 3;
-  value ^= value >> 6;
-  value += ~(value >> 11);
-  value ^= value >> 16;
-
-  return value;
-}
-
-#define HIOI_DEFINE_HASH(bits)                                          \
-  static uint64_t hioi_hash_segment_ ## bits (void *key) {               \
-    struct hio_map_segment_key_t *ms_key = (struct hio_map_segment_key_t *) key; \
-    int64_t app_offset = ms_key->ms_aoff & ~ ((1l << bits) - 1);        \
-    return hioi_hash_int64 (app_offset);                                \
-  }
-
-HIOI_DEFINE_HASH(10)
-HIOI_DEFINE_HASH(20)
-HIOI_DEFINE_HASH(27)
-HIOI_DEFINE_HASH(30)
-HIOI_DEFINE_HASH(40)
-HIOI_DEFINE_HASH(50)
-
-struct hio_segment_hash_t {
-  size_t sh_bits;
-  hioi_map_hash_fn_t sh_fn;
-};
-
-static const struct hio_segment_hash_t hio_segment_hashes[] = {
-  {.sh_bits = 10, .sh_fn = hioi_hash_segment_10},
-  {.sh_bits = 20, .sh_fn = hioi_hash_segment_20},
-  {.sh_bits = 27, .sh_fn = hioi_hash_segment_27},
-  {.sh_bits = 30, .sh_fn = hioi_hash_segment_30},
-  {.sh_bits = 40, .sh_fn = hioi_hash_segment_40},
-  {.sh_bits = 50, .sh_fn = hioi_hash_segment_50},
-};
-
-static const int hio_segment_hash_count = sizeof (hio_segment_hashes) / sizeof (hio_segment_hashes[0]);
-
 static bool hioi_map_compare_string (const void *a, const void *b) {
   return 0 == strcmp ((const char *) a, (const char *) b);
 }
 
-static bool hioi_map_compare_segment (const void *a, const void *b) {
-  struct hio_map_segment_key_t *sega = (struct hio_map_segment_key_t *) a;
-  struct hio_map_segment_key_t *segb = (struct hio_map_segment_key_t *) b;
+/**
+ * Get the home bucket for a hash value
+ *
+ * The first bucket contains map data so it is never used for items.
+ */
+static uint64_t hioi_map_home_bucket (hio_dataset_map_data_t *map, uint64_t hash) {
+  hash %= map->md_global_size;
+  return (0 == hash) ? 1 : hash;
+}
 
-  return (sega->ms_aoff == segb->ms_aoff) && (sega->ms_index == segb->ms_index);
+/**
+ * Get the next bucket to probe
+ *
+ * Probing wraps within the range of buckets owned by a single node leader. This
+ * allows each leader to insert items into its part of the map without communication.
+ */
+static uint64_t hioi_map_next_bucket (hio_dataset_map_data_t *map, uint64_t hash) {
+  uint64_t base = hash - hash % map->md_local_size;
+
+  hash = base + (hash + 1 - base) % map->md_local_size;
+
+  return (0 == hash) ? 1 : hash;
 }
 
 static int hioi_dataset_map_insert (hio_dataset_map_data_t *map, int *node_leaders, void *key, size_t key_len,
@@ -165,14 +107,11 @@ static int hioi_dataset_map_insert (hio_dataset_map_data_t *map, int *node_leade
   int target, target_bucket, rc;
   MPI_Aint bucket_offset;
   bool bucket_full = true;
+  size_t probes = 0;
 
-  do {
-    hash = hash % map->md_global_size;
-    if (0 == hash) {
-      /* the first bucket contains map data */
-      ++hash;
-    }
+  hash = hioi_map_home_bucket (map, hash);
 
+  do {
     target = node_leaders[hash / map->md_local_size];
     target_bucket = hash % map->md_local_size;
 
@@ -241,8 +180,13 @@ static int hioi_dataset_map_insert (hio_dataset_map_data_t *map, int *node_leade
     }
 
     if (bucket_full) {
+      if (++probes == map->md_local_size) {
+        /* every bucket owned by the target is full */
+        return HIO_ERR_OUT_OF_RESOURCE;
+      }
+
       /* move on to next bucket */
-      ++hash;
+      hash = hioi_map_next_bucket (map, hash);
     } else {
       /* sleep a little while before trying again */
       const struct timespec interval = {.tv_sec = 0, .tv_nsec = 500};
@@ -262,14 +206,11 @@ static int32_t hioi_dataset_map_search (hio_dataset_map_data_t *map, int *node_l
   int target, target_bucket, rc;
   bool next_bucket = true;
   MPI_Aint bucket_offset;
+  size_t probes = 0;
 
-  do {
-    hash = hash % map->md_global_size;
-    if (0 == hash) {
-      /* the first bucket contains map data */
-      ++hash;
-    }
+  hash = hioi_map_home_bucket (map, hash);
 
+  do {
     target = node_leaders[hash / map->md_local_size];
     target_bucket = hash % map->md_local_size;
 
@@ -303,8 +244,12 @@ static int32_t hioi_dataset_map_search (hio_dataset_map_data_t *map, int *node_l
     }
 
     if (next_bucket) {
+      if (++probes == map->md_local_size) {
+        return HIO_ERR_NOT_FOUND;
+      }
+
       /* move on to next bucket */
-      ++hash;
+      hash = hioi_map_next_bucket (map, hash);
     } else {
       /* sleep a little while before continuing */
       const struct timespec interval = {.tv_sec = 0, .tv_nsec = 1000};
@@ -325,6 +270,7 @@ static int hioi_dataset_map_data_initialize (hio_dataset_t dataset, hio_dataset_
   int rc;
 
   map->md_win = MPI_WIN_NULL;
+  map->md_base = NULL;
 
   if (0 == global_size) {
     return HIO_SUCCESS;
@@ -372,6 +318,8 @@ static int hioi_dataset_map_data_initialize (hio_dataset_t dataset, hio_dataset_
     memset (base, 0, alloc_size);
   }
 
+  map->md_base = alloc_size ? base : NULL;
+
   MPI_Barrier (context->c_comm);
 
   MPI_Win_lock_all (0, win);
@@ -413,6 +361,279 @@ int hioi_dataset_map_insert_element (hio_element_t element) {
   return rc;
 }
 
+/* bulk map construction. each node leader prepares the items for its local elements,
+ * routes them to the node leader that owns their home bucket with a single
+ * exchange, and the owner inserts them into its part of the map with local loads and
+ * stores. this replaces several round-trips per item with a few collective steps. */
+
+/** size of a bulk record: home bucket followed by the prepared map item */
+#define HIO_MAP_RECORD_SIZE(map) (sizeof (uint64_t) + (map)->md_element_size)
+
+static hio_map_item_common_t *hioi_dataset_map_insert_local (hio_dataset_map_data_t *map, uint64_t hash, void *record_item,
+                                                             hioi_map_key_compare_fn_t compare_fn, bool *placed) {
+  size_t bucket_size = HIO_MAP_BUCKET_SIZE * map->md_element_size;
+  void *key = (void *) ((hio_map_item_common_t *) record_item + 1);
+
+  *placed = false;
+
+  for (size_t probes = 0 ; probes < map->md_local_size ; ++probes) {
+    void *bucket = (void *) ((intptr_t) map->md_base + (hash % map->md_local_size) * bucket_size);
+
+    for (int i = 0 ; i < HIO_MAP_BUCKET_SIZE ; ++i) {
+      hio_map_item_common_t *item = (hio_map_item_common_t *) ((intptr_t) bucket + i * map->md_element_size);
+
+      if (HIO_MAP_STATE_FREE == item->state) {
+        memcpy (item, record_item, map->md_element_size);
+        item->state = HIO_MAP_STATE_VALID;
+        *placed = true;
+        return item;
+      }
+
+      if (compare_fn (key, (void *) (item + 1))) {
+        return item;
+      }
+    }
+
+    hash = hioi_map_next_bucket (map, hash);
+  }
+
+  return NULL;
+}
+
+/**
+ * Insert prepared records into the map
+ *
+ * @param[in]  dataset      dataset handle
+ * @param[in]  map          map to insert into
+ * @param[in]  records      packed records (see HIO_MAP_RECORD_SIZE)
+ * @param[in]  count        number of records
+ * @param[in]  compare_fn   key comparison function
+ * @param[out] indices      element map indices for each record (may be NULL)
+ *
+ * Collective over the node leader communicator. When indices is not NULL each new item is
+ * assigned a unique element map index.
+ */
+static int hioi_dataset_map_bulk_insert (hio_dataset_t dataset, hio_dataset_map_data_t *map, unsigned char *records,
+                                         size_t count, hioi_map_key_compare_fn_t compare_fn, uint32_t *indices) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  size_t record_size = HIO_MAP_RECORD_SIZE(map), kv_size = map->md_element_size - sizeof (hio_map_item_common_t);
+  int node_count = context->c_node_count, rc = HIO_SUCCESS, mpirc, leader_rank;
+  hio_map_item_common_t **slots = NULL, **new_items = NULL;
+  int *send_counts, *send_displs, *recv_counts, *recv_displs;
+  unsigned char *send_buffer = NULL, *recv_buffer = NULL;
+  size_t *order = NULL, recv_count = 0, new_count = 0;
+  uint64_t new_offset = 0, new_total = 0;
+  uint32_t *send_indices = NULL;
+
+  if (MPI_WIN_NULL == map->md_win) {
+    /* empty map */
+    return HIO_SUCCESS;
+  }
+
+  MPI_Comm_rank (context->c_node_leader_comm, &leader_rank);
+
+  send_counts = calloc (4 * node_count, sizeof (int));
+  assert (NULL != send_counts);
+  send_displs = send_counts + node_count;
+  recv_counts = send_displs + node_count;
+  recv_displs = recv_counts + node_count;
+
+  do {
+    /* partition records by owning leader */
+    for (size_t i = 0 ; i < count ; ++i) {
+      uint64_t hash;
+
+      memcpy (&hash, records + i * record_size, sizeof (hash));
+      ++send_counts[hash / map->md_local_size];
+    }
+
+    for (int i = 0, offset = 0 ; i < node_count ; ++i) {
+      send_displs[i] = offset;
+      offset += send_counts[i];
+    }
+
+    order = malloc ((count + 1) * sizeof (*order));
+    send_buffer = malloc (count * record_size + 1);
+    assert (NULL != order && NULL != send_buffer);
+
+    for (size_t i = 0 ; i < count ; ++i) {
+      uint64_t hash;
+      int target;
+
+      memcpy (&hash, records + i * record_size, sizeof (hash));
+      target = hash / map->md_local_size;
+      order[send_displs[target]] = i;
+      memcpy (send_buffer + send_displs[target]++ * record_size, records + i * record_size, record_size);
+    }
+
+    /* exchange record counts then records */
+    mpirc = MPI_Alltoall (send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, context->c_node_leader_comm);
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+      break;
+    }
+
+    for (int i = 0, offset = 0 ; i < node_count ; ++i) {
+      send_displs[i] = offset;
+      offset += send_counts[i];
+      recv_displs[i] = recv_count;
+      recv_count += recv_counts[i];
+    }
+
+    /* switch to byte counts */
+    for (int i = 0 ; i < 4 * node_count ; ++i) {
+      send_counts[i] *= record_size;
+    }
+
+    recv_buffer = malloc (recv_count * record_size + 1);
+    slots = malloc ((recv_count + 1) * sizeof (*slots));
+    new_items = malloc ((recv_count + 1) * sizeof (*new_items));
+    assert (NULL != recv_buffer && NULL != slots && NULL != new_items);
+
+    mpirc = MPI_Alltoallv (send_buffer, send_counts, send_displs, MPI_BYTE, recv_buffer, recv_counts, recv_displs,
+                           MPI_BYTE, context->c_node_leader_comm);
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+      break;
+    }
+
+    /* insert the records this leader owns */
+    for (size_t i = 0 ; i < recv_count ; ++i) {
+      unsigned char *record = recv_buffer + i * record_size;
+      bool placed;
+      uint64_t hash;
+
+      memcpy (&hash, record, sizeof (hash));
+      slots[i] = hioi_dataset_map_insert_local (map, hash, record + sizeof (hash), compare_fn, &placed);
+      if (NULL == slots[i]) {
+        rc = HIO_ERR_OUT_OF_RESOURCE;
+        break;
+      }
+
+      if (placed) {
+        new_items[new_count++] = slots[i];
+      }
+    }
+
+    mpirc = MPI_Allreduce (MPI_IN_PLACE, &rc, 1, MPI_INT, MPI_MIN, context->c_node_leader_comm);
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+    }
+
+    if (HIO_SUCCESS != rc) {
+      break;
+    }
+
+    if (indices) {
+      /* assign element map indices. indices are dense over all leaders */
+      uint64_t local_count = new_count;
+
+      MPI_Exscan (&local_count, &new_offset, 1, MPI_UINT64_T, MPI_SUM, context->c_node_leader_comm);
+      MPI_Allreduce (&local_count, &new_total, 1, MPI_UINT64_T, MPI_SUM, context->c_node_leader_comm);
+      if (0 == leader_rank) {
+        /* the exscan result is undefined on the first leader */
+        new_offset = 0;
+      }
+
+      for (size_t i = 0 ; i < new_count ; ++i) {
+        ((hio_map_element_t *) new_items[i])->me_index = new_offset + i;
+      }
+
+      if (0 == leader_rank) {
+        /* one-sided inserts after the bulk build continue from here */
+        *((int64_t *) map->md_base) = (int64_t) new_total;
+      }
+    }
+
+    for (size_t i = 0 ; i < new_count ; ++i) {
+      new_items[i]->cksum = hioi_crc64 ((unsigned char *) (new_items[i] + 1), kv_size);
+    }
+
+    /* make local updates visible to one-sided operations */
+    MPI_Win_sync (map->md_win);
+
+    if (NULL == indices) {
+      break;
+    }
+
+    /* send the element map index of every record back to where it came from */
+    send_indices = malloc ((recv_count + count + 1) * sizeof (uint32_t));
+    assert (NULL != send_indices);
+
+    for (size_t i = 0 ; i < recv_count ; ++i) {
+      send_indices[i] = ((hio_map_element_t *) slots[i])->me_index;
+    }
+
+    for (int i = 0 ; i < node_count ; ++i) {
+      recv_counts[i] = recv_counts[i] / record_size * sizeof (uint32_t);
+      recv_displs[i] = recv_displs[i] / record_size * sizeof (uint32_t);
+      send_counts[i] = send_counts[i] / record_size * sizeof (uint32_t);
+      send_displs[i] = send_displs[i] / record_size * sizeof (uint32_t);
+    }
+
+    mpirc = MPI_Alltoallv (send_indices, recv_counts, recv_displs, MPI_BYTE, send_indices + recv_count,
+                           send_counts, send_displs, MPI_BYTE, context->c_node_leader_comm);
+    if (MPI_SUCCESS != mpirc) {
+      rc = hioi_err_mpi (mpirc);
+      break;
+    }
+
+    for (size_t i = 0 ; i < count ; ++i) {
+      indices[order[i]] = send_indices[recv_count + i];
+    }
+  } while (0);
+
+  free (send_indices);
+  free (new_items);
+  free (slots);
+  free (recv_buffer);
+  free (send_buffer);
+  free (order);
+  free (send_counts);
+
+  return rc;
+}
+
+static int hioi_dataset_map_bulk_elements (hio_dataset_t dataset) {
+  hio_dataset_map_data_t *map = &dataset->ds_map.map_elements;
+  size_t record_size = HIO_MAP_RECORD_SIZE(map), count = 0;
+  unsigned char *records;
+  hio_element_t element;
+  uint32_t *indices;
+  int rc;
+
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    ++count;
+  }
+
+  records = calloc (count + 1, record_size);
+  indices = calloc (count + 1, sizeof (*indices));
+  assert (NULL != records && NULL != indices);
+
+  count = 0;
+  hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+    unsigned char *record = records + count++ * record_size;
+    hio_map_element_t *item = (hio_map_element_t *) (record + sizeof (uint64_t));
+    uint64_t hash = hioi_map_home_bucket (map, hioi_hash_element (element->e_object.identifier));
+
+    memcpy (record, &hash, sizeof (hash));
+    strncpy (item->me_name, element->e_object.identifier, HIO_ELEMENT_NAME_MAX);
+  }
+
+  rc = hioi_dataset_map_bulk_insert (dataset, map, records, count, hioi_map_compare_string, indices);
+  if (HIO_SUCCESS == rc) {
+    count = 0;
+    hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+      element->e_index = indices[count++];
+    }
+  }
+
+  free (indices);
+  free (records);
+
+  return rc;
+}
+
 static int hioi_dataset_map_generate_element_map (hio_dataset_t dataset, uint64_t max_element_count) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
   hio_dataset_map_t *map = &dataset->ds_map;
@@ -427,11 +648,18 @@ static int hioi_dataset_map_generate_element_map (hio_dataset_t dataset, uint64_
   if (0 == context->c_shared_rank) {
     hio_element_t element;
 
-    hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
-      hioi_timed_call(rc = hioi_dataset_map_insert_element (element));
+    if (map->map_bulk_build) {
+      hioi_timed_call(rc = hioi_dataset_map_bulk_elements (dataset));
       if (HIO_SUCCESS != rc) {
         return rc;
       }
+    } else {
+      hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+        hioi_timed_call(rc = hioi_dataset_map_insert_element (element));
+        if (HIO_SUCCESS != rc) {
+          return rc;
+        }
+      }
     }
   }
 
@@ -440,86 +668,400 @@ static int hioi_dataset_map_generate_element_map (hio_dataset_t dataset, uint64_
   return HIO_SUCCESS;
 }
 
-/* insert a segment into the segment map */
-int hioi_dataset_map_insert_segment (hio_element_t element, hio_manifest_segment_t *segment) {
-  hio_context_t context = hioi_object_context (&element->e_object);
-  hio_dataset_t dataset = hioi_element_dataset (element);
-  hio_dataset_map_t *map = &dataset->ds_map;
+/* distributed segment index. segments are ordered by (element index, application offset)
+ * and range-partitioned across the node leaders with a parallel sample sort. each leader
+ * holds its range as a sorted array in an MPI window. the first key of every block of
+ * HIO_MAP_INDEX_BLOCK segments (a fence) is replicated on all ranks so any offset can be
+ * resolved with one remote get of a block and a local binary search. */
+
+/** number of segments covered by each fence */
+#define HIO_MAP_INDEX_BLOCK 64
+
+typedef struct hio_map_range_t {
+  /** element index */
+  uint32_t mr_index;
+  /** index of file holding the segment */
+  uint32_t mr_findex;
+  /** segment application offset */
+  uint64_t mr_aoff;
+  /** segment length */
+  uint64_t mr_size;
+  /** offset of segment within the file */
+  uint64_t mr_foff;
+} hio_map_range_t;
+
+struct hio_map_fence_t {
+  /** element index of the first segment in the block */
+  uint32_t mf_index;
+  /** node leader holding the block (index into the leader list) */
+  uint32_t mf_leader;
+  /** application offset of the first segment in the block */
+  uint64_t mf_aoff;
+  /** index of the first segment of the block in the leader's array */
+  uint64_t mf_offset;
+  /** number of segments in the block */
+  uint64_t mf_count;
+};
 
-  struct hio_map_segment_key_t key = {.ms_index = element->e_index,
-                                      .ms_aoff = segment->seg_offset,
-                                      .ms_size = segment->seg_length};
-  struct hio_map_segment_key_t bound_key = {.ms_aoff = segment->seg_offset + segment->seg_length - 1};
-  struct hio_map_segment_value_t value = {.ms_findex = segment->seg_file_index,
-                                          .ms_foff = segment->seg_foffset};
-  int rc;
+static int hioi_map_key_compare (uint32_t index_a, uint64_t aoff_a, uint32_t index_b, uint64_t aoff_b) {
+  if (index_a != index_b) {
+    return (index_a > index_b) ? 1 : -1;
+  }
 
-  for (int i = 0 ; i < hio_segment_hash_count ; ++i) {
-    /* make an entry for this segment at each relevant hash size */
-    if (segment->seg_length > (1ul << hio_segment_hashes[i].sh_bits) && i < (hio_segment_hash_count - 1)) {
-      continue;
-    }
+  if (aoff_a != aoff_b) {
+    return (aoff_a > aoff_b) ? 1 : -1;
+  }
 
-    rc = hioi_dataset_map_insert (&map->map_segments, context->c_node_leaders, &key, sizeof (key),
-                                  &value, NULL, hio_segment_hashes[i].sh_fn, hioi_map_compare_segment,
-                                  hioi_prepare_segment);
-    if (HIO_SUCCESS != rc) {
-      return rc;
+  return 0;
+}
+
+static int hioi_map_range_compare (const void *a, const void *b) {
+  const hio_map_range_t *range_a = (const hio_map_range_t *) a;
+  const hio_map_range_t *range_b = (const hio_map_range_t *) b;
+
+  return hioi_map_key_compare (range_a->mr_index, range_a->mr_aoff, range_b->mr_index, range_b->mr_aoff);
+}
+
+/* find the last range in a sorted array with a key less than or equal to the given key */
+static ssize_t hioi_map_range_floor (const hio_map_range_t *ranges, size_t count, uint32_t index, uint64_t aoff) {
+  ssize_t low = 0, high = (ssize_t) count - 1, found = -1;
+
+  while (low <= high) {
+    ssize_t mid = (low + high) / 2;
+
+    if (hioi_map_key_compare (ranges[mid].mr_index, ranges[mid].mr_aoff, index, aoff) <= 0) {
+      found = mid;
+      low = mid + 1;
+    } else {
+      high = mid - 1;
     }
+  }
+
+  return found;
+}
+
+static int hioi_dataset_map_index_sort (hio_dataset_t dataset, hio_map_range_t **ranges_inout, size_t *count_inout) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  int node_count = context->c_node_count, sample_count, total_samples = 0, rc;
+  hio_map_range_t *ranges = *ranges_inout, *samples, *all_samples, *sorted;
+  int *counts, *displs, *recv_counts, *recv_displs;
+  size_t count = *count_inout, sorted_count = 0, start = 0;
+
+  counts = calloc (4 * node_count, sizeof (int));
+  assert (NULL != counts);
+  displs = counts + node_count;
+  recv_counts = displs + node_count;
+  recv_displs = recv_counts + node_count;
+
+  qsort (ranges, count, sizeof (ranges[0]), hioi_map_range_compare);
+
+  /* pick regularly spaced samples from the local sorted data */
+  sample_count = (count < (size_t) node_count) ? (int) count : node_count;
+  samples = malloc ((sample_count + 1) * sizeof (*samples));
+  assert (NULL != samples);
+
+  for (int i = 0 ; i < sample_count ; ++i) {
+    samples[i] = ranges[(size_t) i * count / sample_count];
+  }
 
-    if (hio_segment_hashes[i].sh_fn (&key) != hio_segment_hashes[i].sh_fn (&bound_key)) {
-      /* crosses a hash block boundary */
-      uint64_t next_block = (bound_key.ms_aoff + 1) & ~((1ul << hio_segment_hashes[i].sh_bits) - 1);
-      uint64_t block_offset = next_block - segment->seg_offset;
+  sample_count *= sizeof (samples[0]);
+  rc = MPI_Allgather (&sample_count, 1, MPI_INT, recv_counts, 1, MPI_INT, context->c_node_leader_comm);
+  if (MPI_SUCCESS != rc) {
+    free (samples);
+    free (counts);
+    return hioi_err_mpi (rc);
+  }
 
-      key.ms_aoff = next_block;
-      key.ms_size -= block_offset;
-      value.ms_foff += block_offset;
+  for (int i = 0 ; i < node_count ; ++i) {
+    recv_displs[i] = total_samples;
+    total_samples += recv_counts[i];
+  }
 
-      rc = hioi_dataset_map_insert (&map->map_segments, context->c_node_leaders, &key, sizeof (key),
-                                        &value, NULL, hio_segment_hashes[i].sh_fn, hioi_map_compare_segment,
-                                        hioi_prepare_segment);
+  all_samples = malloc (total_samples + 1);
+  assert (NULL != all_samples);
+
+  rc = MPI_Allgatherv (samples, sample_count, MPI_BYTE, all_samples, recv_counts, recv_displs, MPI_BYTE,
+                       context->c_node_leader_comm);
+  free (samples);
+  if (MPI_SUCCESS != rc) {
+    free (all_samples);
+    free (counts);
+    return hioi_err_mpi (rc);
+  }
+
+  total_samples /= sizeof (all_samples[0]);
+  qsort (all_samples, total_samples, sizeof (all_samples[0]), hioi_map_range_compare);
+
+  /* partition the local data using node_count - 1 splitters. leader i receives keys
+   * in [splitter i - 1, splitter i) */
+  for (int i = 0 ; i < node_count ; ++i) {
+    size_t end = count;
+
+    if (i < node_count - 1 && total_samples) {
+      hio_map_range_t *splitter = all_samples + (size_t) (i + 1) * total_samples / node_count;
+      ssize_t floor = hioi_map_range_floor (ranges, count, splitter->mr_index, splitter->mr_aoff);
+
+      /* the floor may equal the splitter. equal keys belong to the next partition */
+      while (floor >= (ssize_t) start && 0 == hioi_map_range_compare (ranges + floor, splitter)) {
+        --floor;
+      }
+
+      end = (floor < (ssize_t) start) ? start : (size_t) floor + 1;
     }
 
-    return rc;
+    displs[i] = start * sizeof (ranges[0]);
+    counts[i] = (end - start) * sizeof (ranges[0]);
+    start = end;
+  }
+
+  free (all_samples);
+
+  rc = MPI_Alltoall (counts, 1, MPI_INT, recv_counts, 1, MPI_INT, context->c_node_leader_comm);
+  if (MPI_SUCCESS != rc) {
+    free (counts);
+    return hioi_err_mpi (rc);
+  }
+
+  for (int i = 0 ; i < node_count ; ++i) {
+    recv_displs[i] = sorted_count;
+    sorted_count += recv_counts[i];
   }
 
+  sorted = malloc (sorted_count + 1);
+  assert (NULL != sorted);
+
+  rc = MPI_Alltoallv (ranges, counts, displs, MPI_BYTE, sorted, recv_counts, recv_displs, MPI_BYTE,
+                      context->c_node_leader_comm);
+  free (counts);
+  if (MPI_SUCCESS != rc) {
+    free (sorted);
+    return hioi_err_mpi (rc);
+  }
+
+  sorted_count /= sizeof (sorted[0]);
+  qsort (sorted, sorted_count, sizeof (sorted[0]), hioi_map_range_compare);
+
+  free (ranges);
+  *ranges_inout = sorted;
+  *count_inout = sorted_count;
+
   return HIO_SUCCESS;
 }
 
-static int hioi_dataset_map_generate_segment_map (hio_dataset_t dataset, uint64_t max_segment_count) {
+static int hioi_dataset_map_index_fences (hio_dataset_t dataset, size_t count) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
   hio_dataset_map_t *map = &dataset->ds_map;
+  struct hio_map_fence_t *fences = NULL;
+  long fence_count = 0;
   int rc;
 
-  /* each segment may be in the worst case hashed at every size times to speed lookups */
-  rc = hioi_dataset_map_data_initialize (dataset, &map->map_segments, 4 * max_segment_count,
-                                         sizeof (hio_map_segment_t));
-  if (HIO_SUCCESS != rc) {
-    return rc;
+  if (0 == context->c_shared_rank) {
+    const hio_map_range_t *ranges = (const hio_map_range_t *) map->map_index_base;
+    int node_count = context->c_node_count, leader_rank, local_fences;
+    int *recv_counts, *recv_displs, total = 0;
+    struct hio_map_fence_t *local;
+
+    MPI_Comm_rank (context->c_node_leader_comm, &leader_rank);
+
+    local_fences = (count + HIO_MAP_INDEX_BLOCK - 1) / HIO_MAP_INDEX_BLOCK;
+    local = calloc (local_fences + 1, sizeof (*local));
+    recv_counts = calloc (2 * node_count, sizeof (int));
+    assert (NULL != local && NULL != recv_counts);
+    recv_displs = recv_counts + node_count;
+
+    for (int i = 0 ; i < local_fences ; ++i) {
+      size_t offset = (size_t) i * HIO_MAP_INDEX_BLOCK;
+
+      local[i].mf_index = ranges[offset].mr_index;
+      local[i].mf_aoff = ranges[offset].mr_aoff;
+      local[i].mf_leader = leader_rank;
+      local[i].mf_offset = offset;
+      local[i].mf_count = (count - offset < HIO_MAP_INDEX_BLOCK) ? count - offset : HIO_MAP_INDEX_BLOCK;
+    }
+
+    local_fences *= sizeof (local[0]);
+    rc = MPI_Allgather (&local_fences, 1, MPI_INT, recv_counts, 1, MPI_INT, context->c_node_leader_comm);
+    if (MPI_SUCCESS == rc) {
+      for (int i = 0 ; i < node_count ; ++i) {
+        recv_displs[i] = total;
+        total += recv_counts[i];
+      }
+
+      fences = malloc (total + 1);
+      assert (NULL != fences);
+
+      /* leaders hold consecutive key ranges so the gathered fences are sorted */
+      rc = MPI_Allgatherv (local, local_fences, MPI_BYTE, fences, recv_counts, recv_displs, MPI_BYTE,
+                           context->c_node_leader_comm);
+      fence_count = total / sizeof (fences[0]);
+    }
+
+    free (recv_counts);
+    free (local);
+
+    if (MPI_SUCCESS != rc) {
+      fence_count = -1;
+    }
+  }
+
+  rc = MPI_Bcast (&fence_count, 1, MPI_LONG, 0, context->c_shared_comm);
+  if (MPI_SUCCESS != rc || 0 > fence_count) {
+    free (fences);
+    return (MPI_SUCCESS != rc) ? hioi_err_mpi (rc) : HIO_ERROR;
   }
 
+  if (0 != context->c_shared_rank) {
+    fences = malloc ((fence_count + 1) * sizeof (*fences));
+    assert (NULL != fences);
+  }
+
+  rc = MPI_Bcast (fences, fence_count * sizeof (*fences), MPI_BYTE, 0, context->c_shared_comm);
+  if (MPI_SUCCESS != rc) {
+    free (fences);
+    return hioi_err_mpi (rc);
+  }
+
+  map->map_fences = fences;
+  map->map_fence_count = fence_count;
+
+  return HIO_SUCCESS;
+}
+
+static int hioi_dataset_map_generate_segment_index (hio_dataset_t dataset) {
+  hio_context_t context = hioi_object_context (&dataset->ds_object);
+  hio_dataset_map_t *map = &dataset->ds_map;
+  hio_map_range_t *ranges = NULL;
+  size_t count = 0;
+  MPI_Aint alloc_size = 0;
+  hio_element_t element;
+  void *base;
+  int rc = HIO_SUCCESS;
+
   if (0 == context->c_shared_rank) {
-    hio_element_t element;
+    hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
+      count += element->e_scount;
+    }
 
+    ranges = malloc ((count + 1) * sizeof (*ranges));
+    assert (NULL != ranges);
+
+    count = 0;
     hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
-      for (int i = 0 ; i < element->e_scount ; ++i) {
-        rc = hioi_dataset_map_insert_segment (element, element->e_sarray + i);
-        if (HIO_SUCCESS != rc) {
-          return rc;
-        }
+      for (size_t i = 0 ; i < element->e_scount ; ++i, ++count) {
+        hio_manifest_segment_t *segment = element->e_sarray + i;
+
+        ranges[count].mr_index = element->e_index;
+        ranges[count].mr_findex = segment->seg_file_index;
+        ranges[count].mr_aoff = segment->seg_offset;
+        ranges[count].mr_size = segment->seg_length;
+        ranges[count].mr_foff = segment->seg_foffset;
       }
     }
+
+    hioi_timed_call(rc = hioi_dataset_map_index_sort (dataset, &ranges, &count));
+    if (HIO_SUCCESS != rc) {
+      /* still participate in the collectives below */
+      count = 0;
+    }
+
+    alloc_size = count * sizeof (*ranges);
+  }
+
+  hioi_timed_call(rc = MPI_Win_allocate (alloc_size, 1, MPI_INFO_NULL, context->c_comm, (void *) &base,
+                                         &map->map_index_win));
+  if (MPI_SUCCESS != rc) {
+    map->map_index_win = MPI_WIN_NULL;
+    free (ranges);
+    return hioi_err_mpi (rc);
   }
 
+  if (alloc_size) {
+    memcpy (base, ranges, alloc_size);
+  }
+  free (ranges);
+
+  map->map_index_base = alloc_size ? base : NULL;
+
+  MPI_Win_lock_all (0, map->map_index_win);
+
+  hioi_timed_call(rc = hioi_dataset_map_index_fences (dataset, count));
+
   MPI_Barrier (context->c_comm);
 
+  return rc;
+}
+
+static void hioi_dataset_map_index_release (hio_dataset_map_t *map) {
+  if (MPI_WIN_NULL != map->map_index_win) {
+    MPI_Win_unlock_all (map->map_index_win);
+    (void) MPI_Win_free (&map->map_index_win);
+  }
+
+  free (map->map_fences);
+  map->map_fences = NULL;
+  map->map_fence_count = 0;
+  map->map_index_base = NULL;
+}
+
+static int hioi_dataset_map_lookup_segment (hio_element_t element, uint64_t app_offset, hio_map_range_t *segment) {
+  hio_context_t context = hioi_object_context (&element->e_object);
+  hio_dataset_t dataset = hioi_element_dataset (element);
+  hio_dataset_map_t *map = &dataset->ds_map;
+  hio_map_range_t block[HIO_MAP_INDEX_BLOCK];
+  struct hio_map_fence_t *fence;
+  ssize_t low = 0, high, found = -1;
+  int target, rc;
+
+  if (MPI_WIN_NULL == map->map_index_win || 0 == map->map_fence_count) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  /* find the block that may contain the offset */
+  high = (ssize_t) map->map_fence_count - 1;
+  while (low <= high) {
+    ssize_t mid = (low + high) / 2;
+
+    if (hioi_map_key_compare (map->map_fences[mid].mf_index, map->map_fences[mid].mf_aoff, element->e_index,
+                              app_offset) <= 0) {
+      found = mid;
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  if (0 > found) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  fence = map->map_fences + found;
+  target = context->c_node_leaders[fence->mf_leader];
+
+  rc = MPI_Get (block, fence->mf_count * sizeof (block[0]), MPI_BYTE, target, fence->mf_offset * sizeof (block[0]),
+                fence->mf_count * sizeof (block[0]), MPI_BYTE, map->map_index_win);
+  if (MPI_SUCCESS != rc) {
+    return hioi_err_mpi (rc);
+  }
+
+  rc = MPI_Win_flush (target, map->map_index_win);
+  if (MPI_SUCCESS != rc) {
+    return hioi_err_mpi (rc);
+  }
+
+  found = hioi_map_range_floor (block, fence->mf_count, element->e_index, app_offset);
+  if (0 > found || block[found].mr_index != element->e_index ||
+      app_offset >= block[found].mr_aoff + block[found].mr_size) {
+    return HIO_ERR_NOT_FOUND;
+  }
+
+  *segment = block[found];
+
   return HIO_SUCCESS;
 }
 
 int hioi_dataset_generate_map (hio_dataset_t dataset) {
   hio_context_t context = hioi_object_context (&dataset->ds_object);
-  uint64_t counts[2] = {0, 0};
+  uint64_t element_count = 0;
   hio_element_t element;
   int rc;
 
@@ -540,13 +1082,12 @@ int hioi_dataset_generate_map (hio_dataset_t dataset) {
 
   do {
     if (0 == context->c_shared_rank) {
-      /* determine the number of elements and segments in the dataset */
+      /* determine the number of elements in the dataset */
       hioi_list_foreach (element, dataset->ds_elist, struct hio_element, e_list) {
-        ++counts[0];
-        counts[1] += element->e_scount;
+        ++element_count;
       }
 
-      rc = MPI_Allreduce (MPI_IN_PLACE, counts, 2, MPI_INT64_T, MPI_SUM,
+      rc = MPI_Allreduce (MPI_IN_PLACE, &element_count, 1, MPI_INT64_T, MPI_SUM,
                           context->c_node_leader_comm);
       if (MPI_SUCCESS != rc) {
         rc = hioi_err_mpi (rc);
@@ -554,18 +1095,18 @@ int hioi_dataset_generate_map (hio_dataset_t dataset) {
       }
     }
 
-    rc = MPI_Bcast (counts, 2, MPI_INT64_T, 0, context->c_shared_comm);
+    rc = MPI_Bcast (&element_count, 1, MPI_INT64_T, 0, context->c_shared_comm);
     if (MPI_SUCCESS != rc) {
       rc = hioi_err_mpi (rc);
       break;
     }
 
-    hioi_timed_call(rc = hioi_dataset_map_generate_element_map (dataset, counts[0]));
+    hioi_timed_call(rc = hioi_dataset_map_generate_element_map (dataset, element_count));
     if (HIO_SUCCESS != rc) {
       break;
     }
 
-    hioi_timed_call(rc = hioi_dataset_map_generate_segment_map (dataset, counts[1]));
+    hioi_timed_call(rc = hioi_dataset_map_generate_segment_index (dataset));
   } while (0);
 
   hioi_object_unlock (&context->c_object);
@@ -574,7 +1115,7 @@ int hioi_dataset_generate_map (hio_dataset_t dataset) {
 }
 
 int hioi_dataset_map_release (hio_dataset_t dataset) {
-  hioi_dataset_map_data_finalize (&dataset->ds_map.map_segments);
+  hioi_dataset_map_index_release (&dataset->ds_map);
   hioi_dataset_map_data_finalize (&dataset->ds_map.map_elements);
 
   return HIO_SUCCESS;
@@ -604,46 +1145,96 @@ static int hioi_dataset_map_lookup_element (hio_element_t element) {
 }
 
 
-static bool hioi_map_contains_segment (const void *a, const void *b) {
-  struct hio_map_segment_key_t *sega = (struct hio_map_segment_key_t *) a;
-  struct hio_map_segment_key_t *segb = (struct hio_map_segment_key_t *) b;
+/* element map cache. recently fetched segments are kept in a small per-element array
+ * searched by interval. the array is bounded by the map_cache_size dataset variable and
+ * the least recently used entry is replaced once it is full. */
+
+int hioi_dataset_map_cache_lookup (hio_element_t element, uint64_t app_offset, int *file_index,
+                                   uint64_t *offset, size_t *length) {
+  hio_dataset_t dataset = hioi_element_dataset (element);
+  int rc = HIO_ERR_NOT_FOUND;
+
+  hioi_object_lock (&element->e_object);
+
+  for (size_t i = 0 ; i < element->e_mcount ; ++i) {
+    hio_map_cache_entry_t *entry = element->e_mcache + i;
+    uint64_t base = entry->mc_segment.seg_offset;
+    uint64_t bound = base + entry->mc_segment.seg_length;
+
+    if (app_offset < base || app_offset >= bound) {
+      continue;
+    }
+
+    *file_index = entry->mc_segment.seg_file_index;
+    *offset = entry->mc_segment.seg_foffset + app_offset - base;
+    if (app_offset + *length > bound) {
+      *length = bound - app_offset;
+    }
 
-  if (sega->ms_index != segb->ms_index) {
-    return false;
+    entry->mc_stamp = ++element->e_mclock;
+    ++dataset->ds_stat.s_mcache_hits;
+    rc = HIO_SUCCESS;
+    break;
   }
 
-  return (sega->ms_aoff >= segb->ms_aoff && sega->ms_aoff < (segb->ms_aoff + segb->ms_size));
+  hioi_object_unlock (&element->e_object);
+
+  return rc;
 }
 
-static int hioi_dataset_map_lookup_segment (hio_element_t element, int64_t app_offset,
-                                            hio_map_segment_t *segment) {
-  hio_context_t context = hioi_object_context (&element->e_object);
+static void hioi_dataset_map_cache_insert (hio_element_t element, const hio_map_range_t *segment) {
   hio_dataset_t dataset = hioi_element_dataset (element);
-  struct hio_map_segment_key_t key = {.ms_resv0 = 0, .ms_index = element->e_index,
-                                      .ms_aoff = app_offset, .ms_size = 0};
-  int rc;
+  size_t cache_size = dataset->ds_map.map_cache_size;
+  hio_map_cache_entry_t *entry;
 
-  if (MPI_WIN_NULL == dataset->ds_map.map_segments.md_win) {
-    return HIO_ERR_NOT_FOUND;
+  if (0 == cache_size) {
+    return;
+  }
+
+  hioi_object_lock (&element->e_object);
+
+  if (NULL == element->e_mcache) {
+    element->e_mcache = calloc (cache_size, sizeof (element->e_mcache[0]));
+    if (NULL == element->e_mcache) {
+      /* the cache is an optimization. carry on without it */
+      hioi_object_unlock (&element->e_object);
+      return;
+    }
   }
 
-  for (int i = 0 ; i < hio_segment_hash_count ; ++i) {
-    rc = hioi_dataset_map_search (&dataset->ds_map.map_segments, context->c_node_leaders,
-                                  &key, segment, hio_segment_hashes[i].sh_fn, hioi_map_contains_segment);
-    if (HIO_SUCCESS == rc) {
-      return HIO_SUCCESS;
+  if (element->e_mcount < cache_size) {
+    entry = element->e_mcache + element->e_mcount++;
+  } else {
+    /* replace the least recently used entry */
+    entry = element->e_mcache;
+    for (size_t i = 1 ; i < element->e_mcount ; ++i) {
+      if (element->e_mcache[i].mc_stamp < entry->mc_stamp) {
+        entry = element->e_mcache + i;
+      }
     }
   }
 
-  return HIO_ERR_NOT_FOUND;
+  entry->mc_segment.seg_offset = segment->mr_aoff;
+  entry->mc_segment.seg_length = segment->mr_size;
+  entry->mc_segment.seg_foffset = segment->mr_foff;
+  entry->mc_segment.seg_file_index = segment->mr_findex;
+  entry->mc_stamp = ++element->e_mclock;
+
+  hioi_object_unlock (&element->e_object);
 }
 
 int hioi_dataset_map_translate_offset (hio_element_t element, uint64_t app_offset,
                                        int *file_index, uint64_t *offset, size_t *length) {
-  hio_map_segment_t segment = {.key = {.ms_aoff = 0, .ms_size = 0}, .value = {.ms_findex = -1, .ms_foff = -1}};
+  hio_dataset_t dataset = hioi_element_dataset (element);
+  hio_map_range_t segment;
   uint64_t base, bound;
   int rc;
 
+  if (MPI_WIN_NULL == dataset->ds_map.map_elements.md_win) {
+    /* no distributed map. all segments are local */
+    return HIO_ERR_NOT_FOUND;
+  }
+
   if (-1 == element->e_index) {
     rc = hioi_dataset_map_lookup_element (element);
     if (HIO_SUCCESS != rc) {
@@ -651,16 +1242,20 @@ int hioi_dataset_map_translate_offset (hio_element_t element, uint64_t app_offse
     }
   }
 
+  ++dataset->ds_stat.s_map_lookups;
+
   rc = hioi_dataset_map_lookup_segment (element, app_offset, &segment);
   if (HIO_SUCCESS != rc) {
     return rc;
   }
 
-  base = segment.key.ms_aoff;
-  bound = base + segment.key.ms_size;
+  hioi_dataset_map_cache_insert (element, &segment);
+
+  base = segment.mr_aoff;
+  bound = base + segment.mr_size;
 
-  *file_index = segment.value.ms_findex;
-  *offset = segment.value.ms_foff + app_offset - base;
+  *file_index = segment.mr_findex;
+  *offset = segment.mr_foff + app_offset - base;
   if (app_offset + *length > bound) {
     *length = bound - app_offset;
   }
@@ -12,9 +12,16 @@
 #include "hio_internal.h"
 
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <sys/time.h>
 
+#if defined(HAVE_SYS_EVENTFD_H)
+#include <sys/eventfd.h>
+#endif
+
 hio_request_t hioi_request_alloc (hio_context_t context) {
   hio_request_t request;
 
@@ -24,6 +31,8 @@ hio_request_t hioi_request_alloc (hio_context_t context) {
   }
 
   request->req_object.type = HIO_OBJECT_TYPE_REQUEST;
+  request->req_context = context;
+  atomic_init (&request->req_complete, false);
 
   return request;
 }
@@ -34,6 +43,76 @@ void hioi_request_release (hio_request_t request) {
   }
 }
 
+void hioi_request_complete (hio_request_t request, size_t transferred, int status) {
+  hio_context_t context = request->req_context;
+
+  request->req_transferred = transferred;
+  request->req_status = status;
+
+  pthread_mutex_lock (&context->c_req_lock);
+  atomic_store (&request->req_complete, true);
+  ++context->c_req_completions;
+
+  if (-1 != context->c_req_fd[1]) {
+#if defined(HAVE_SYS_EVENTFD_H)
+    uint64_t one = 1;
+#else
+    char one = 1;
+#endif
+    /* the descriptor is non-blocking. a full pipe already signals completion */
+    (void) write (context->c_req_fd[1], &one, sizeof (one));
+  }
+
+  pthread_cond_broadcast (&context->c_req_cond);
+  pthread_mutex_unlock (&context->c_req_lock);
+}
+
+/**
+ * Find the context of the first active request in an array
+ */
+static hio_context_t hioi_request_context (hio_request_t *requests, int nrequests) {
+  for (int i = 0 ; i < nrequests ; ++i) {
+    if (HIO_OBJECT_NULL != requests[i]) {
+      return requests[i]->req_context;
+    }
+  }
+
+  return NULL;
+}
+
+static uint64_t hioi_request_completions (hio_context_t context) {
+  uint64_t completions;
+
+  pthread_mutex_lock (&context->c_req_lock);
+  completions = context->c_req_completions;
+  pthread_mutex_unlock (&context->c_req_lock);
+
+  return completions;
+}
+
+/**
+ * Block until a request on the context completes after completions were counted
+ */
+static void hioi_request_block (hio_context_t context, uint64_t completions) {
+  pthread_mutex_lock (&context->c_req_lock);
+  while (completions == context->c_req_completions) {
+    pthread_cond_wait (&context->c_req_cond, &context->c_req_lock);
+  }
+  pthread_mutex_unlock (&context->c_req_lock);
+}
+
+/**
+ * Release a complete request and return the number of bytes transferred or the error
+ */
+static ssize_t hioi_request_finish (hio_request_t *request) {
+  ssize_t result = (*request)->req_status < 0 ? (*request)->req_status : (ssize_t) (*request)->req_transferred;
+
+  hioi_request_release (*request);
+  *request = HIO_OBJECT_NULL;
+
+  return result;
+}
+
 int hio_request_test_internal (hio_request_t *requests, int nrequests, ssize_t *bytes_transferred, bool *complete,
                                bool noset_null) {
   int ncomplete = 0;
@@ -51,17 +130,17 @@ int hio_request_test_internal (hio_request_t *requests, int nrequests, ssize_t *
       }
 
       ++ncomplete;
-    } else if (requests[i]->req_complete) {
+    } else if (atomic_load (&requests[i]->req_complete)) {
+      ssize_t result = hioi_request_finish (requests + i);
+
       if (complete) {
         complete[i] = true;
       }
 
       if (bytes_transferred) {
-        bytes_transferred[i] = requests[i]->req_transferred;
+        bytes_transferred[i] = result;
       }
 
-      hioi_request_release (requests[i]);
-      requests[i] = HIO_OBJECT_NULL;
       ++ncomplete;
     }
   }
@@ -78,10 +157,20 @@ int hio_request_test (hio_request_t *requests, int nrequests, ssize_t *bytes_tra
 }
 
 int hio_request_wait (hio_request_t *requests, int nrequests, ssize_t *bytes_transferred) {
+  hio_context_t context;
+  uint64_t completions;
   bool first = true;
   int rc;
 
+  if (NULL == requests) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
   do {
+    context = hioi_request_context (requests, nrequests);
+    /* count before testing so a completion between the test and the wait is not missed */
+    completions = context ? hioi_request_completions (context) : 0;
+
     rc = hio_request_test_internal (requests, nrequests, bytes_transferred, NULL, !first);
     if (nrequests == rc) {
       return HIO_SUCCESS;
@@ -93,9 +182,127 @@ int hio_request_wait (hio_request_t *requests, int nrequests, ssize_t *bytes_tra
 
     first = false;
 
-    struct timespec interval = {.tv_sec = 0, .tv_nsec = 1000};
-    nanosleep (&interval, NULL);
+    hioi_request_block (context, completions);
   } while (1);
 
   return HIO_SUCCESS;
 }
+
+int hio_request_waitany (hio_request_t *requests, int nrequests, int *index, ssize_t *bytes_transferred) {
+  hio_context_t context;
+  uint64_t completions;
+
+  if (NULL == requests || NULL == index) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  *index = -1;
+
+  context = hioi_request_context (requests, nrequests);
+  if (NULL == context) {
+    /* no active requests */
+    return HIO_SUCCESS;
+  }
+
+  do {
+    completions = hioi_request_completions (context);
+
+    for (int i = 0 ; i < nrequests ; ++i) {
+      if (HIO_OBJECT_NULL != requests[i] && atomic_load (&requests[i]->req_complete)) {
+        ssize_t result = hioi_request_finish (requests + i);
+
+        if (bytes_transferred) {
+          *bytes_transferred = result;
+        }
+
+        *index = i;
+        return HIO_SUCCESS;
+      }
+    }
+
+    hioi_request_block (context, completions);
+  } while (1);
+
+  return HIO_SUCCESS;
+}
+
+int hio_request_waitsome (hio_request_t *requests, int nrequests, int *ncompleted, int *indices,
+                          ssize_t *bytes_transferred) {
+  hio_context_t context;
+  uint64_t completions;
+
+  if (NULL == requests || NULL == ncompleted || NULL == indices) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  *ncompleted = 0;
+
+  context = hioi_request_context (requests, nrequests);
+  if (NULL == context) {
+    /* no active requests */
+    return HIO_SUCCESS;
+  }
+
+  do {
+    completions = hioi_request_completions (context);
+
+    for (int i = 0 ; i < nrequests ; ++i) {
+      if (HIO_OBJECT_NULL != requests[i] && atomic_load (&requests[i]->req_complete)) {
+        ssize_t result = hioi_request_finish (requests + i);
+
+        if (bytes_transferred) {
+          bytes_transferred[*ncompleted] = result;
+        }
+
+        indices[(*ncompleted)++] = i;
+      }
+    }
+
+    if (*ncompleted) {
+      return HIO_SUCCESS;
+    }
+
+    hioi_request_block (context, completions);
+  } while (1);
+
+  return HIO_SUCCESS;
+}
+
+int hio_request_get_fd (hio_context_t context, int *fd) {
+  int rc = HIO_SUCCESS;
+
+  if (HIO_OBJECT_NULL == context || NULL == fd) {
+    return HIO_ERR_BAD_PARAM;
+  }
+
+  pthread_mutex_lock (&context->c_req_lock);
+  if (-1 == context->c_req_fd[0]) {
+#if defined(HAVE_SYS_EVENTFD_H)
+    int efd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (0 > efd) {
+      rc = hioi_err_errno (errno);
+    } else {
+      context->c_req_fd[0] = context->c_req_fd[1] = efd;
+    }
+#else
+    int fds[2];
+
+    if (pipe (fds)) {
+      rc = hioi_err_errno (errno);
+    } else {
+      for (int i = 0 ; i < 2 ; ++i) {
+        (void) fcntl (fds[i], F_SETFL, fcntl (fds[i], F_GETFL) | O_NONBLOCK);
+        (void) fcntl (fds[i], F_SETFD, FD_CLOEXEC);
+      }
+
+      context->c_req_fd[0] = fds[0];
+      context->c_req_fd[1] = fds[1];
+    }
+#endif
+  }
+
+  *fd = context->c_req_fd[0];
+  pthread_mutex_unlock (&context->c_req_lock);
+
+  return rc;
+}
@@ -202,6 +202,8 @@ static int hioi_config_set_value_internal (hio_context_t context, hio_var_t *var
     break;
   }
 
+  var->var_set = true;
+
   return HIO_SUCCESS;
 }
 
@@ -324,6 +326,7 @@ int hioi_config_add (hio_context_t context, hio_object_t object, void *addr, con
   new_var->var_flags       = flags;
   new_var->var_storage     = (hio_var_value_t *) addr;
   new_var->var_enum        = var_enum;
+  new_var->var_set         = false;
 
   hioi_config_set_from_kv_list (&context->c_fconfig, object, new_var);
   hioi_config_set_from_env (context, object, new_var);
@@ -333,6 +336,12 @@ int hioi_config_add (hio_context_t context, hio_object_t object, void *addr, con
   return HIO_SUCCESS;
 }
 
+bool hioi_config_is_set (hio_object_t object, const char *name) {
+  int config_index = hioi_var_lookup (&object->configuration, name);
+
+  return config_index >= 0 && object->configuration.vars[config_index].var_set;
+}
+
 void hioi_config_list_init (hio_config_kv_list_t *list) {
   list->kv_list = NULL;
   list->kv_list_count = list->kv_list_size = 0;
@@ -162,6 +162,17 @@
  * data_roots=datawarp,/lscratch2/\<moniker\>/data will stage complete datasets to the
  * /lscratch2/\<moniker\>/data directory.
  *
+ * @subsection stage Stage
+ *
+ * The stage module provides the same tiering on any pair of posix file systems. Datasets
+ * are written to the fast data root (node-local flash, tmpfs, etc) and, once closed, are
+ * copied to the next data root by background threads. A dataset becomes visible on the
+ * persistent data root only after all processes have copied their files and its top-level
+ * manifest has been written. Older copies are then removed from the fast data root keeping
+ * only the newest stage_keep_count instances. Ex. data_roots=stage:/tmp/ckpt,/lscratch2/data
+ * will write datasets to /tmp/ckpt and stage them to /lscratch2/data. Staging finishes
+ * no later than hio_fini().
+ *
  * @section sec_configuration Configuration Interface
  *
  * libhio provides a flexible configuration interface. The basic units
@@ -264,6 +275,20 @@
  * - @b print_statistics - Print IO statistics when hio_dataset_free() is called. This value is only meaningful
  *   on the first IO rank.
  *
+ * - @b checkpoint_mtbf - Mean time between failures of the job in seconds. Used by
+ *   hio_dataset_should_checkpoint() to compute the optimal checkpoint interval. The default is 0 which
+ *   estimates the mean time between failures from @b node_mtbf and the number of nodes in the job.
+ *
+ * - @b node_mtbf - Mean time between failures of a single node in seconds. The default is 157680000 (five
+ *   years).
+ *
+ * - @b unlink_threads - Number of threads used to remove the files of a dataset on unlink or truncate.
+ *   The default is 4.
+ *
+ * - @b unlink_background - Rename unlinked or truncated datasets out of the way and remove their files in
+ *   a background thread. hio_dataset_unlink() and hio_dataset_open() with @ref HIO_FLAG_TRUNC return as soon
+ *   as the dataset has been renamed. Any remaining removal is finished by hio_fini().
+ *
  * - @b verbose - Verbosity level of libhio (0-100). The default is a verbosity level of 0
  *   which outputs hio errors. Higher levels will output warnings and more detailed debugging information.
  *   The maximum verbosity is 100. The context verbosity can be set independently on any rank(s).
@@ -281,7 +306,11 @@
  *   structure. This mode is currently only supported when using an MPI-3 compliant MPI implementation. When
  *   set to stided hio will stride element blocks across multiple files. The number of files and block size
  *   used in this mode are set using the dataset_block_size and dataset_file_count variables. Strided mode is
- *   only supported with @ref HIO_SET_ELEMENT_SHARED.
+ *   only supported with @ref HIO_SET_ELEMENT_SHARED. When set to packed each rank appends the data of all its
+ *   elements to a single container file and records the layout in a per-rank manifest. This reduces the
+ *   number of files created when each rank writes many small elements. Packed mode is only supported with
+ *   @ref HIO_SET_ELEMENT_UNIQUE. Readers do not need to set this variable as the file mode
+ *   is read from the dataset manifest.
  *
  * - @b dataset_block_size - Relevant only when the dataset_file_mode is either file_per_node or strided. This
  *   variable sets the internal block size and the filesystem stipe size (when supported).
@@ -293,6 +322,32 @@
  *   values are "default" (posix-like), "lustre", and "gpfs". Additional types will be added in the
  *   future.
  *
+ * - @b dataset_create_concurrency - Maximum number of ranks on a node that create element files at the same
+ *   time when writing a dataset in basic file mode with @ref HIO_SET_ELEMENT_UNIQUE. Limiting file creation
+ *   reduces the load on the filesystem metadata server at scale. The default is 0 (no limit).
+ *
+ * - @b dataset_keep_last - Number of instances of a dataset to keep. When non-zero the instances with
+ *   the lowest identifiers are unlinked after an instance opened for writing is successfully closed.
+ *
+ * - @b dataset_flush_threads - Number of threads used to sync the data files of a dataset during a complete
+ *   flush. Only files written since they were last synced are synced. The default is 4.
+ *
+ * - @b dataset_syncfs_threshold - When at least this many data files need to be synced during a complete
+ *   flush on a posix-like file system the data roots are synced with a single syncfs per node instead of
+ *   syncing each file. This includes element files that were closed since the last flush. Set to 0 to
+ *   always sync individual files. The default is 16.
+ *
+ * - @b dataset_write_behind_size - Start writing back the data of a file once this many bytes have been
+ *   written to it (Linux only). This leaves less work for the final sync of the file. The default is 0
+ *   (disabled).
+ *
+ * - @b dataset_drop_cache - Remove data files from the page cache once their data has been synced. This
+ *   keeps a checkpoint from evicting application memory. The default is false.
+ *
+ * - @b dataset_prefetch_elements - Comma-separated list of elements whose data should be loaded into
+ *   memory in the background as soon as a dataset opened for reading is open. This is a hint. Elements
+ *   that do not exist are ignored.
+ *
  * - @b dataset_use_bzip - Use bzip2 compression when writing dataset manifests. This will reduce the size
  *   of large manifest files.
  *
@@ -305,6 +360,11 @@
  * - @b raid_level - Filesystem RAID level. This value will be passed along to the underlying file system
  *   if supported. Not valid for optimized file mode.
  *
+ * - @b dataset_dir_shard_size - Split the data directory of new datasets into subdirectories. Each
+ *   subdirectory holds the files of this many ranks (basic file mode with @ref HIO_SET_ELEMENT_UNIQUE and
+ *   packed file mode) or file indices (strided file mode). This avoids contention on a single directory with very large numbers
+ *   of files. The layout is recorded in the dataset manifest. The default is 0 (no subdirectories).
+ *
  * - @b dataset_expected_size - Expected global size of a dataset in bytes. This value will be used when
  *   calculating the appropriate output interval for the dataset.
  *
@@ -751,6 +811,29 @@ hio_return_t hio_dataset_alloc (hio_context_t context, hio_dataset_t *set_out, c
  */
 hio_return_t hio_dataset_open (hio_dataset_t dataset);
 
+/**
+ * @ingroup API
+ * @brief Start opening an hio dataset in the background
+ *
+ * @param[in]  dataset  hio dataset allocated with hio_dataset_alloc()
+ * @param[out] request  new hio request (may be NULL)
+ *
+ * @returns HIO_SUCCESS if the open was started
+ *
+ * This function starts opening a dataset and returns immediately. Reading and distributing
+ * the dataset manifests and setting up the shared structures proceed in a background thread
+ * so an application can overlap them with its own initialization. The request completes
+ * with the status of the open. The dataset must not be used until the request completes. If
+ * {request} is NULL the status of the open is not reported. Elements listed in the @b dataset_prefetch_elements variable are loaded in the background
+ * once a dataset opened for reading is open. Calls to hio_dataset_open(), hio_dataset_close(),
+ * hio_dataset_unlink(), hio_dataset_free(), and hio_fini() on the same context wait for the
+ * background open to finish.
+ *
+ * When the context uses MPI, opening in the background requires MPI_THREAD_MULTIPLE. Otherwise
+ * the dataset is opened before this function returns and the request is already complete.
+ */
+hio_return_t hio_dataset_open_nb (hio_dataset_t dataset, hio_request_t *request);
+
 /**
  * @ingroup API
  * @brief Close an hio dataset
@@ -766,6 +849,28 @@ hio_return_t hio_dataset_open (hio_dataset_t dataset);
  */
 hio_return_t hio_dataset_close (hio_dataset_t dataset);
 
+/**
+ * @ingroup API
+ * @brief Start closing an hio dataset in the background
+ *
+ * @param[in]     dataset  hio dataset handle
+ * @param[out]    request  new hio request (may be NULL)
+ *
+ * @returns hio_return_t
+ *
+ * This function starts closing an hio dataset and returns immediately. Flushing the data
+ * and writing the dataset manifest proceed in a background thread. The request completes
+ * when the dataset has been closed. The status of the close is reported by the request. The
+ * dataset is not visible to hio_dataset_open() until the close has completed. Calls to
+ * hio_dataset_open(), hio_dataset_close(), hio_dataset_unlink(), hio_dataset_free(), and
+ * hio_fini() on the same context wait for the background close to finish. The dataset must
+ * not be used until the request completes.
+ *
+ * When the context uses MPI, closing in the background requires MPI_THREAD_MULTIPLE. Otherwise
+ * the dataset is closed before this function returns and the request is already complete.
+ */
+hio_return_t hio_dataset_close_nb (hio_dataset_t dataset, hio_request_t *request);
+
 /**
  * @ingroup API
  * @brief Release an hio dataset object
@@ -1209,6 +1314,63 @@ int hio_request_test (hio_request_t *requests, int nrequests, ssize_t *bytes_tra
  */
 hio_return_t hio_request_wait (hio_request_t *requests, int nrequests, ssize_t *bytes_transferred);
 
+/**
+ * @ingroup API
+ * @brief Wait for completion of any I/O request in an array
+ *
+ * @param[in,out] requests           array of hio I/O requests
+ * @param[in]     nrequests          number of requests in requests array
+ * @param[out]    index              index of the completed request
+ * @param[out]    bytes_transferred  number of bytes read/written by the completed request (may be NULL)
+ *
+ * @returns hio_return_t
+ *
+ * This function blocks until at least one of the requests completes. The completed request
+ * is released, its entry in the {requests} array is set to HIO_OBJECT_NULL, and its index is
+ * stored in {index}. If all entries in {requests} are HIO_OBJECT_NULL this function returns
+ * immediately and sets {index} to -1. If the request completed in error {bytes_transferred}
+ * is set to the hio_return_t error value.
+ */
+hio_return_t hio_request_waitany (hio_request_t *requests, int nrequests, int *index, ssize_t *bytes_transferred);
+
+/**
+ * @ingroup API
+ * @brief Wait for completion of one or more I/O requests in an array
+ *
+ * @param[in,out] requests           array of hio I/O requests
+ * @param[in]     nrequests          number of requests in requests array
+ * @param[out]    ncompleted         number of requests completed by this call
+ * @param[out]    indices            indices of the completed requests (at least nrequests entries)
+ * @param[out]    bytes_transferred  bytes read/written by each completed request (may be NULL)
+ *
+ * @returns hio_return_t
+ *
+ * This function blocks until at least one of the requests completes and then returns all
+ * requests that are complete. Completed requests are released and their entries in the
+ * {requests} array are set to HIO_OBJECT_NULL. The result of the request at indices[i] is
+ * stored in bytes_transferred[i]. If all entries in {requests} are HIO_OBJECT_NULL this
+ * function returns immediately and sets {ncompleted} to 0.
+ */
+hio_return_t hio_request_waitsome (hio_request_t *requests, int nrequests, int *ncompleted, int *indices,
+                                   ssize_t *bytes_transferred);
+
+/**
+ * @ingroup API
+ * @brief Get a file descriptor that signals request completion
+ *
+ * @param[in]  context  hio context
+ * @param[out] fd       file descriptor
+ *
+ * @returns hio_return_t
+ *
+ * This function returns a non-blocking file descriptor that becomes readable when a request
+ * on {context} completes. It can be added to the poll/select/epoll set of an application
+ * event loop. The application should read (and discard) the available data before testing
+ * the outstanding requests with hio_request_test(). The descriptor is owned by hio and is
+ * closed by hio_fini().
+ */
+hio_return_t hio_request_get_fd (hio_context_t context, int *fd);
+
 /**
  * @ingroup API
  * @brief Get recommendation on if a checkpoint should be written
@@ -1219,10 +1381,14 @@ hio_return_t hio_request_wait (hio_request_t *requests, int nrequests, ssize_t *
  * @returns hio_recommendation_t
  *
  * This function attempts to determine if now is an optimal time to write an
- * instance of a dataset. This function will take into account the currently
- * active data root, prior dataset instance sizes, and the system status.
- * It may query the runtime, system configuration, or more to calculate the
- * recommendation. See @ref hio_recommendation_t for valid return codes.
+ * instance of a dataset. The optimal interval between checkpoints is computed
+ * using Daly's model from the measured time needed to write an instance of the
+ * dataset and the mean time between failures (see the @b checkpoint_mtbf and
+ * @b node_mtbf context variables). A checkpoint is recommended if no instance of
+ * the dataset has been written using this context or if the time since the last
+ * instance was closed exceeds the optimal interval. This function is collective
+ * across the ranks of the context and returns the same recommendation on every
+ * rank. See @ref hio_recommendation_t for valid return codes.
  */
 hio_recommendation_t hio_dataset_should_checkpoint (hio_context_t context, const char *name);
 
@@ -281,8 +281,43 @@ int hioi_dataset_scatter_comm (hio_dataset_t dataset, MPI_Comm comm, const unsig
  * @param[in] rc            current return code for consensus
  */
 int hioi_dataset_scatter_unique (hio_dataset_t dataset, const unsigned char *manifest, size_t manifest_size, int rc);
+
+/**
+ * @brief gather element segment data from all processes in a communicator
+ *
+ * @param[in] dataset       dataset to merge
+ * @param[in] comm          MPI communicator
+ * @param[in] root          rank to gather to (negative: all ranks)
+ *
+ * Each process contributes the elements it currently holds. On return the root
+ * (or every process if root is negative) holds the union of the elements with
+ * segment arrays sorted by application offset and compacted. This call is
+ * collective over the communicator.
+ */
+int hioi_dataset_gather_elements (hio_dataset_t dataset, MPI_Comm comm, int root);
 #endif
 
+/**
+ * @brief look up an element in a dataset by identifier and rank
+ *
+ * @param[in] dataset       dataset handle
+ * @param[in] identifier    element identifier
+ * @param[in] rank          element rank (-1 for shared)
+ *
+ * @returns the element or NULL if no element matches
+ */
+hio_element_t hioi_dataset_lookup_element (hio_dataset_t dataset, const char *identifier, int rank);
+
+/**
+ * @brief compact the segment arrays of all elements in a dataset
+ *
+ * @param[in] dataset     dataset to compact
+ *
+ * Sets the segments_before_compaction and segments_after_compaction
+ * performance variables.
+ */
+void hioi_dataset_compact_segments (hio_dataset_t dataset);
+
 /**
  * @brief gather dataset configuration from all processes
  *
@@ -337,9 +372,80 @@ hio_request_t hioi_request_alloc (hio_context_t context);
 
 void hioi_request_release (hio_request_t request);
 
+/**
+ * Mark a request as complete
+ *
+ * @param[in] request      request to complete
+ * @param[in] transferred  number of bytes transferred
+ * @param[in] status       hio status of the request
+ *
+ * Wakes up any thread waiting on requests of the context and signals the completion
+ * descriptor returned by hio_request_get_fd().
+ */
+void hioi_request_complete (hio_request_t request, size_t transferred, int status);
+
+/**
+ * Run a collective operation on a context in the background
+ *
+ * @param[in] context  hio context
+ * @param[in] fn       operation to run
+ * @param[in] arg      argument passed to fn
+ *
+ * @returns HIO_SUCCESS if the operation was started
+ * @returns HIO_ERR_NOT_AVAILABLE if the operation must be run synchronously
+ *
+ * Background operations use the communicators of the context from a separate thread.
+ * This requires MPI_THREAD_MULTIPLE when the context uses MPI. Only one background
+ * operation runs at a time and every hio call that communicates on the context waits for
+ * it with hioi_context_wait_pending() so collectives are issued in the same order on all
+ * ranks.
+ */
+int hioi_context_start_background (hio_context_t context, void *(*fn) (void *), void *arg);
+
+/**
+ * Mark the background operation on a context as finished
+ */
+void hioi_context_background_done (hio_context_t context);
+
+/**
+ * Wait for the background operation on a context (if any) to finish
+ */
+void hioi_context_wait_pending (hio_context_t context);
+
 int hioi_element_add_segment (hio_element_t element, int file_index, uint64_t file_offset,
                               uint64_t app_offset, size_t seg_length);
 
+/**
+ * Append segment descriptors to an element without sorting
+ *
+ * @param[in] element  hio element handle
+ * @param[in] segments segment descriptors to append
+ * @param[in] count    number of segment descriptors
+ *
+ * The caller is responsible for calling hioi_element_sort_segments() after
+ * all segments have been appended.
+ */
+int hioi_element_append_segments (hio_element_t element, const hio_manifest_segment_t *segments, int count);
+
+/**
+ * Sort the segment array of an element by application offset
+ *
+ * @param[in] element hio element handle
+ */
+void hioi_element_sort_segments (hio_element_t element);
+
+/**
+ * Compact the segment array of an element
+ *
+ * @param[in] element hio element handle
+ *
+ * @returns the number of segments removed
+ *
+ * Fuses segments that are contiguous in both application and file space and
+ * drops zero-length and shadowed segments. The segment array must be sorted.
+ */
+size_t hioi_element_compact_segments (hio_element_t element);
+
 int hioi_element_find_offset (hio_element_t element, uint64_t app_offset, int rank,
                               off_t *offset, size_t *length);
 
@@ -376,7 +482,8 @@ int hioi_manifest_save (hio_dataset_t dataset, const unsigned char *manifest_dat
 int hioi_manifest_deserialize (hio_dataset_t dataset, const unsigned char *data, size_t data_size);
 int hioi_manifest_load (hio_dataset_t dataset, const char *path);
 int hioi_manifest_merge_data (hio_dataset_t dataset, const unsigned char *data, size_t data_size);
-int hioi_manifest_merge_data2 (unsigned char **data1, size_t *data1_size, const unsigned char *data2, size_t data2_size);
+int hioi_manifest_merge_data2 (hio_dataset_t dataset, unsigned char **data1, size_t *data1_size, const unsigned char *data2,
+                               size_t data2_size);
 /**
  * Determine what which ranks have data in the manifest
  *
@@ -446,6 +553,25 @@ int hioi_fs_query (hio_context_t context, const char *path, hio_fs_attr_t *attri
 int hioi_fs_set_stripe (const char *path, hio_fs_attr_t *fs_attr);
 
 int hioi_dataset_open_internal (hio_module_t *module, hio_dataset_t dataset);
+
+/**
+ * Start loading the elements listed in the dataset_prefetch_elements variable
+ *
+ * @param[in] dataset  dataset opened for reading
+ */
+void hioi_dataset_prefetch (hio_dataset_t dataset);
+
+/**
+ * Look up (or allocate) the persistent data of a dataset
+ *
+ * @param[in]  context  hio context
+ * @param[in]  name     dataset name
+ * @param[out] data     persistent dataset data
+ *
+ * The persistent data lives until the context is finalized and tracks statistics
+ * (last completed id, average write time, etc) across instances of a dataset.
+ */
+int hioi_dataset_data_lookup (hio_context_t context, const char *name, hio_dataset_data_t **data);
 int hioi_dataset_close_internal (hio_dataset_t dataset);
 
 /**
@@ -458,10 +584,27 @@ int hioi_dataset_close_internal (hio_dataset_t dataset);
  * weak coordination with optimized mode. This function currently sets
  * up a shared memory window and local structure that are used to hold
  * available block offset(s) and mutex(es). In the future this may change
- * if corrdination over several nodes improves performance.
+ * if corrdination over several nodes improves performance. If MPI-3 is
+ * not available the control block is placed in POSIX shared memory when
+ * all processes are on a single node.
  */
 int hioi_dataset_shared_init (hio_dataset_t dataset, int stripes);
 
+/**
+ * Build the read-only node segment table
+ *
+ * @param[in] dataset dataset handle
+ *
+ * The node leader (which must hold the merged element list) copies the
+ * sorted segment arrays of all elements into a shared memory window. All
+ * ranks on the node then point their element segment arrays into the
+ * window instead of holding private copies. Segment arrays in the table
+ * are copied on first modification.
+ *
+ * @returns HIO_ERR_NOT_AVAILABLE if the table could not be created
+ */
+int hioi_dataset_shared_segments_init (hio_dataset_t dataset);
+
 /**
  * Finalize dataset synchronization structures.
  *
@@ -501,6 +644,19 @@ int hioi_element_close_internal (hio_element_t element);
 int hioi_element_translate_offset (hio_element_t element, uint64_t app_offset, int *file_index,
                                    uint64_t *offset, size_t *length);
 
+/**
+ * Limit a new segment so it does not overlap existing segments
+ *
+ * @param[in]    element    hio element handle
+ * @param[in]    app_offset application offset of the new segment
+ * @param[inout] length     length of the new segment
+ *
+ * Must be called when hioi_element_translate_offset() did not find app_offset. The length is
+ * reduced to end at the start of the next segment of the element if there is one. The covered
+ * range is then found by the next translation and overwritten in place.
+ */
+void hioi_element_clip_segment (hio_element_t element, uint64_t app_offset, size_t *length);
+
 static inline bool hioi_dataset_doing_io (hio_dataset_t dataset) {
   return true;
 }
@@ -576,6 +732,22 @@ int hioi_dataset_generate_map (hio_dataset_t dataset);
 int hioi_dataset_map_release (hio_dataset_t dataset);
 int hioi_dataset_map_translate_offset (hio_element_t element, uint64_t app_offset, int *file_index,
                                        uint64_t *offset, size_t *length);
+
+/**
+ * Translate an application offset using segments previously fetched from the map
+ *
+ * @param[in]    element    hio element handle
+ * @param[in]    app_offset application offset
+ * @param[out]   file_index index of the file holding the data
+ * @param[out]   offset     offset of the data in the file
+ * @param[inout] length     length of application segment
+ *
+ * Searches the bounded cache of remote segments kept on the element. Returns
+ * HIO_ERR_NOT_FOUND if the offset is not covered by a cached segment. Segments
+ * are added to the cache by hioi_dataset_map_translate_offset().
+ */
+int hioi_dataset_map_cache_lookup (hio_element_t element, uint64_t app_offset, int *file_index,
+                                   uint64_t *offset, size_t *length);
 #endif
 
 /* internal version of hio_config_get_info that doesn't strdup the name */
@@ -12,6 +12,9 @@
 #if !defined(HIO_TYPES_H)
 #define HIO_TYPES_H
 
+/* HIO_USE_MPI decides the layout of the types below */
+#include "hio_config.h"
+
 #if HIO_USE_MPI
 #include <mpi.h>
 #endif
@@ -189,6 +192,21 @@ typedef int (*hio_dataset_element_open_fn_t) (hio_dataset_t dataset, hio_element
 typedef int (*hio_dataset_process_requests_fn_t) (hio_dataset_t dataset, struct hio_internal_request_t **reqs,
                                                   int req_count);
 
+/**
+ * Flush a dataset
+ *
+ * @param[in] dataset      hio dataset object
+ * @param[in] mode         hio flush mode
+ *
+ * @returns HIO_SUCCESS on success
+ * @returns HIO_ERR_PERM if the dataset can not be written to
+ * @returns hio error on other error
+ *
+ * This optional function is called before the elements of the dataset are flushed. It
+ * allows a module to flush the data of all elements at once.
+ */
+typedef int (*hio_dataset_flush_fn_t) (hio_dataset_t dataset, hio_flush_mode_t mode);
+
 /**
  * Flush writes to a dataset element
  *
@@ -238,6 +256,18 @@ typedef int (*hio_element_complete_fn_t) (hio_element_t element);
  */
 typedef int (*hio_element_close_fn_t) (hio_element_t element);
 
+/**
+ * Start reading element data into memory ahead of use
+ *
+ * @param[in] element      element to prefetch
+ *
+ * @returns HIO_SUCCESS on success
+ *
+ * This optional function is a hint. It should start loading the data of the element
+ * without waiting for it.
+ */
+typedef int (*hio_element_prefetch_fn_t) (hio_element_t element);
+
 typedef void (*hio_object_release_fn_t) (hio_object_t object);
 
 struct hio_config_t;
@@ -312,6 +342,8 @@ typedef struct hio_var_t {
   const char       *var_description;
   /** variable enumerator (integer types only) */
   const hio_var_enum_t *var_enum;
+  /** value was set from a file, the environment, or hio_config_set_value() */
+  bool              var_set;
 } hio_var_t;
 
 typedef struct hio_var_array_t {
@@ -376,6 +408,16 @@ struct hio_context {
   char             *c_droots;
   /** print statistics on close */
   bool              c_print_stats;
+  /** number of threads used to remove the files of a dataset */
+  uint32_t          c_unlink_threads;
+  /** move unlinked datasets aside and remove their files in the background */
+  bool              c_unlink_background;
+  /** mean time between failures of the job in seconds (0: estimate from c_node_mtbf) */
+  uint64_t          c_checkpoint_mtbf;
+  /** mean time between failures of a single node in seconds */
+  uint64_t          c_node_mtbf;
+  /** last checkpoint interval computed by hio_dataset_should_checkpoint() in seconds */
+  uint64_t          c_checkpoint_interval;
   /** number of bytes written to this context (local) */
   uint64_t          c_bwritten;
   /** number of bytes read from this context (local) */
@@ -414,6 +456,19 @@ struct hio_context {
 
   hio_list_t         c_ds_data;
 
+  /** protects the request completion state of the context */
+  pthread_mutex_t    c_req_lock;
+  /** signalled when a request on this context completes */
+  pthread_cond_t     c_req_cond;
+  /** number of requests completed on this context */
+  uint64_t           c_req_completions;
+  /** read and write ends of the request completion descriptor (-1 until hio_request_get_fd()).
+   * both are the same descriptor if eventfd is available */
+  int                c_req_fd[2];
+  /** number of operations running in the background on this context (protected by
+   * c_req_lock) */
+  uint32_t           c_pending_ops;
+
   /** size of a dataset object */
   size_t             c_ds_size;
 
@@ -437,6 +492,9 @@ struct hio_dataset_data_t {
   /** weighted average write time for a member of this dataset */
   uint64_t    dd_average_write_time;
 
+  /** weighted average time from open to close of an instance written by this rank (usec) */
+  uint64_t    dd_average_checkpoint_time;
+
   /** average dataset size */
   uint64_t    dd_average_size;
 
@@ -525,13 +583,27 @@ typedef struct hio_dataset_map_data_t {
   size_t  md_element_size;
   /** MPI window backing the map */
   MPI_Win md_win;
+  /** local memory backing the window (node leaders only) */
+  void   *md_base;
 } hio_dataset_map_data_t;
 
+struct hio_map_fence_t;
+
 typedef struct hio_dataset_map_t {
   /** element window */
   hio_dataset_map_data_t map_elements;
-  /** segment window */
-  hio_dataset_map_data_t map_segments;
+  /** build the element map with collective exchanges instead of per-item RMA */
+  bool                   map_bulk_build;
+  /** range-partitioned segment index window */
+  MPI_Win                map_index_win;
+  /** local memory backing the segment index window (node leaders only) */
+  void                  *map_index_base;
+  /** replicated first keys of each block in the segment index */
+  struct hio_map_fence_t *map_fences;
+  /** number of block fences */
+  size_t                 map_fence_count;
+  /** maximum number of remote segments cached per element */
+  uint64_t               map_cache_size;
 } hio_dataset_map_t;
 #endif /* HIO_MPI_HAVE(3) */
 
@@ -542,12 +614,31 @@ typedef struct hio_shared_control_t {
   /** master rank in context */
   int32_t      s_master;
 
+  /** protects s_creating */
+  pthread_mutex_t s_create_mutex;
+  /** signaled when a rank on this node finishes creating a basic mode element file */
+  pthread_cond_t  s_create_cond;
+  /** number of ranks on this node currently creating basic mode element files */
+  unsigned int s_creating;
+
+  /** syncfs coordination. a rank holding s_sync_lock issues the next syncfs on behalf of
+   * all ranks on the node */
+  atomic_int   s_sync_lock;
+  /** number of syncfs calls started on this node */
+  atomic_ulong s_sync_started;
+  /** generation of the last syncfs that completed successfully */
+  atomic_ulong s_sync_completed;
+
   /** stripe coordination structure */
   struct {
     /** coordination lock for this stripe */
     pthread_mutex_t s_mutex;
     /** current stripe index */
     atomic_ulong s_index;
+    /** next free offset in the block small reservations are packed into (protected by s_mutex) */
+    uint64_t     s_sub_offset;
+    /** space left in the block small reservations are packed into (protected by s_mutex) */
+    uint64_t     s_sub_remaining;
   } s_stripes[];
 } hio_shared_control_t;
 
@@ -591,6 +682,16 @@ struct hio_dataset {
     atomic_ulong        s_wcount;
     /** total number of read operations */
     atomic_ulong        s_rcount;
+
+    /** number of segments before compaction */
+    uint64_t            s_scount_before;
+    /** number of segments remaining after compaction */
+    uint64_t            s_scount_after;
+
+    /** number of offset translations satisfied by element map caches */
+    uint64_t            s_mcache_hits;
+    /** number of offset translations that searched the distributed map */
+    uint64_t            s_map_lookups;
   } ds_stat;
 
   /** data associated with this dataset */
@@ -607,12 +708,28 @@ struct hio_dataset {
 
   hio_buffer_t        ds_buffer;
 
+  /** number of ranks covered by each top-level manifest shard (0: single manifest) */
+  int32_t             ds_mshard_size;
+
+  /** comma-separated list of data roots holding the data files of this dataset (NULL: only
+   * the data root the dataset was opened from) */
+  char               *ds_data_roots;
+
+  /** number of ranks (basic mode) or files (strided mode) sharing each subdirectory of the
+   * data directory (0: all data files are in the data directory) */
+  uint32_t            ds_dir_shard_size;
+
 #if HIO_MPI_HAVE(3)
   MPI_Win             ds_shared_win;
+  /** shared memory window holding the node segment table (read-only datasets) */
+  MPI_Win             ds_segment_win;
   hio_dataset_map_t   ds_map;
 #endif
 
   hio_shared_control_t *ds_shared_control;
+  /** size of the POSIX shared memory mapping holding ds_shared_control (0 if
+   * the control block lives in an MPI window) */
+  size_t              ds_shared_size;
 
   /** close the dataset and free any internal resources */
   hio_dataset_close_fn_t ds_close;
@@ -622,6 +739,15 @@ struct hio_dataset {
 
   /** process multiple requests */
   hio_dataset_process_requests_fn_t ds_process_reqs;
+
+  /** flush all elements of the dataset (optional) */
+  hio_dataset_flush_fn_t ds_flush;
+
+  /** comma-separated list of elements to prefetch when the dataset is opened for reading */
+  char               *ds_prefetch;
+
+  /** elements are located by name when opened instead of being listed in the manifest */
+  bool                ds_elements_by_name;
 };
 
 typedef struct hio_file_t {
@@ -635,12 +761,20 @@ typedef struct hio_file_t {
   uint64_t  f_offset;
   /** element associated with the file (if any) */
   hio_element_t f_element;
+  /** start of the range written since write-back was last started */
+  uint64_t  f_wb_start;
+  /** end of the range written since write-back was last started */
+  uint64_t  f_wb_end;
+  /** file has been written since it was last synced */
+  bool      f_dirty;
 } hio_file_t;
 
 struct hio_request {
   struct hio_object req_object;
+  /** context the request belongs to */
+  hio_context_t     req_context;
   /** completion indicator */
-  bool              req_complete;
+  atomic_bool       req_complete;
   /** number of bytes transferred */
   size_t            req_transferred;
   /** status of the request */
@@ -680,6 +814,15 @@ typedef struct hio_manifest_segment_t {
   int        seg_file_index;
 } hio_manifest_segment_t;
 
+#if HIO_MPI_HAVE(3)
+typedef struct hio_map_cache_entry_t {
+  /** segment fetched from the distributed map */
+  hio_manifest_segment_t mc_segment;
+  /** last use of this entry */
+  uint64_t   mc_stamp;
+} hio_map_cache_entry_t;
+#endif
+
 struct hio_element {
   struct hio_object e_object;
 
@@ -693,11 +836,22 @@ struct hio_element {
   size_t            e_scount;
   size_t            e_ssize;
   hio_manifest_segment_t *e_sarray;
+  /** segment list points into the read-only node segment table */
+  bool              e_sarray_shared;
 
   /** global element identifier (shared dataset only) used
    * to uniquely identify this element in the global map */
   uint32_t          e_index;
 
+#if HIO_MPI_HAVE(3)
+  /** recently used segments fetched from the distributed map */
+  hio_map_cache_entry_t *e_mcache;
+  /** number of valid entries in e_mcache */
+  size_t            e_mcount;
+  /** use counter for least-recently-used replacement */
+  uint64_t          e_mclock;
+#endif
+
   /** element is currently open */
   int32_t           e_open_count;
 
@@ -714,6 +868,9 @@ struct hio_element {
 
   /** function to close the element */
   hio_element_close_fn_t e_close;
+
+  /** function to prefetch element data (optional) */
+  hio_element_prefetch_fn_t e_prefetch;
 };
 
 struct hio_dataset_header_t {
@@ -48,6 +48,17 @@ int hioi_config_add (hio_context_t context, hio_object_t object, void *addr, con
 
 int hioi_config_parse (hio_context_t context, const char *config_file, const char *prefix);
 
+/**
+ * Check if a configuration variable was set explicitly
+ *
+ * @param[in] object  object the variable is registered on
+ * @param[in] name    variable name
+ *
+ * @returns true if the value of the variable came from a configuration file, the
+ *          environment, or hio_config_set_value() rather than from its default
+ */
+bool hioi_config_is_set (hio_object_t object, const char *name);
+
 int hioi_perf_add (hio_context_t context, hio_object_t object, void *addr, const char *name,
                    hio_config_type_t type, void *reserved0, const char *description, int flags);
 
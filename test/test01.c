@@ -10,9 +10,497 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include <hio.h>
 
+/* complete requests through waitany/waitsome and check that the completion descriptor is signalled */
+static int test_requests (hio_context_t context) {
+  hio_request_t requests[4] = {HIO_OBJECT_NULL, HIO_OBJECT_NULL, HIO_OBJECT_NULL, HIO_OBJECT_NULL};
+  int data[10] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+  int fails = 0, fd, index, ncompleted, indices[4];
+  ssize_t bytes_transferred[4];
+  struct pollfd pfd;
+  hio_dataset_t dataset;
+  hio_element_t element;
+  char drain[64];
+  int rc;
+
+  rc = hio_request_get_fd (context, &fd);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not get request completion descriptor. reason: %d\n", rc);
+    return 1;
+  }
+
+  /* discard completions signalled by earlier requests */
+  while (0 < read (fd, drain, sizeof (drain)));
+
+  /* requests arrays without active requests return immediately */
+  rc = hio_request_waitany (requests, 4, &index, bytes_transferred);
+  if (HIO_SUCCESS != rc || -1 != index) {
+    fprintf (stderr, "Unexpected waitany result on empty request array. rc: %d, index: %d\n", rc, index);
+    ++fails;
+  }
+
+  rc = hio_request_waitsome (requests, 4, &ncompleted, indices, bytes_transferred);
+  if (HIO_SUCCESS != rc || 0 != ncompleted) {
+    fprintf (stderr, "Unexpected waitsome result on empty request array. rc: %d, count: %d\n", rc, ncompleted);
+    ++fails;
+  }
+
+  rc = hio_dataset_alloc (context, &dataset, "requests", 1, HIO_FLAG_WRITE | HIO_FLAG_CREAT | HIO_FLAG_TRUNC,
+                          HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate requests dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create requests dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_WRITE | HIO_FLAG_CREAT);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create requests element. reason: %d\n", rc);
+    (void) hio_dataset_close (dataset);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  /* mix active requests with null entries */
+  rc = hio_element_write_nb (element, requests + 1, 0, 0, data, 10, sizeof (int));
+  if (HIO_SUCCESS == rc) {
+    rc = hio_element_write_nb (element, requests + 3, 40, 0, data, 10, sizeof (int));
+  }
+
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not start non-blocking write. reason: %d\n", rc);
+    ++fails;
+  } else {
+    /* both writes have been issued. at least one completion must be visible on the descriptor */
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    if (1 != poll (&pfd, 1, 10000) || !(pfd.revents & POLLIN)) {
+      fprintf (stderr, "Request completion descriptor did not become readable\n");
+      ++fails;
+    }
+
+    while (0 < read (fd, drain, sizeof (drain)));
+
+    rc = hio_request_waitany (requests, 4, &index, bytes_transferred);
+    if (HIO_SUCCESS != rc || (1 != index && 3 != index) || sizeof (data) != bytes_transferred[0] ||
+        HIO_OBJECT_NULL != requests[index]) {
+      fprintf (stderr, "Unexpected waitany result. rc: %d, index: %d\n", rc, index);
+      ++fails;
+    }
+
+    rc = hio_request_waitsome (requests, 4, &ncompleted, indices, bytes_transferred);
+    if (HIO_SUCCESS != rc || 1 != ncompleted || index == indices[0] || sizeof (data) != bytes_transferred[0]) {
+      fprintf (stderr, "Unexpected waitsome result. rc: %d, count: %d\n", rc, ncompleted);
+      ++fails;
+    }
+
+    for (int i = 0 ; i < 4 ; ++i) {
+      if (HIO_OBJECT_NULL != requests[i]) {
+        fprintf (stderr, "Request %d was not released\n", i);
+        ++fails;
+      }
+    }
+  }
+
+  (void) hio_element_close (&element);
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  return fails;
+}
+
+/* overwrite ranges of an element both inside and around earlier writes and read them back */
+static int test_overwrite (hio_context_t context, const char *file_mode) {
+  int data[100], data2[10], data_read[100], expected;
+  hio_dataset_t dataset;
+  hio_element_t element;
+  int rc, fails = 0;
+  ssize_t bytes;
+
+  for (int i = 0 ; i < 100 ; ++i) {
+    data[i] = i;
+  }
+
+  for (int i = 0 ; i < 10 ; ++i) {
+    data2[i] = 1000 + i;
+  }
+
+  rc = hio_dataset_alloc (context, &dataset, "overwrite", 1, HIO_FLAG_WRITE | HIO_FLAG_CREAT | HIO_FLAG_TRUNC,
+                          HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate overwrite dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  (void) hio_config_set_value ((hio_object_t) dataset, "dataset_file_mode", file_mode);
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create overwrite dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_WRITE | HIO_FLAG_CREAT);
+  if (HIO_SUCCESS == rc) {
+    /* [10,20) is written before the covering write and [50,60) after it */
+    bytes = hio_element_write (element, 10 * sizeof (int), 0, data2, 10, sizeof (int));
+    fails += (10 * sizeof (int) != bytes);
+    bytes = hio_element_write (element, 0, 0, data, 100, sizeof (int));
+    fails += (100 * sizeof (int) != bytes);
+    bytes = hio_element_write (element, 50 * sizeof (int), 0, data2, 10, sizeof (int));
+    fails += (10 * sizeof (int) != bytes);
+    bytes = hio_element_write (element, 50 * sizeof (int), 0, data2, 10, sizeof (int));
+    fails += (10 * sizeof (int) != bytes);
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  rc = hio_dataset_alloc (context, &dataset, "overwrite", 1, HIO_FLAG_READ, HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate overwrite dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  /* the file mode is read from the manifest */
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not open overwrite dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_READ);
+  if (HIO_SUCCESS == rc) {
+    bytes = hio_element_read (element, 0, 0, data_read, 100, sizeof (int));
+    fails += (100 * sizeof (int) != bytes);
+
+    for (int i = 0 ; i < 100 ; ++i) {
+      expected = (i >= 50 && i < 60) ? data2[i - 50] : data[i];
+      if (data_read[i] != expected) {
+        fprintf (stderr, "Mismatch in %s mode at index %d. expected: %d, actual: %d\n", file_mode, i,
+                 expected, data_read[i]);
+        ++fails;
+        break;
+      }
+    }
+
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  return fails ? 1 : 0;
+}
+
+/* the restart dataset was just written so with the default node mtbf there is no need to
+ * checkpoint again. with no mtbf left a checkpoint is always due */
+static int test_should_checkpoint (hio_context_t context) {
+  uint64_t interval = 0;
+  int fails = 0;
+
+  if (HIO_SCP_MUST_CHECKPOINT != hio_dataset_should_checkpoint (context, "never_written")) {
+    fprintf (stderr, "Checkpoint not recommended for a dataset without history\n");
+    ++fails;
+  }
+
+  if (HIO_SCP_NOT_NOW != hio_dataset_should_checkpoint (context, "restart")) {
+    fprintf (stderr, "Checkpoint recommended right after the last one\n");
+    ++fails;
+  }
+
+  (void) hio_perf_get_value ((hio_object_t) context, "checkpoint_interval", &interval, sizeof (interval));
+  if (0 == interval) {
+    fprintf (stderr, "Optimal checkpoint interval was not computed\n");
+    ++fails;
+  }
+
+  (void) hio_config_set_value ((hio_object_t) context, "node_mtbf", "0");
+  if (HIO_SCP_MUST_CHECKPOINT != hio_dataset_should_checkpoint (context, "restart")) {
+    fprintf (stderr, "Checkpoint not recommended with a zero mtbf\n");
+    ++fails;
+  }
+
+  return fails ? 1 : 0;
+}
+
+/* close a dataset in the background, wait for the request, and read the data back */
+static int test_close_nb (hio_context_t context) {
+  int data[10] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29}, data_read[10];
+  hio_request_t request = HIO_OBJECT_NULL;
+  ssize_t bytes_transferred = 0;
+  hio_dataset_t dataset;
+  hio_element_t element;
+  int fails = 0;
+  int rc;
+
+  rc = hio_dataset_alloc (context, &dataset, "close_nb", 1, HIO_FLAG_WRITE | HIO_FLAG_CREAT | HIO_FLAG_TRUNC,
+                          HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate close_nb dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create close_nb dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_WRITE | HIO_FLAG_CREAT);
+  if (HIO_SUCCESS == rc) {
+    if (sizeof (data) != hio_element_write (element, 0, 0, data, 10, sizeof (int))) {
+      ++fails;
+    }
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  rc = hio_dataset_close_nb (dataset, &request);
+  if (HIO_OBJECT_NULL != request) {
+    (void) hio_request_wait (&request, 1, &bytes_transferred);
+  }
+
+  if (HIO_SUCCESS != rc || 0 != bytes_transferred) {
+    fprintf (stderr, "Background close failed. rc: %d, status: %ld\n", rc, (long) bytes_transferred);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  hio_dataset_free (&dataset);
+
+  rc = hio_dataset_alloc (context, &dataset, "close_nb", 1, HIO_FLAG_READ, HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate close_nb dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not open close_nb dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_READ);
+  if (HIO_SUCCESS == rc) {
+    if (sizeof (data_read) != hio_element_read (element, 0, 0, data_read, 10, sizeof (int))) {
+      ++fails;
+    } else {
+      for (int i = 0 ; i < 10 ; ++i) {
+        if (data[i] != data_read[i]) {
+          fprintf (stderr, "Mismatch after background close at index %d. expected: %d, actual: %d\n", i,
+                   data[i], data_read[i]);
+          ++fails;
+          break;
+        }
+      }
+    }
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  return fails;
+}
+
+/* open a dataset in the background prefetching both an existing and an unknown element */
+static int test_open_nb (hio_context_t context, const char *file_mode) {
+  int data[10] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29}, data_read[10];
+  hio_request_t request = HIO_OBJECT_NULL;
+  ssize_t bytes_transferred = 0;
+  hio_dataset_t dataset;
+  hio_element_t element;
+  int64_t element_size;
+  int fails = 0;
+  int rc;
+
+  rc = hio_dataset_alloc (context, &dataset, "open_nb", 1, HIO_FLAG_WRITE | HIO_FLAG_CREAT | HIO_FLAG_TRUNC,
+                          HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate open_nb dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  (void) hio_config_set_value ((hio_object_t) dataset, "dataset_file_mode", file_mode);
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create open_nb dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_WRITE | HIO_FLAG_CREAT);
+  if (HIO_SUCCESS == rc) {
+    if (sizeof (data) != hio_element_write (element, 0, 0, data, 10, sizeof (int))) {
+      ++fails;
+    }
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  rc = hio_dataset_alloc (context, &dataset, "open_nb", 1, HIO_FLAG_READ, HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate open_nb dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  (void) hio_config_set_value ((hio_object_t) dataset, "dataset_prefetch_elements", "missing,data");
+
+  rc = hio_dataset_open_nb (dataset, &request);
+  if (HIO_OBJECT_NULL != request) {
+    (void) hio_request_wait (&request, 1, &bytes_transferred);
+  }
+
+  if (HIO_SUCCESS != rc || 0 != bytes_transferred) {
+    fprintf (stderr, "Background open failed in %s mode. rc: %d, status: %ld\n", file_mode, rc,
+             (long) bytes_transferred);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, "data", HIO_FLAG_READ);
+  if (HIO_SUCCESS == rc) {
+    rc = hio_element_size (element, &element_size);
+    if (HIO_SUCCESS != rc || sizeof (data) != element_size) {
+      fprintf (stderr, "Unexpected element size in %s mode. rc: %d, size: %ld\n", file_mode, rc, (long) element_size);
+      ++fails;
+    }
+
+    if (sizeof (data_read) != hio_element_read (element, 0, 0, data_read, 10, sizeof (int))) {
+      ++fails;
+    } else {
+      for (int i = 0 ; i < 10 ; ++i) {
+        if (data[i] != data_read[i]) {
+          fprintf (stderr, "Mismatch after background open in %s mode at index %d. expected: %d, actual: %d\n",
+                   file_mode, i, data[i], data_read[i]);
+          ++fails;
+          break;
+        }
+      }
+    }
+    (void) hio_element_close (&element);
+  } else {
+    fprintf (stderr, "Could not open prefetched element in %s mode. reason: %d\n", file_mode, rc);
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  return fails;
+}
+
+/* element names are utf-8 strings. they must survive the round trip through the manifest */
+static int test_element_name (hio_context_t context) {
+  const char *name = "d\xc3\xa9j\xc3\xa0-\xf0\x9f\x93\x88";
+  int data[10] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29}, data_read[10];
+  hio_dataset_t dataset;
+  hio_element_t element;
+  int64_t element_size = 0;
+  int fails = 0;
+  int rc;
+
+  rc = hio_dataset_alloc (context, &dataset, "element_name", 1, HIO_FLAG_WRITE | HIO_FLAG_CREAT | HIO_FLAG_TRUNC,
+                          HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate element_name dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  /* basic mode does not list elements in the manifest */
+  (void) hio_config_set_value ((hio_object_t) dataset, "dataset_file_mode", "file_per_node");
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not create element_name dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, name, HIO_FLAG_WRITE | HIO_FLAG_CREAT);
+  if (HIO_SUCCESS == rc) {
+    if (sizeof (data) != hio_element_write (element, 0, 0, data, 10, sizeof (int))) {
+      ++fails;
+    }
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  rc = hio_dataset_alloc (context, &dataset, "element_name", 1, HIO_FLAG_READ, HIO_SET_ELEMENT_UNIQUE);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not allocate element_name dataset handle. reason: %d\n", rc);
+    return 1;
+  }
+
+  rc = hio_dataset_open (dataset);
+  if (HIO_SUCCESS != rc) {
+    fprintf (stderr, "Could not open element_name dataset. reason: %d\n", rc);
+    hio_dataset_free (&dataset);
+    return 1;
+  }
+
+  rc = hio_element_open (dataset, &element, name, HIO_FLAG_READ);
+  if (HIO_SUCCESS == rc) {
+    (void) hio_element_size (element, &element_size);
+    if (sizeof (data) != element_size ||
+        sizeof (data_read) != hio_element_read (element, 0, 0, data_read, 10, sizeof (int))) {
+      fprintf (stderr, "Element with a utf-8 name was not found in the manifest. size: %ld\n",
+               (long) element_size);
+      ++fails;
+    } else {
+      for (int i = 0 ; i < 10 ; ++i) {
+        if (data[i] != data_read[i]) {
+          fprintf (stderr, "Mismatch in element with a utf-8 name at index %d. expected: %d, actual: %d\n", i,
+                   data[i], data_read[i]);
+          ++fails;
+          break;
+        }
+      }
+    }
+    (void) hio_element_close (&element);
+  } else {
+    ++fails;
+  }
+
+  (void) hio_dataset_close (dataset);
+  hio_dataset_free (&dataset);
+
+  return fails;
+}
 
 int main (int argc, char *argv[]) {
   int data[10] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
@@ -175,6 +663,42 @@ int main (int argc, char *argv[]) {
 
   hio_dataset_free (&dataset);
 
+  /* without MPI optimized mode falls back on a private control block */
+  if (test_overwrite (context, "file_per_node") || test_overwrite (context, "packed")) {
+    fprintf (stderr, "Overwritten data did not read back correctly\n");
+    hio_fini (&context);
+    return 1;
+  }
+
+  if (test_should_checkpoint (context)) {
+    hio_fini (&context);
+    return 1;
+  }
+
+  if (test_requests (context)) {
+    fprintf (stderr, "Request completion did not behave as expected\n");
+    hio_fini (&context);
+    return 1;
+  }
+
+  if (test_close_nb (context)) {
+    fprintf (stderr, "Dataset closed in the background did not read back correctly\n");
+    hio_fini (&context);
+    return 1;
+  }
+
+  if (test_open_nb (context, "basic") || test_open_nb (context, "packed")) {
+    fprintf (stderr, "Dataset opened in the background did not read back correctly\n");
+    hio_fini (&context);
+    return 1;
+  }
+
+  if (test_element_name (context)) {
+    fprintf (stderr, "Element name did not survive the manifest\n");
+    hio_fini (&context);
+    return 1;
+  }
+
   (void) hio_fini (&context);
 
   return 0;
@@ -131,6 +131,8 @@ char * help =
   #endif
   #ifdef MPI
   "  mi <shift>    issue MPI_Init(), shift ranks by <shift> from original assignment\n"
+  "  mit <shift>   issue MPI_Init_thread() requesting MPI_THREAD_MULTIPLE, shift ranks\n"
+  "                by <shift> from original assignment\n"
   "  msr <size> <stride>\n"
   "                issue MPI_Sendreceive with specified buffer <size> to and\n"
   "                from ranks <stride> above and below this rank\n"
@@ -190,6 +192,7 @@ char * help =
   "                addressing. Start is relative to end of previous segment\n"
   "  hec <name>    Element close\n"
   "  hdc           Dataset close\n"
+  "  hdcnb         Dataset close in the background and wait for the request\n"
   "  hdf           Dataset free\n"
   "  hdu <name> <id> CURRENT|FIRST|ALL  Dataset unlink\n"
   "  hf            Fini\n"
@@ -1211,9 +1214,7 @@ ACTION_RUN(dca_run) {
 static void *mpi_sbuf = NULL, *mpi_rbuf = NULL;
 static size_t mpi_buf_len = 0;
 
-ACTION_RUN(mi_run) {
-  MPI_CK(MPI_Init(NULL, NULL));
-  int shift = V0.u;
+static void mpi_shift(int shift) {
   mpi_comm = MPI_COMM_WORLD;
   get_id();
   if (shift > 0) {
@@ -1233,6 +1234,18 @@ ACTION_RUN(mi_run) {
   }
 }
 
+ACTION_RUN(mi_run) {
+  MPI_CK(MPI_Init(NULL, NULL));
+  mpi_shift(V0.u);
+}
+
+ACTION_RUN(mit_run) {
+  int provided;
+  MPI_CK(MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &provided));
+  mpi_shift(V0.u);
+  if (myrank == 0) VERB1("MPI_THREAD_MULTIPLE %s", MPI_THREAD_MULTIPLE == provided ? "provided" : "not provided");
+}
+
 ACTION_RUN(msr_run) {
   int len = V0.u;
   int stride = V1.u;
@@ -2241,6 +2254,21 @@ ACTION_RUN(hdc_run) {
   HRC_TEST(hio_dataset_close)
 }
 
+ACTION_RUN(hdcnb_run) {
+  hio_return_t hrc;
+  hio_request_t request = NULL;
+  ssize_t status = 0;
+  ETIMER_START(&local_tmr);
+  hrc = hio_dataset_close_nb(dataset, &request);
+  // the request is complete on return when the close could not be started in the background
+  if (NULL != request) {
+    hio_request_wait(&request, 1, &status);
+    if (HIO_SUCCESS == hrc && status < 0) hrc = (hio_return_t) status;
+  }
+  hio_hdc_time += ETIMER_ELAPSED(&local_tmr);
+  HRC_TEST(hio_dataset_close_nb)
+}
+
 ACTION_RUN(hdf_run) {
   hio_return_t hrc;
   DBG3("Calling hio_dataset_free(%p); dataset: %p", &dataset, dataset);
@@ -2611,6 +2639,7 @@ struct parse {
   #endif
   #ifdef MPI
   {"mi",    {UINT, NONE, NONE, NONE, NONE}, NULL,          mi_run      },
+  {"mit",   {UINT, NONE, NONE, NONE, NONE}, NULL,          mit_run     },
   {"msr",   {PINT, PINT, NONE, NONE, NONE}, NULL,          msr_run     },
   {"mb",    {NONE, NONE, NONE, NONE, NONE}, NULL,          mb_run      },
   {"mb",    {NONE, NONE, NONE, NONE, NONE}, NULL,          mb_run      },
@@ -2647,6 +2676,7 @@ struct parse {
   {"herr",  {SINT, UINT, UINT, UINT, NONE}, her_check,     herr_run    },
   {"hec",   {NONE, NONE, NONE, NONE, NONE}, NULL,          hec_run     },
   {"hdc",   {NONE, NONE, NONE, NONE, NONE}, NULL,          hdc_run     },
+  {"hdcnb", {NONE, NONE, NONE, NONE, NONE}, NULL,          hdcnb_run   },
   {"hdf",   {NONE, NONE, NONE, NONE, NONE}, NULL,          hdf_run     },
   {"hdu",   {STR,  UINT, HULM, NONE, NONE}, NULL,          hdu_run     },
   {"hf",    {NONE, NONE, NONE, NONE, NONE}, NULL,          hf_run      },